@@ -0,0 +1,60 @@
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM/apps/ndn-chacha20.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+namespace ns3 {
+
+// Throughput of every ChaCha20 kernel supported by this CPU for message sizes from 32B
+// (a typical Interest parameter) up to 64KB
+int
+main(int argc, char* argv[])
+{
+  double minSeconds = 0.2;
+
+  CommandLine cmd;
+  cmd.AddValue("minSeconds", "Minimum measurement time per kernel and size", minSeconds);
+  cmd.Parse(argc, argv);
+
+  const ndn::ChaCha20::Kernel kernels[] = {ndn::ChaCha20::KERNEL_PORTABLE, ndn::ChaCha20::KERNEL_SSE2,
+                                           ndn::ChaCha20::KERNEL_AVX2};
+
+  std::vector<uint8_t> key(ndn::ChaCha20::KEY_SIZE, 0x42);
+  std::vector<uint8_t> nonce(ndn::ChaCha20::NONCE_SIZE, 0x24);
+
+  std::cout << "Size\tKernel\tMB/s\n";
+  for (size_t size = 32; size <= 65536; size *= 2) {
+    std::vector<uint8_t> buffer(size, 0x5a);
+
+    for (ndn::ChaCha20::Kernel kernel : kernels) {
+      if (!ndn::ChaCha20::IsSupported(kernel))
+        continue;
+
+      uint64_t bytes = 0;
+      double elapsed = 0;
+      auto start = std::chrono::steady_clock::now();
+      while (elapsed < minSeconds) {
+        for (int i = 0; i < 64; i++) {
+          ndn::ChaCha20::Xor(key.data(), nonce.data(), 1, buffer.data(), buffer.data(), size, kernel);
+        }
+        bytes += 64 * size;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      }
+
+      std::cout << size << "\t" << ndn::ChaCha20::GetKernelName(kernel) << "\t"
+                << bytes / elapsed / 1e6 << "\n";
+    }
+  }
+
+  return 0;
+}
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+  return ns3::main(argc, argv);
+}
@@ -0,0 +1,359 @@
+#include "ndn-chacha20.hpp"
+
+#include <cstdlib>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define NDN_CHACHA20_X86 1
+#include <immintrin.h>
+#endif
+
+namespace ns3 {
+namespace ndn {
+
+namespace {
+
+inline uint32_t
+Load32(const uint8_t* p)
+{
+  return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8)
+         | (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline void
+Store32(uint8_t* p, uint32_t v)
+{
+  p[0] = static_cast<uint8_t>(v);
+  p[1] = static_cast<uint8_t>(v >> 8);
+  p[2] = static_cast<uint8_t>(v >> 16);
+  p[3] = static_cast<uint8_t>(v >> 24);
+}
+
+inline uint32_t
+Rotl32(uint32_t v, int n)
+{
+  return (v << n) | (v >> (32 - n));
+}
+
+#define CHACHA_QR(a, b, c, d)                                                                     \
+  a += b; d ^= a; d = Rotl32(d, 16);                                                              \
+  c += d; b ^= c; b = Rotl32(b, 12);                                                              \
+  a += b; d ^= a; d = Rotl32(d, 8);                                                               \
+  c += d; b ^= c; b = Rotl32(b, 7)
+
+void
+InitState(uint32_t state[16], const uint8_t* key, const uint8_t* nonce, uint32_t counter)
+{
+  state[0] = 0x61707865; // "expand 32-byte k"
+  state[1] = 0x3320646e;
+  state[2] = 0x79622d32;
+  state[3] = 0x6b206574;
+  for (int i = 0; i < 8; i++)
+    state[4 + i] = Load32(key + 4 * i);
+  state[12] = counter;
+  for (int i = 0; i < 3; i++)
+    state[13 + i] = Load32(nonce + 4 * i);
+}
+
+void
+Block(const uint32_t state[16], uint8_t keystream[ChaCha20::BLOCK_SIZE])
+{
+  uint32_t x[16];
+  std::memcpy(x, state, sizeof(x));
+
+  for (int i = 0; i < 10; i++) {
+    CHACHA_QR(x[0], x[4], x[8], x[12]);
+    CHACHA_QR(x[1], x[5], x[9], x[13]);
+    CHACHA_QR(x[2], x[6], x[10], x[14]);
+    CHACHA_QR(x[3], x[7], x[11], x[15]);
+    CHACHA_QR(x[0], x[5], x[10], x[15]);
+    CHACHA_QR(x[1], x[6], x[11], x[12]);
+    CHACHA_QR(x[2], x[7], x[8], x[13]);
+    CHACHA_QR(x[3], x[4], x[9], x[14]);
+  }
+
+  for (int i = 0; i < 16; i++)
+    Store32(keystream + 4 * i, x[i] + state[i]);
+}
+
+/**
+ * Handles whole and partial blocks one at a time, also used for the tail of the SIMD kernels
+ */
+void
+XorPortable(uint32_t state[16], const uint8_t* in, uint8_t* out, size_t size)
+{
+  uint8_t keystream[ChaCha20::BLOCK_SIZE];
+  while (size > 0) {
+    Block(state, keystream);
+    state[12]++;
+
+    size_t n = size < ChaCha20::BLOCK_SIZE ? size : ChaCha20::BLOCK_SIZE;
+    for (size_t i = 0; i < n; i++)
+      out[i] = in[i] ^ keystream[i];
+
+    in += n;
+    out += n;
+    size -= n;
+  }
+}
+
+#ifdef NDN_CHACHA20_X86
+
+#define CHACHA_ROTL128(v, n) _mm_or_si128(_mm_slli_epi32(v, n), _mm_srli_epi32(v, 32 - (n)))
+
+#define CHACHA_QR128(a, b, c, d)                                                                  \
+  a = _mm_add_epi32(a, b); d = _mm_xor_si128(d, a); d = CHACHA_ROTL128(d, 16);                    \
+  c = _mm_add_epi32(c, d); b = _mm_xor_si128(b, c); b = CHACHA_ROTL128(b, 12);                    \
+  a = _mm_add_epi32(a, b); d = _mm_xor_si128(d, a); d = CHACHA_ROTL128(d, 8);                     \
+  c = _mm_add_epi32(c, d); b = _mm_xor_si128(b, c); b = CHACHA_ROTL128(b, 7)
+
+/**
+ * Four blocks at a time: every vector holds the same state word of four consecutive blocks
+ */
+__attribute__((target("sse2"))) void
+XorSse2(uint32_t state[16], const uint8_t* in, uint8_t* out, size_t size)
+{
+  const size_t stride = 4 * ChaCha20::BLOCK_SIZE;
+
+  while (size >= stride) {
+    __m128i s[16];
+    for (int i = 0; i < 16; i++)
+      s[i] = _mm_set1_epi32(static_cast<int>(state[i]));
+    s[12] = _mm_add_epi32(s[12], _mm_setr_epi32(0, 1, 2, 3));
+
+    __m128i x[16];
+    for (int i = 0; i < 16; i++)
+      x[i] = s[i];
+
+    for (int i = 0; i < 10; i++) {
+      CHACHA_QR128(x[0], x[4], x[8], x[12]);
+      CHACHA_QR128(x[1], x[5], x[9], x[13]);
+      CHACHA_QR128(x[2], x[6], x[10], x[14]);
+      CHACHA_QR128(x[3], x[7], x[11], x[15]);
+      CHACHA_QR128(x[0], x[5], x[10], x[15]);
+      CHACHA_QR128(x[1], x[6], x[11], x[12]);
+      CHACHA_QR128(x[2], x[7], x[8], x[13]);
+      CHACHA_QR128(x[3], x[4], x[9], x[14]);
+    }
+
+    for (int i = 0; i < 16; i++)
+      x[i] = _mm_add_epi32(x[i], s[i]);
+
+    // transpose every group of four words back into block order
+    for (int g = 0; g < 4; g++) {
+      __m128i t0 = _mm_unpacklo_epi32(x[4 * g], x[4 * g + 1]);
+      __m128i t1 = _mm_unpacklo_epi32(x[4 * g + 2], x[4 * g + 3]);
+      __m128i t2 = _mm_unpackhi_epi32(x[4 * g], x[4 * g + 1]);
+      __m128i t3 = _mm_unpackhi_epi32(x[4 * g + 2], x[4 * g + 3]);
+
+      __m128i y[4] = {_mm_unpacklo_epi64(t0, t1), _mm_unpackhi_epi64(t0, t1),
+                      _mm_unpacklo_epi64(t2, t3), _mm_unpackhi_epi64(t2, t3)};
+
+      for (int b = 0; b < 4; b++) {
+        size_t offset = b * ChaCha20::BLOCK_SIZE + g * 16;
+        __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + offset));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + offset), _mm_xor_si128(data, y[b]));
+      }
+    }
+
+    state[12] += 4;
+    in += stride;
+    out += stride;
+    size -= stride;
+  }
+
+  XorPortable(state, in, out, size);
+}
+
+#define CHACHA_ROTL256(v, n) _mm256_or_si256(_mm256_slli_epi32(v, n), _mm256_srli_epi32(v, 32 - (n)))
+
+#define CHACHA_QR256(a, b, c, d)                                                                  \
+  a = _mm256_add_epi32(a, b); d = _mm256_xor_si256(d, a); d = CHACHA_ROTL256(d, 16);              \
+  c = _mm256_add_epi32(c, d); b = _mm256_xor_si256(b, c); b = CHACHA_ROTL256(b, 12);              \
+  a = _mm256_add_epi32(a, b); d = _mm256_xor_si256(d, a); d = CHACHA_ROTL256(d, 8);               \
+  c = _mm256_add_epi32(c, d); b = _mm256_xor_si256(b, c); b = CHACHA_ROTL256(b, 7)
+
+/**
+ * Eight blocks at a time. The 256-bit unpack instructions work per 128-bit lane, so the same
+ * transpose as in the SSE2 kernel yields blocks 0-3 in the low and blocks 4-7 in the high lane.
+ */
+__attribute__((target("avx2"))) void
+XorAvx2(uint32_t state[16], const uint8_t* in, uint8_t* out, size_t size)
+{
+  const size_t stride = 8 * ChaCha20::BLOCK_SIZE;
+
+  while (size >= stride) {
+    __m256i s[16];
+    for (int i = 0; i < 16; i++)
+      s[i] = _mm256_set1_epi32(static_cast<int>(state[i]));
+    s[12] = _mm256_add_epi32(s[12], _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+
+    __m256i x[16];
+    for (int i = 0; i < 16; i++)
+      x[i] = s[i];
+
+    for (int i = 0; i < 10; i++) {
+      CHACHA_QR256(x[0], x[4], x[8], x[12]);
+      CHACHA_QR256(x[1], x[5], x[9], x[13]);
+      CHACHA_QR256(x[2], x[6], x[10], x[14]);
+      CHACHA_QR256(x[3], x[7], x[11], x[15]);
+      CHACHA_QR256(x[0], x[5], x[10], x[15]);
+      CHACHA_QR256(x[1], x[6], x[11], x[12]);
+      CHACHA_QR256(x[2], x[7], x[8], x[13]);
+      CHACHA_QR256(x[3], x[4], x[9], x[14]);
+    }
+
+    for (int i = 0; i < 16; i++)
+      x[i] = _mm256_add_epi32(x[i], s[i]);
+
+    for (int g = 0; g < 4; g++) {
+      __m256i t0 = _mm256_unpacklo_epi32(x[4 * g], x[4 * g + 1]);
+      __m256i t1 = _mm256_unpacklo_epi32(x[4 * g + 2], x[4 * g + 3]);
+      __m256i t2 = _mm256_unpackhi_epi32(x[4 * g], x[4 * g + 1]);
+      __m256i t3 = _mm256_unpackhi_epi32(x[4 * g + 2], x[4 * g + 3]);
+
+      __m256i y[4] = {_mm256_unpacklo_epi64(t0, t1), _mm256_unpackhi_epi64(t0, t1),
+                      _mm256_unpacklo_epi64(t2, t3), _mm256_unpackhi_epi64(t2, t3)};
+
+      for (int b = 0; b < 4; b++) {
+        size_t lo = b * ChaCha20::BLOCK_SIZE + g * 16;
+        size_t hi = (b + 4) * ChaCha20::BLOCK_SIZE + g * 16;
+
+        __m128i dataLo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + lo));
+        __m128i dataHi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + hi));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + lo),
+                         _mm_xor_si128(dataLo, _mm256_castsi256_si128(y[b])));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + hi),
+                         _mm_xor_si128(dataHi, _mm256_extracti128_si256(y[b], 1)));
+      }
+    }
+
+    state[12] += 8;
+    in += stride;
+    out += stride;
+    size -= stride;
+  }
+
+  XorSse2(state, in, out, size);
+}
+
+#endif // NDN_CHACHA20_X86
+
+} // namespace
+
+bool
+ChaCha20::IsSupported(Kernel kernel)
+{
+  switch (kernel) {
+  case KERNEL_PORTABLE:
+    return true;
+#ifdef NDN_CHACHA20_X86
+  case KERNEL_SSE2:
+    return __builtin_cpu_supports("sse2");
+  case KERNEL_AVX2:
+    return __builtin_cpu_supports("avx2");
+#endif
+  default:
+    return false;
+  }
+}
+
+ChaCha20::Kernel
+ChaCha20::GetDefaultKernel()
+{
+  static const Kernel kernel = IsSupported(KERNEL_AVX2) ? KERNEL_AVX2
+                               : IsSupported(KERNEL_SSE2) ? KERNEL_SSE2 : KERNEL_PORTABLE;
+  return kernel;
+}
+
+const char*
+ChaCha20::GetKernelName(Kernel kernel)
+{
+  switch (kernel) {
+  case KERNEL_SSE2:
+    return "sse2";
+  case KERNEL_AVX2:
+    return "avx2";
+  default:
+    return "portable";
+  }
+}
+
+void
+ChaCha20::Xor(const uint8_t* key, const uint8_t* nonce, uint32_t counter, const uint8_t* in,
+              uint8_t* out, size_t size, Kernel kernel)
+{
+  uint32_t state[16];
+  InitState(state, key, nonce, counter);
+
+#ifdef NDN_CHACHA20_X86
+  if (kernel == KERNEL_AVX2 && IsSupported(KERNEL_AVX2)) {
+    XorAvx2(state, in, out, size);
+    return;
+  }
+  if (kernel != KERNEL_PORTABLE && IsSupported(KERNEL_SSE2)) {
+    XorSse2(state, in, out, size);
+    return;
+  }
+#endif
+
+  XorPortable(state, in, out, size);
+}
+
+std::vector<uint8_t>
+ChaCha20::KeyFromHex(const std::string& hex)
+{
+  std::vector<uint8_t> key;
+  if (hex.size() != 2 * KEY_SIZE)
+    return key;
+
+  for (size_t i = 0; i < hex.size(); i += 2) {
+    char byte[3] = {hex[i], hex[i + 1], 0};
+    char* end = nullptr;
+    unsigned long value = std::strtoul(byte, &end, 16);
+    if (end != byte + 2)
+      return std::vector<uint8_t>();
+    key.push_back(static_cast<uint8_t>(value));
+  }
+  return key;
+}
+
+std::string
+ChaCha20::KeyToHex(const std::vector<uint8_t>& key)
+{
+  static const char digits[] = "0123456789abcdef";
+  std::string hex;
+  hex.reserve(2 * key.size());
+  for (uint8_t byte : key) {
+    hex.push_back(digits[byte >> 4]);
+    hex.push_back(digits[byte & 0xf]);
+  }
+  return hex;
+}
+
+std::vector<uint8_t>
+ChaCha20::Seal(const std::vector<uint8_t>& key, const uint8_t* nonce, const std::string& plaintext)
+{
+  std::vector<uint8_t> sealed(NONCE_SIZE + plaintext.size());
+  std::memcpy(sealed.data(), nonce, NONCE_SIZE);
+  // block 0 is left unused, as in the AEAD construction of RFC 7539
+  Xor(key.data(), nonce, 1, reinterpret_cast<const uint8_t*>(plaintext.data()),
+      sealed.data() + NONCE_SIZE, plaintext.size());
+  return sealed;
+}
+
+bool
+ChaCha20::Open(const std::vector<uint8_t>& key, const uint8_t* sealed, size_t size,
+               std::string& plaintext)
+{
+  if (size < NONCE_SIZE)
+    return false;
+
+  plaintext.resize(size - NONCE_SIZE);
+  Xor(key.data(), sealed, 1, sealed + NONCE_SIZE, reinterpret_cast<uint8_t*>(&plaintext[0]),
+      plaintext.size());
+  return true;
+}
+
+} // namespace ndn
+} // namespace ns3
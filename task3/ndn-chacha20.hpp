@@ -0,0 +1,85 @@
+#ifndef NDN_CHACHA20_H
+#define NDN_CHACHA20_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief ChaCha20 stream cipher (RFC 7539) used to protect Interest parameters
+ *
+ * The keystream is generated by one of several kernels: a portable one that works everywhere,
+ * an SSE2 kernel producing 4 blocks and an AVX2 kernel producing 8 blocks per iteration. The
+ * best kernel supported by the running CPU is picked automatically, all of them produce the
+ * same output.
+ *
+ * Sealed parameters are laid out as nonce (12 bytes) followed by the ciphertext.
+ */
+class ChaCha20 {
+public:
+  static const size_t KEY_SIZE = 32;
+  static const size_t NONCE_SIZE = 12;
+  static const size_t BLOCK_SIZE = 64;
+
+  enum Kernel {
+    KERNEL_PORTABLE,
+    KERNEL_SSE2,
+    KERNEL_AVX2
+  };
+
+  static bool
+  IsSupported(Kernel kernel);
+
+  /**
+   * @brief Returns the fastest kernel supported by the CPU
+   */
+  static Kernel
+  GetDefaultKernel();
+
+  static const char*
+  GetKernelName(Kernel kernel);
+
+  /**
+   * @brief XORs @p size bytes of @p in with the keystream starting at block @p counter
+   *
+   * Encryption and decryption are the same operation. @p in and @p out may be the same buffer.
+   */
+  static void
+  Xor(const uint8_t* key, const uint8_t* nonce, uint32_t counter, const uint8_t* in, uint8_t* out,
+      size_t size, Kernel kernel = GetDefaultKernel());
+
+  /**
+   * @brief Parses a 64 character hex key
+   * @return empty vector if @p hex is not a valid key
+   */
+  static std::vector<uint8_t>
+  KeyFromHex(const std::string& hex);
+
+  /**
+   * @brief Inverse of KeyFromHex(), lower case
+   */
+  static std::string
+  KeyToHex(const std::vector<uint8_t>& key);
+
+  /**
+   * @brief Encrypts @p plaintext and prepends @p nonce
+   */
+  static std::vector<uint8_t>
+  Seal(const std::vector<uint8_t>& key, const uint8_t* nonce, const std::string& plaintext);
+
+  /**
+   * @brief Decrypts the output of Seal()
+   * @return false if @p size is too small to contain a nonce
+   */
+  static bool
+  Open(const std::vector<uint8_t>& key, const uint8_t* sealed, size_t size, std::string& plaintext);
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_CHACHA20_H
@@ -36,7 +36,11 @@ main(int argc, char* argv[])
   Config::SetDefault("ns3::QueueBase::MaxSize", StringValue("20p"));
 
   // Read optional command-line parameters (e.g., enable visualizer with ./waf --run=<> --visualize
+  std::string cipherKey = "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f";
+
   CommandLine cmd;
+  cmd.AddValue("cipherKey", "ChaCha20 key shared by the consumer and the producers, empty for clear text",
+               cipherKey);
   cmd.Parse(argc, argv);
 
   // Creating nodes
@@ -63,6 +67,8 @@ main(int argc, char* argv[])
   ndn::AppHelper consumerHelper("ns3::ndn::ConsumerCbr");
   consumerHelper.SetPrefix("/prefix/node/D");
   consumerHelper.SetAttribute("Frequency", StringValue("1"));
+  consumerHelper.SetAttribute("Parameters", StringValue("Hello from A"));
+  consumerHelper.SetAttribute("CipherKey", StringValue(cipherKey));
   auto apps = consumerHelper.Install(nodes.Get(0));
   apps.Stop(Seconds(5.0));
 
@@ -71,6 +77,7 @@ main(int argc, char* argv[])
   producerBHelper.SetPrefix("/prefix/node");
   producerBHelper.SetAttribute("ProducerName", StringValue("/B"));
   producerBHelper.SetAttribute("PayloadSize", StringValue("1024"));
+  producerBHelper.SetAttribute("CipherKey", StringValue(cipherKey));
   producerBHelper.Install(nodes.Get(1));
 
 
@@ -79,6 +86,7 @@ main(int argc, char* argv[])
   producerCHelper.SetPrefix("/prefix/node");
   producerCHelper.SetAttribute("ProducerName", StringValue("/C"));
   producerCHelper.SetAttribute("PayloadSize", StringValue("1024"));
+  producerCHelper.SetAttribute("CipherKey", StringValue(cipherKey));
   producerCHelper.Install(nodes.Get(2));
 
 
@@ -87,6 +95,7 @@ main(int argc, char* argv[])
   producerDHelper.SetPrefix("/prefix/node");
   producerDHelper.SetAttribute("ProducerName", StringValue("/D"));
   producerDHelper.SetAttribute("PayloadSize", StringValue("1024"));
+  producerDHelper.SetAttribute("CipherKey", StringValue(cipherKey));
   producerDHelper.Install(nodes.Get(3));
 
   Simulator::Stop(Seconds(20.0));
@@ -18,6 +18,7 @@
  **/
 
 #include "ndn-producer.hpp"
+#include "ndn-chacha20.hpp"
 #include "ns3/log.h"
 #include "ns3/string.h"
 #include "ns3/uinteger.h"
@@ -65,7 +66,12 @@ Producer::GetTypeId(void)
          MakeUintegerChecker<uint32_t>())
       .AddAttribute("KeyLocator",
                     "Name to be used for key locator.  If root, then key locator is not used",
-                    NameValue(), MakeNameAccessor(&Producer::m_keyLocator), MakeNameChecker());
+                    NameValue(), MakeNameAccessor(&Producer::m_keyLocator), MakeNameChecker())
+      .AddAttribute("CipherKey",
+                    "ChaCha20 key (64 hex characters) used by the consumers, empty if parameters are in clear",
+                    StringValue(""),
+                    MakeStringAccessor(&Producer::SetCipherKey, &Producer::GetCipherKey),
+                    MakeStringChecker());
   return tid;
 }
 
@@ -74,6 +80,21 @@ Producer::Producer()
   NS_LOG_FUNCTION_NOARGS();
 }
 
+void
+Producer::SetCipherKey(const std::string& hex)
+{
+  m_cipherKey = ChaCha20::KeyFromHex(hex);
+  if (!hex.empty() && m_cipherKey.empty()) {
+    NS_FATAL_ERROR("CipherKey must be " << 2 * ChaCha20::KEY_SIZE << " hex characters");
+  }
+}
+
+std::string
+Producer::GetCipherKey() const
+{
+  return ChaCha20::KeyToHex(m_cipherKey);
+}
+
 // inherited from Application base class.
 void
 Producer::StartApplication()
@@ -113,9 +134,14 @@ Producer::OnInterest(shared_ptr<const Interest> interest)
 	  if(interest->hasParameters())
 	  {
 		  Block parametersBlock = interest->getParameters();
-		  std::string Parameters = std::string((char*)parametersBlock.value());
-		  NS_LOG_INFO("The parameter is : "<< Parameters);
-		  std::reverse(Parameters.begin(),Parameters.end());
+		  std::string Parameters;
+		  if(m_cipherKey.empty())
+			  Parameters = std::string((const char*)parametersBlock.value(), parametersBlock.value_size());
+		  else if(!ChaCha20::Open(m_cipherKey, parametersBlock.value(), parametersBlock.value_size(), Parameters))
+		  {
+			  NS_LOG_INFO("Parameters too short to carry a nonce, dropping Interest");
+			  return;
+		  }
 		  NS_LOG_INFO("The decrypted parameter is : " << Parameters);
 
 		  // Extracting consumer Name from the data name
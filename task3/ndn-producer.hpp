@@ -28,6 +28,8 @@
 #include "ns3/nstime.h"
 #include "ns3/ptr.h"
 
+#include <vector>
+
 namespace ns3 {
 namespace ndn {
 
@@ -59,6 +61,13 @@ protected:
   virtual void
   StopApplication(); // Called at time specified by Stop
 
+private:
+  void
+  SetCipherKey(const std::string& hex);
+
+  std::string
+  GetCipherKey() const;
+
 private:
   Name m_prefix;
   Name m_postfix;
@@ -68,6 +77,7 @@ private:
   uint32_t m_signature;
   Name m_keyLocator;
   Name m_producerName;
+  std::vector<uint8_t> m_cipherKey;
 };
 
 } // namespace ndn
@@ -23,6 +23,7 @@
 #include "ns3/network-module.h"
 #include "ns3/point-to-point-module.h"
 #include "ns3/ndnSIM-module.h"
+#include "ns3/ndnSIM/apps/ndn-run-stats.hpp"
 
 namespace ns3 {
 
@@ -125,6 +126,7 @@ main(int argc, char* argv[])
 
   Simulator::Stop(Seconds(15.0));
 
+  ndn::RunStats::Install();
   Simulator::Run();
   Simulator::Destroy();
 
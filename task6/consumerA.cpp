@@ -285,6 +285,25 @@ ConsumerA::OnNack(shared_ptr<const lp::Nack> nack)
 
   NS_LOG_INFO("NACK received for: " << nack->getInterest().getName()
               << ", reason: " << nack->getReason());
+
+  const Name& name = nack->getInterest().getName();
+  if (name.empty() || !name.at(-1).isSequenceNumber())
+    return;
+  uint32_t seq = name.at(-1).toSequenceNumber();
+
+  if (nack->getReason() == lp::NackReason::CONGESTION) {
+    // back off: the next RTO doubles and seq waits for it like a lost Interest
+    m_rtt->IncreaseMultiplier();
+    return;
+  }
+
+  // NoRoute/Duplicate: re-send at once with a fresh nonce, at most a few times per seq
+  if (m_seqRetxCounts[seq] > 3)
+    return;
+  m_seqTimeouts.erase(seq);
+  m_retxSeqs.insert(seq);
+  Simulator::Cancel(m_sendEvent);
+  m_sendEvent = Simulator::ScheduleNow(&ConsumerA::SendPacket, this);
 }
 
 void
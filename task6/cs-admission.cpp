@@ -0,0 +1,226 @@
+#include "cs-admission.hpp"
+
+#include "ns3/log.h"
+#include "ns3/object-factory.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+
+#include <sstream>
+
+NS_LOG_COMPONENT_DEFINE("ndn.cs.Admission");
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED(AdmissionContentStore);
+
+TypeId
+AdmissionContentStore::GetTypeId()
+{
+  static TypeId tid =
+    TypeId("ns3::ndn::cs::Admission")
+      .SetGroupName("Ndn")
+      .SetParent<ContentStore>()
+      .AddConstructor<AdmissionContentStore>()
+      .AddAttribute("Policy", "ContentStore type doing the replacement, e.g. ns3::ndn::cs::Lfu",
+                    StringValue("ns3::ndn::cs::Lru"),
+                    MakeStringAccessor(&AdmissionContentStore::m_policy), MakeStringChecker())
+      .AddAttribute("MaxSize", "Entries of the main store", UintegerValue(100),
+                    MakeUintegerAccessor(&AdmissionContentStore::m_maxSize),
+                    MakeUintegerChecker<uint32_t>(1))
+      .AddAttribute("PriorityPrefixes", "Comma separated prefixes cached in the priority store",
+                    StringValue(""),
+                    MakeStringAccessor(&AdmissionContentStore::SetPriorityPrefixes,
+                                       &AdmissionContentStore::GetPriorityPrefixes),
+                    MakeStringChecker())
+      .AddAttribute("PrioritySize", "Entries of the priority store, 0 caches PriorityPrefixes "
+                    "in the main store like everything else",
+                    UintegerValue(0), MakeUintegerAccessor(&AdmissionContentStore::m_prioritySize),
+                    MakeUintegerChecker<uint32_t>())
+      .AddAttribute("BypassPrefixes", "Comma separated prefixes that are never looked up or cached",
+                    StringValue(""),
+                    MakeStringAccessor(&AdmissionContentStore::SetBypassPrefixes,
+                                       &AdmissionContentStore::GetBypassPrefixes),
+                    MakeStringChecker())
+      .AddAttribute("TrustedKeyLocator", "Only Data with this KeyLocator are cached, "
+                    "if root, then everything is",
+                    NameValue(), MakeNameAccessor(&AdmissionContentStore::m_trustedKeyLocator),
+                    MakeNameChecker())
+      .AddTraceSource("CacheRejected", "Data refused by the admission rules",
+                      MakeTraceSourceAccessor(&AdmissionContentStore::m_cacheRejectedTrace),
+                      "ns3::ndn::cs::Admission::RejectedCallback");
+
+  return tid;
+}
+
+AdmissionContentStore::AdmissionContentStore()
+  : m_maxSize(100)
+  , m_prioritySize(0)
+{
+}
+
+std::vector<Name>
+AdmissionContentStore::ParsePrefixes(const std::string& prefixes)
+{
+  std::vector<Name> names;
+  std::stringstream list(prefixes);
+  std::string prefix;
+  while (std::getline(list, prefix, ',')) {
+    if (!prefix.empty())
+      names.push_back(Name(prefix));
+  }
+  return names;
+}
+
+std::string
+AdmissionContentStore::FormatPrefixes(const std::vector<Name>& prefixes)
+{
+  std::string list;
+  for (const Name& prefix : prefixes) {
+    if (!list.empty())
+      list.push_back(',');
+    list.append(prefix.toUri());
+  }
+  return list;
+}
+
+bool
+AdmissionContentStore::HasPrefix(const std::vector<Name>& prefixes, const Name& name)
+{
+  for (const Name& prefix : prefixes) {
+    if (prefix.isPrefixOf(name))
+      return true;
+  }
+  return false;
+}
+
+void
+AdmissionContentStore::SetPriorityPrefixes(const std::string& prefixes)
+{
+  m_priorityPrefixes = ParsePrefixes(prefixes);
+}
+
+std::string
+AdmissionContentStore::GetPriorityPrefixes() const
+{
+  return FormatPrefixes(m_priorityPrefixes);
+}
+
+void
+AdmissionContentStore::SetBypassPrefixes(const std::string& prefixes)
+{
+  m_bypassPrefixes = ParsePrefixes(prefixes);
+}
+
+std::string
+AdmissionContentStore::GetBypassPrefixes() const
+{
+  return FormatPrefixes(m_bypassPrefixes);
+}
+
+Ptr<ContentStore>
+AdmissionContentStore::GetStore(const Name& name)
+{
+  if (HasPrefix(m_bypassPrefixes, name))
+    return 0;
+
+  bool priority = m_prioritySize > 0 && HasPrefix(m_priorityPrefixes, name);
+  Ptr<ContentStore>& store = priority ? m_priorityStore : m_store;
+  if (!store) {
+    // attributes are all set by now, whichever order the factory applied them in
+    ObjectFactory factory;
+    factory.SetTypeId(m_policy);
+    factory.Set("MaxSize", UintegerValue(priority ? m_prioritySize : m_maxSize));
+    store = factory.Create<ContentStore>();
+  }
+  return store;
+}
+
+bool
+AdmissionContentStore::IsAdmitted(const Data& data) const
+{
+  if (m_trustedKeyLocator.empty())
+    return true;
+
+  const Signature& signature = data.getSignature();
+  return signature.hasKeyLocator() &&
+         signature.getKeyLocator().getType() == KeyLocator::KeyLocator_Name &&
+         signature.getKeyLocator().getName() == m_trustedKeyLocator;
+}
+
+shared_ptr<Data>
+AdmissionContentStore::Lookup(shared_ptr<const Interest> interest)
+{
+  Ptr<ContentStore> store = GetStore(interest->getName());
+  if (!store)
+    return nullptr;
+
+  shared_ptr<Data> data = store->Lookup(interest);
+  if (data != nullptr)
+    m_cacheHitsTrace(interest, data);
+  else
+    m_cacheMissesTrace(interest);
+  return data;
+}
+
+bool
+AdmissionContentStore::Add(shared_ptr<const Data> data)
+{
+  Ptr<ContentStore> store = GetStore(data->getName());
+  if (!store)
+    return false;
+
+  if (!IsAdmitted(*data)) {
+    NS_LOG_DEBUG("Not caching " << data->getName());
+    m_cacheRejectedTrace(data);
+    return false;
+  }
+  return store->Add(data);
+}
+
+void
+AdmissionContentStore::Print(std::ostream& os) const
+{
+  if (m_priorityStore)
+    m_priorityStore->Print(os);
+  if (m_store)
+    m_store->Print(os);
+}
+
+uint32_t
+AdmissionContentStore::GetSize() const
+{
+  uint32_t size = 0;
+  if (m_store)
+    size += m_store->GetSize();
+  if (m_priorityStore)
+    size += m_priorityStore->GetSize();
+  return size;
+}
+
+Ptr<cs::Entry>
+AdmissionContentStore::Begin()
+{
+  if (!m_store)
+    return 0;
+  return m_store->Begin();
+}
+
+Ptr<cs::Entry>
+AdmissionContentStore::End()
+{
+  if (!m_store)
+    return 0;
+  return m_store->End();
+}
+
+Ptr<cs::Entry>
+AdmissionContentStore::Next(Ptr<cs::Entry> entry)
+{
+  if (!m_store)
+    return 0;
+  return m_store->Next(entry);
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -23,9 +23,60 @@
 #include "ns3/network-module.h"
 #include "ns3/point-to-point-module.h"
 #include "ns3/ndnSIM-module.h"
+#include "ns3/ndnSIM/apps/ndn-run-stats.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
 
 namespace ns3 {
 
+struct CacheCounts {
+  uint64_t hits = 0;
+  uint64_t lookups = 0;
+};
+
+static std::map<std::pair<uint32_t, std::string>, CacheCounts> g_caches; ///< (node, prefix)
+
+// node id from the /NodeList/<id>/... context, prefix up to the first number (at most two components)
+static CacheCounts&
+GetCache(const std::string& context, const ndn::Name& name)
+{
+  uint32_t node = std::strtoul(context.c_str() + std::strlen("/NodeList/"), nullptr, 10);
+  size_t depth = 0;
+  while (depth < 2 && depth < name.size() && !name.at(depth).isSequenceNumber() &&
+         !name.at(depth).isNumber())
+    depth++;
+  return g_caches[std::make_pair(node, name.getPrefix(depth).toUri())];
+}
+
+static void
+CacheHit(std::string context, shared_ptr<const ndn::Interest> interest, shared_ptr<const ndn::Data>)
+{
+  CacheCounts& cache = GetCache(context, interest->getName());
+  cache.hits++;
+  cache.lookups++;
+}
+
+static void
+CacheMiss(std::string context, shared_ptr<const ndn::Interest> interest)
+{
+  GetCache(context, interest->getName()).lookups++;
+}
+
+// "Nocache", or "<Lru|Lfu|Fifo|Random>:<entries>" behind the admission of cs-admission.hpp
+static void
+SetContentStore(ndn::StackHelper& ndnHelper, const std::string& cs)
+{
+  size_t colon = cs.find(':');
+  if (colon == std::string::npos) {
+    ndnHelper.SetOldContentStore("ns3::ndn::cs::Nocache");
+    return;
+  }
+  ndnHelper.SetOldContentStore("ns3::ndn::cs::Admission", "Policy", "ns3::ndn::cs::" + cs.substr(0, colon),
+                               "MaxSize", cs.substr(colon + 1));
+}
 
 int
 main(int argc, char* argv[])
@@ -36,9 +87,36 @@ main(int argc, char* argv[])
   Config::SetDefault("ns3::QueueBase::MaxSize", StringValue("20p"));
 
   // Read optional command-line parameters (e.g., enable visualizer with ./waf --run=<> --visualize
+  std::string csPeer = "Nocache";
+  std::string csRouter = "Nocache";
+  std::string csProxy = "Nocache";
+  std::string csPriority = "";
+  uint32_t csPrioritySize = 0;
+  std::string csBypass = "/prefix/sync,/prefix/data/sync";
+  std::string csTrustedKey = "/prefix/KEY";
+
   CommandLine cmd;
+  cmd.AddValue("csPeer", "Content store of Peer B and Peer A: Nocache or <Lru|Lfu|Fifo|Random>:<entries>", csPeer);
+  cmd.AddValue("csRouter", "Content store of the routers (nodes 1 and 3)", csRouter);
+  cmd.AddValue("csProxy", "Content store of the proxies (nodes 5 and 7)", csProxy);
+  cmd.AddValue("csPriority", "Comma separated prefixes cached apart from the rest", csPriority);
+  cmd.AddValue("csPrioritySize", "Entries of the priority part of every content store, 0 disables it", csPrioritySize);
+  cmd.AddValue("csBypass", "Comma separated prefixes that are never cached", csBypass);
+  cmd.AddValue("csTrustedKey", "KeyLocator of ProducerA and ProducerB; caches only admit Data with it", csTrustedKey);
   cmd.Parse(argc, argv);
 
+  Config::SetDefault("ns3::ndn::cs::Admission::PriorityPrefixes", StringValue(csPriority));
+  Config::SetDefault("ns3::ndn::cs::Admission::PrioritySize", UintegerValue(csPrioritySize));
+  Config::SetDefault("ns3::ndn::cs::Admission::BypassPrefixes", StringValue(csBypass));
+  Config::SetDefault("ns3::ndn::cs::Admission::TrustedKeyLocator", StringValue(csTrustedKey));
+
+  // the censor does not sign with the trusted key, so its bogus Data never enter a cache
+  std::string roles = csPeer + csRouter + csProxy;
+  if (roles.find(':') != std::string::npos && !csTrustedKey.empty()) {
+    Config::SetDefault("ns3::ndn::ProducerA::KeyLocator", StringValue(csTrustedKey));
+    Config::SetDefault("ns3::ndn::ProducerB::KeyLocator", StringValue(csTrustedKey));
+  }
+
   // Creating nodes
   NodeContainer nodes;
   nodes.Create(8);
@@ -54,11 +132,20 @@ main(int argc, char* argv[])
   p2p.Install(nodes.Get(1), nodes.Get(7));
 
 
-  // Install NDN stack on all nodes
+  // Install NDN stack on all nodes, with the content store of the node's role
   ndn::StackHelper ndnHelper;
   ndnHelper.SetDefaultRoutes(true);
-  ndnHelper.SetOldContentStore("ns3::ndn::cs::Nocache");
-  ndnHelper.InstallAll();
+  for (uint32_t i = 0; i < nodes.GetN(); i++) {
+    std::string cs = csPeer;
+    if (i == 1 || i == 3)
+      cs = csRouter;
+    else if (i == 5 || i == 7)
+      cs = csProxy;
+    else if (i == 2 || i == 6)
+      cs = "Nocache"; // the censor and the proxy behind it
+    SetContentStore(ndnHelper, cs);
+    ndnHelper.Install(nodes.Get(i));
+  }
 
   // Choosing forwarding strategy
   ndn::StrategyChoiceHelper::InstallAll("/prefix", "/localhost/nfd/strategy/multicast");
@@ -136,11 +223,30 @@ main(int argc, char* argv[])
   ndn::AppHelper producerProxy33Helper("ns3::ndn::ProxyProducer");
   producerProxy33Helper.SetPrefix("/nytimes");
   producerProxy33Helper.Install(nodes.Get(7));
+  Config::Connect("/NodeList/*/$ns3::ndn::ContentStore/CacheHits", MakeCallback(&CacheHit));
+  Config::Connect("/NodeList/*/$ns3::ndn::ContentStore/CacheMisses", MakeCallback(&CacheMiss));
+
   Simulator::Stop(Seconds(12.0));
 
+  ndn::RunStats::Install();
   Simulator::Run();
   Simulator::Destroy();
 
+  // hits are Interests that never reached a producer; nodes without a cache only miss
+  std::map<std::string, CacheCounts> prefixes;
+  for (const auto& entry : g_caches) {
+    prefixes[entry.first.second].hits += entry.second.hits;
+    prefixes[entry.first.second].lookups += entry.second.lookups;
+    if (entry.second.hits > 0)
+      std::cout << "Cache\tNode" << entry.first.first << "\t" << entry.first.second << "\t"
+                << entry.second.hits << "/" << entry.second.lookups << "\n";
+  }
+  for (const auto& prefix : prefixes) {
+    if (prefix.second.hits > 0)
+      std::cout << "Cache\tAll\t" << prefix.first << "\t" << prefix.second.hits << "/"
+                << prefix.second.lookups << "\n";
+  }
+
   return 0;
 }
 
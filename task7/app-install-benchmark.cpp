@@ -0,0 +1,107 @@
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/ndnSIM-module.h"
+#include "ns3/ndnSIM/apps/ndn-app-installer.hpp"
+
+#include <chrono>
+#include <iostream>
+
+namespace ns3 {
+
+static std::string
+PeerName(uint32_t i)
+{
+  return "P" + std::to_string(i);
+}
+
+// one AppHelper per app and string attributes, as the scaled scenario did
+static void
+InstallWithHelpers(NodeContainer& nodes)
+{
+  for (uint32_t i = 0; i < nodes.GetN(); i++) {
+    ndn::AppHelper consumerHelper("ns3::ndn::PeerConsumerCbr");
+    consumerHelper.SetPrefix("/prefix/");
+    consumerHelper.SetAttribute("PeerKey", StringValue(std::to_string(10001 + i % 1000)));
+    consumerHelper.SetAttribute("PeerToken", StringValue("token"));
+    consumerHelper.SetAttribute("PeerName", StringValue(PeerName(i)));
+    consumerHelper.SetAttribute("SyncPeers", StringValue(PeerName(i + 1)));
+    consumerHelper.SetAttribute("Frequency", StringValue("3"));
+    consumerHelper.Install(nodes.Get(i));
+
+    ndn::AppHelper producerHelper("ns3::ndn::PeerProducer");
+    producerHelper.SetPrefix("/prefix/peer");
+    producerHelper.SetAttribute("PeerName", StringValue(PeerName(i)));
+    producerHelper.Install(nodes.Get(i));
+  }
+}
+
+static void
+InstallInBulk(NodeContainer& nodes)
+{
+  TypeId consumerType = TypeId::LookupByName("ns3::ndn::PeerConsumerCbr");
+  TypeId producerType = TypeId::LookupByName("ns3::ndn::PeerProducer");
+  ndn::BulkAppInstaller apps;
+
+  for (uint32_t i = 0; i < nodes.GetN(); i++) {
+    ndn::PeerConsumerAttributes consumer;
+    consumer.prefix = "/prefix/";
+    consumer.peerKey = 10001 + i % 1000;
+    consumer.peerToken = "token";
+    consumer.peerName = PeerName(i);
+    consumer.syncPeers = PeerName(i + 1);
+    consumer.frequency = 3;
+    apps.Add(nodes.Get(i), consumerType, consumer);
+
+    ndn::PeerProducerAttributes producer;
+    producer.prefix = "/prefix/peer";
+    producer.peerName = PeerName(i);
+    apps.Add(nodes.Get(i), producerType, producer);
+  }
+
+  apps.Install();
+}
+
+// Scenario construction time of nApps apps, a PeerConsumerCbr and a PeerProducer on each of
+// nApps/2 nodes, installed through AppHelper and through BulkAppInstaller. Node creation is not
+// timed, and each path gets its own nodes. Run with path=helper and path=bulk in two processes to
+// keep the allocator state of one path out of the other.
+int
+main(int argc, char* argv[])
+{
+  uint32_t nApps = 100000;
+  std::string path = "both";
+
+  CommandLine cmd;
+  cmd.AddValue("nApps", "Number of apps installed by each path", nApps);
+  cmd.AddValue("path", "helper, bulk or both", path);
+  cmd.Parse(argc, argv);
+
+  for (const std::string& run : {std::string("helper"), std::string("bulk")}) {
+    if (path != "both" && path != run)
+      continue;
+
+    NodeContainer nodes;
+    nodes.Create(nApps / 2);
+
+    auto start = std::chrono::steady_clock::now();
+    if (run == "helper")
+      InstallWithHelpers(nodes);
+    else
+      InstallInBulk(nodes);
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << run << ": " << nodes.GetN() * 2 << " apps, " << wall << " s, "
+              << wall * 1e6 / (nodes.GetN() * 2) << " us per app\n";
+  }
+
+  Simulator::Destroy();
+  return 0;
+}
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+  return ns3::main(argc, argv);
+}
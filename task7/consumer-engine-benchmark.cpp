@@ -0,0 +1,88 @@
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/ndnSIM-module.h"
+
+#include <ctime>
+#include <chrono>
+#include <iostream>
+
+namespace ns3 {
+
+static uint64_t g_interests = 0;
+
+static void
+CountInterest(shared_ptr<const ndn::Interest>, Ptr<ndn::App>, shared_ptr<ndn::Face>)
+{
+  g_interests++;
+}
+
+// CPU cost per Interest of the consumer engine: nConsumers ConsumerACbr poll the sync name of a
+// single ProducerA every 10ms, so the run is dominated by SendPacket/OnData of the consumers and
+// the forwarding of their Interests. The figure includes the forwarder; build this program from
+// the tree before the engine was introduced to get the number of the old ConsumerA.
+int
+main(int argc, char* argv[])
+{
+  uint32_t nConsumers = 100;
+  double simTime = 10.0;
+
+  CommandLine cmd;
+  cmd.AddValue("nConsumers", "Number of ConsumerACbr apps, one per leaf node", nConsumers);
+  cmd.AddValue("simTime", "Simulated time in seconds", simTime);
+  cmd.Parse(argc, argv);
+
+  Config::SetDefault("ns3::PointToPointNetDevice::DataRate", StringValue("100Mbps"));
+  Config::SetDefault("ns3::PointToPointChannel::Delay", StringValue("1ms"));
+
+  NodeContainer hub;
+  hub.Create(1);
+  NodeContainer leaves;
+  leaves.Create(nConsumers);
+
+  PointToPointHelper p2p;
+  for (uint32_t i = 0; i < nConsumers; i++) {
+    p2p.Install(hub.Get(0), leaves.Get(i));
+  }
+
+  ndn::StackHelper ndnHelper;
+  ndnHelper.SetDefaultRoutes(true);
+  ndnHelper.SetOldContentStore("ns3::ndn::cs::Nocache");
+  ndnHelper.InstallAll();
+
+  ndn::StrategyChoiceHelper::InstallAll("/prefix", "/localhost/nfd/strategy/multicast");
+
+  ndn::AppHelper producerHelper("ns3::ndn::ProducerA");
+  producerHelper.SetPrefix("/prefix/file");
+  producerHelper.Install(hub.Get(0));
+
+  ndn::AppHelper consumerHelper("ns3::ndn::ConsumerACbr");
+  consumerHelper.SetPrefix("/prefix/file/sync");
+  consumerHelper.Install(leaves);
+
+  Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/$ns3::ndn::ConsumerA/TransmittedInterests",
+                                MakeCallback(&CountInterest));
+
+  Simulator::Stop(Seconds(simTime));
+
+  std::clock_t cpuStart = std::clock();
+  auto wallStart = std::chrono::steady_clock::now();
+  Simulator::Run();
+  double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+  double cpu = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+  Simulator::Destroy();
+
+  std::cout << "consumers: " << nConsumers << ", interests: " << g_interests << "\n"
+            << "wall: " << wall << " s, cpu: " << cpu << " s\n"
+            << "cpu per interest: " << (g_interests ? cpu * 1e6 / g_interests : 0) << " us\n";
+
+  return 0;
+}
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+  return ns3::main(argc, argv);
+}
@@ -0,0 +1,491 @@
+#ifndef NDN_CONSUMER_ENGINE_IMPL_H
+#define NDN_CONSUMER_ENGINE_IMPL_H
+
+// Member definitions of ConsumerEngine. Include this only from the translation unit that
+// explicitly instantiates the engine for a consumer, after its NS_LOG_COMPONENT_DEFINE: logging
+// uses that unit's log component, and the hot path (SendInterest, AcknowledgeData) is inlined
+// into the consumer's SendPacket/OnData.
+
+#include "consumer-engine.hpp"
+#include "ndn-app-log.hpp"
+#include "ndn-app-profile.hpp"
+
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/integer.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+
+#include "utils/ndn-rtt-mean-deviation.hpp"
+
+#include <ndn-cxx/lp/tags.hpp>
+
+#include <limits>
+
+namespace ns3 {
+namespace ndn {
+
+template<class Derived>
+TypeId
+ConsumerEngine<Derived>::AddEngineAttributes(TypeId tid)
+{
+  const std::string name = tid.GetName();
+
+  return tid
+    .AddAttribute("StartSeq", "Initial sequence number", IntegerValue(0),
+                  MakeIntegerAccessor(&ConsumerEngine::m_seq), MakeIntegerChecker<int32_t>())
+
+    .AddAttribute("Prefix", "Name of the Interest", StringValue("/"),
+                  MakeInternedNameAccessor(&ConsumerEngine::m_interestName), MakeNameChecker())
+    .AddAttribute("LifeTime", "LifeTime for interest packet", StringValue("2s"),
+                  MakeTimeAccessor(&ConsumerEngine::m_interestLifeTime), MakeTimeChecker())
+
+    .AddAttribute("RetxTimer",
+                  "Timeout defining how frequent retransmission timeouts should be checked",
+                  StringValue("50ms"),
+                  MakeTimeAccessor(&ConsumerEngine::GetRetxTimer, &ConsumerEngine::SetRetxTimer),
+                  MakeTimeChecker())
+
+    .AddAttribute("NackRetxLimit",
+                  "Immediate re-sends of a sequence number after NoRoute or Duplicate NACKs, "
+                  "0 leaves every NACKed Interest to the retransmission timer",
+                  UintegerValue(3), MakeUintegerAccessor(&ConsumerEngine::m_nackRetxLimit),
+                  MakeUintegerChecker<uint32_t>())
+
+    .AddAttribute("OutstandingInterests", "Tracked Interests waiting for Data (read-only)",
+                  TypeId::ATTR_GET, UintegerValue(0),
+                  MakeUintegerAccessor(&ConsumerEngine::GetOutstandingInterests),
+                  MakeUintegerChecker<uint32_t>())
+
+    .AddTraceSource("LastRetransmittedInterestDataDelay",
+                    "Delay between last retransmitted Interest and received Data",
+                    MakeTraceSourceAccessor(&ConsumerEngine::m_lastRetransmittedInterestDataDelay),
+                    name + "::LastRetransmittedInterestDataDelayCallback")
+
+    .AddTraceSource("FirstInterestDataDelay",
+                    "Delay between first transmitted Interest and received Data",
+                    MakeTraceSourceAccessor(&ConsumerEngine::m_firstInterestDataDelay),
+                    name + "::FirstInterestDataDelayCallback")
+
+    .AddTraceSource("Timeout", "Retransmission timer of a sequence number expired",
+                    MakeTraceSourceAccessor(&ConsumerEngine::m_timeout),
+                    name + "::TimeoutCallback")
+
+    .AddTraceSource("RetransmissionRecovered",
+                    "Data for a retransmitted sequence number: time since the first "
+                    "retransmission and whether that was spurious",
+                    MakeTraceSourceAccessor(&ConsumerEngine::m_retransmissionRecovered),
+                    name + "::RetransmissionRecoveredCallback");
+}
+
+template<class Derived>
+TypeId
+ConsumerEngine<Derived>::AddSchedulingAttributes(TypeId tid)
+{
+  return tid
+    .AddAttribute("Frequency", "Frequency of interest packets", StringValue("1.0"),
+                  MakeDoubleAccessor(&ConsumerEngine::m_frequency), MakeDoubleChecker<double>())
+
+    .AddAttribute("Randomize",
+                  "Type of send time randomization: none (default), uniform, exponential",
+                  StringValue("none"),
+                  MakeStringAccessor(&ConsumerEngine::SetRandomize, &ConsumerEngine::GetRandomize),
+                  MakeStringChecker())
+
+    .AddAttribute("MaxSeq", "Maximum sequence number to request",
+                  IntegerValue(std::numeric_limits<uint32_t>::max()),
+                  MakeIntegerAccessor(&ConsumerEngine::m_seqMax), MakeIntegerChecker<uint32_t>());
+}
+
+template<class Derived>
+ConsumerEngine<Derived>::ConsumerEngine()
+  : m_seq(0)
+  , m_seqMax(std::numeric_limits<uint32_t>::max())
+  , m_nackRetxLimit(3)
+  , m_frequency(1.0)
+  , m_firstTime(true)
+{
+}
+
+template<class Derived>
+Ptr<RttEstimator>
+ConsumerEngine<Derived>::GetRtt(uint32_t requestClass)
+{
+  while (m_rtts.size() <= requestClass)
+    m_rtts.push_back(CreateObject<RttMeanDeviation>());
+  return m_rtts[requestClass];
+}
+
+template<class Derived>
+const Ptr<UniformRandomVariable>&
+ConsumerEngine<Derived>::GetRand()
+{
+  static Ptr<UniformRandomVariable> rand = CreateObject<UniformRandomVariable>();
+  return rand;
+}
+
+template<class Derived>
+void
+ConsumerEngine<Derived>::SetRetxTimer(Time retxTimer)
+{
+  m_retxTimer = retxTimer;
+  if (m_retxEvent.IsRunning()) {
+    // m_retxEvent.Cancel (); // cancel any scheduled cleanup events
+    Simulator::Remove(m_retxEvent); // slower, but better for memory
+  }
+
+  // schedule even with new timeout
+  m_retxEvent = Simulator::Schedule(m_retxTimer, &ConsumerEngine::CheckRetxTimeout, this);
+}
+
+template<class Derived>
+Time
+ConsumerEngine<Derived>::GetRetxTimer() const
+{
+  return m_retxTimer;
+}
+
+template<class Derived>
+void
+ConsumerEngine<Derived>::CheckRetxTimeout()
+{
+  NDN_APP_PROFILE("CheckRetxTimeout");
+
+  Time now = Simulator::Now();
+
+  std::vector<Time> rtos;
+  Time minRto;
+  for (const Ptr<RttEstimator>& rtt : m_rtts) {
+    rtos.push_back(rtt->RetransmitTimeout());
+    if (rtos.size() == 1 || rtos.back() < minRto)
+      minRto = rtos.back();
+  }
+
+  m_retxEvent = Simulator::Schedule(m_retxTimer, &ConsumerEngine::CheckRetxTimeout, this);
+
+  if (!m_tracking)
+    return;
+  if (m_tracking->seqs.empty()) {
+    m_tracking.reset(); // idle, keep only the pointer
+    return;
+  }
+
+  auto& byTime = m_tracking->timeouts.template get<i_timestamp>();
+  auto entry = byTime.begin();
+  while (entry != byTime.end()) {
+    if (entry->time + minRto > now)
+      break; // nothing else to do. All later packets need not be retransmitted
+
+    uint32_t requestClass = static_cast<uint32_t>(entry->seq >> 32);
+    if (requestClass < rtos.size() && entry->time + rtos[requestClass] > now) {
+      entry++; // within the RTO of its own class
+      continue;
+    }
+
+    uint32_t seqNo = static_cast<uint32_t>(entry->seq);
+    entry = byTime.erase(entry);
+    OnTimeout(seqNo, requestClass);
+  }
+}
+
+template<class Derived>
+void
+ConsumerEngine<Derived>::SaveEngineState(SnapshotWriter& writer) const
+{
+  writer.Put(m_seq);
+  writer.Put(static_cast<uint32_t>(m_tracking ? m_tracking->seqs.size() : 0));
+  if (!m_tracking)
+    return;
+
+  for (const auto& entry : m_tracking->seqs) {
+    const SeqState& state = entry.second;
+    writer.Put(entry.first);
+    writer.Put(state.firstSent);
+    writer.Put(state.lastSent);
+    writer.Put(state.retxStart);
+    writer.Put(state.sentCount);
+    writer.Put(state.nackRetxCount);
+  }
+}
+
+template<class Derived>
+void
+ConsumerEngine<Derived>::LoadEngineState(SnapshotReader& reader)
+{
+  uint32_t tracked = 0;
+  reader.Get(m_seq);
+  reader.Get(tracked);
+
+  m_tracking.reset();
+  for (uint32_t i = 0; i < tracked; i++) {
+    uint64_t key = 0;
+    SeqState state;
+    reader.Get(key);
+    reader.Get(state.firstSent);
+    reader.Get(state.lastSent);
+    reader.Get(state.retxStart);
+    reader.Get(state.sentCount);
+    reader.Get(state.nackRetxCount);
+
+    GetTracking().seqs[key] = state;
+    m_tracking->retxSeqs.insert(key);
+  }
+}
+
+// Application Methods
+template<class Derived>
+void
+ConsumerEngine<Derived>::StartApplication() // Called at time specified by Start
+{
+  NDN_APP_LOG_FUNCTION_NOARGS();
+
+  // do base stuff
+  App::StartApplication();
+
+  ScheduleNextPacket();
+}
+
+template<class Derived>
+void
+ConsumerEngine<Derived>::StopApplication() // Called at time specified by Stop
+{
+  NDN_APP_LOG_FUNCTION_NOARGS();
+
+  // cancel periodic packet generation
+  Simulator::Cancel(m_sendEvent);
+
+  // cleanup base stuff
+  App::StopApplication();
+}
+
+template<class Derived>
+inline void
+ConsumerEngine<Derived>::ScheduleNextPacket()
+{
+  if (m_firstTime) {
+    m_sendEvent = Simulator::Schedule(Seconds(0.0), &Derived::SendPacket, &derived());
+    m_firstTime = false;
+  }
+  else if (!m_sendEvent.IsRunning() && derived().CanSend())
+    m_sendEvent =
+      Simulator::Schedule(derived().GetSendInterval(), &Derived::SendPacket, &derived());
+}
+
+template<class Derived>
+inline bool
+ConsumerEngine<Derived>::PopRetxSeq(uint32_t& seq, uint32_t& requestClass)
+{
+  if (!m_tracking || m_tracking->retxSeqs.empty())
+    return false;
+
+  RetxSeqsContainer& retxSeqs = m_tracking->retxSeqs;
+  uint64_t key = *retxSeqs.begin();
+  retxSeqs.erase(retxSeqs.begin());
+  seq = static_cast<uint32_t>(key);
+  requestClass = static_cast<uint32_t>(key >> 32);
+  return true;
+}
+
+template<class Derived>
+inline void
+ConsumerEngine<Derived>::SendInterest(const shared_ptr<Interest>& interest, uint32_t seq,
+                                      uint32_t requestClass)
+{
+  WillSendOutInterest(seq, requestClass);
+  m_tracking->seqs[MakeKey(seq, requestClass)].interest = interest;
+
+  TransmitInterest(interest);
+}
+
+template<class Derived>
+inline void
+ConsumerEngine<Derived>::TransmitInterest(const shared_ptr<Interest>& interest)
+{
+  NDN_APP_PROFILE("Transmit"); // includes the forwarder's processing of the Interest
+
+  interest->setNonce(GetRand()->GetValue(0, std::numeric_limits<uint32_t>::max()));
+  interest->setCanBePrefix(false);
+  time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
+  interest->setInterestLifetime(interestLifeTime);
+
+  NDN_APP_LOG_INFO("> Interest for " << interest->getName());
+
+  m_transmittedInterests(interest, this, m_face);
+  m_appLink->onReceiveInterest(*interest);
+
+  ScheduleNextPacket();
+}
+
+template<class Derived>
+inline void
+ConsumerEngine<Derived>::AcknowledgeData(const Data& data, uint32_t seq, uint32_t requestClass)
+{
+  int hopCount = 0;
+  auto hopCountTag = data.getTag<lp::HopCountTag>();
+  if (hopCountTag != nullptr) { // e.g., packet came from local node's cache
+    hopCount = *hopCountTag;
+  }
+  NDN_APP_LOG_DEBUG("Hop count: " << hopCount);
+
+  Ptr<RttEstimator> rtt = GetRtt(requestClass);
+
+  if (m_tracking) {
+    auto entry = m_tracking->seqs.find(MakeKey(seq, requestClass));
+    if (entry != m_tracking->seqs.end()) {
+      const SeqState& state = entry->second;
+      Time delay = Simulator::Now() - state.lastSent;
+      m_lastRetransmittedInterestDataDelay(this, seq, delay, hopCount);
+
+      if (state.sentCount > 1) {
+        // faster than any plausible round trip: the Data answered an earlier copy
+        bool spurious = delay.GetSeconds() * 2 < rtt->GetCurrentEstimate().GetSeconds();
+        m_retransmissionRecovered(this, seq, Simulator::Now() - state.retxStart, spurious);
+      }
+
+      m_firstInterestDataDelay(this, seq, Simulator::Now() - state.firstSent, state.sentCount,
+                               hopCount);
+    }
+  }
+
+  StopTracking(seq, requestClass);
+
+  rtt->AckSeq(SequenceNumber32(seq));
+}
+
+template<class Derived>
+inline void
+ConsumerEngine<Derived>::StopTracking(uint32_t seq, uint32_t requestClass)
+{
+  if (!m_tracking)
+    return;
+
+  uint64_t key = MakeKey(seq, requestClass);
+  m_tracking->seqs.erase(key);
+  m_tracking->timeouts.erase(key);
+  m_tracking->retxSeqs.erase(key);
+}
+
+template<class Derived>
+void
+ConsumerEngine<Derived>::OnNack(shared_ptr<const lp::Nack> nack)
+{
+  NDN_APP_PROFILE("OnNack");
+
+  /// tracing inside
+  App::OnNack(nack);
+
+  NDN_APP_LOG_INFO("NACK received for: " << nack->getInterest().getName()
+              << ", reason: " << nack->getReason());
+
+  if (!m_tracking)
+    return;
+
+  // only a handful of sequence numbers are in flight, and NACKs are rare
+  const Name& name = nack->getInterest().getName();
+  auto sent = m_tracking->seqs.begin();
+  while (sent != m_tracking->seqs.end()
+         && (sent->second.interest == nullptr || sent->second.interest->getName() != name))
+    sent++;
+  if (sent == m_tracking->seqs.end())
+    return; // untracked (TransmitInterest) or answered in the meantime
+
+  uint64_t key = sent->first;
+  uint32_t seq = static_cast<uint32_t>(key);
+  uint32_t requestClass = static_cast<uint32_t>(key >> 32);
+  if (nack->getReason() == lp::NackReason::CONGESTION) {
+    // back off: the next RTO of the class doubles and seq waits for it like a lost Interest
+    GetRtt(requestClass)->IncreaseMultiplier();
+    return;
+  }
+
+  uint32_t& nackRetxCount = sent->second.nackRetxCount;
+  if (nackRetxCount >= m_nackRetxLimit)
+    return;
+  nackRetxCount++;
+
+  NDN_APP_LOG_DEBUG("Re-sending " << seq << " after the NACK");
+  shared_ptr<Interest> interest = make_shared<Interest>(*sent->second.interest);
+  m_tracking->timeouts.erase(key);
+  m_tracking->retxSeqs.erase(key);
+  SendInterest(interest, seq, requestClass); // fresh nonce, restarts the retransmission timer
+}
+
+template<class Derived>
+void
+ConsumerEngine<Derived>::OnTimeout(uint32_t sequenceNumber, uint32_t requestClass)
+{
+  NDN_APP_PROFILE("OnTimeout");
+  NDN_APP_LOG_FUNCTION(sequenceNumber);
+  // std::cout << Simulator::Now () << ", TO: " << sequenceNumber << ", current RTO: " <<
+  // m_rtt->RetransmitTimeout ().ToDouble (Time::S) << "s\n";
+
+  uint64_t key = MakeKey(sequenceNumber, requestClass);
+  m_timeout(this, sequenceNumber);
+
+  Tracking& tracking = GetTracking();
+  auto entry = tracking.seqs.find(key);
+  if (entry != tracking.seqs.end())
+    entry->second.interest.reset();
+
+  Ptr<RttEstimator> rtt = GetRtt(requestClass);
+  rtt->IncreaseMultiplier(); // Double the next RTO
+  rtt->SentSeq(SequenceNumber32(sequenceNumber),
+               1); // make sure to disable RTT calculation for this sample
+  tracking.retxSeqs.insert(key);
+  ScheduleNextPacket();
+}
+
+template<class Derived>
+inline void
+ConsumerEngine<Derived>::WillSendOutInterest(uint32_t sequenceNumber, uint32_t requestClass)
+{
+  NDN_APP_LOG_DEBUG("Trying to add " << sequenceNumber << " with " << Simulator::Now() << ". already "
+                                << GetOutstandingInterests() << " items");
+
+  Time now = Simulator::Now();
+  uint64_t key = MakeKey(sequenceNumber, requestClass);
+  Tracking& tracking = GetTracking();
+  tracking.timeouts.insert(SeqTimeout(key, now));
+
+  SeqState& state = tracking.seqs[key];
+  if (state.sentCount == 0)
+    state.firstSent = now;
+  else if (state.sentCount == 1)
+    state.retxStart = now;
+  state.sentCount++;
+  state.lastSent = now;
+
+  GetRtt(requestClass)->SentSeq(SequenceNumber32(sequenceNumber), 1);
+}
+
+template<class Derived>
+void
+ConsumerEngine<Derived>::SetRandomize(const std::string& value)
+{
+  if (value == "uniform") {
+    m_random = CreateObject<UniformRandomVariable>();
+    m_random->SetAttribute("Min", DoubleValue(0.0));
+    m_random->SetAttribute("Max", DoubleValue(2 * 1.0 / m_frequency));
+  }
+  else if (value == "exponential") {
+    m_random = CreateObject<ExponentialRandomVariable>();
+    m_random->SetAttribute("Mean", DoubleValue(1.0 / m_frequency));
+    m_random->SetAttribute("Bound", DoubleValue(50 * 1.0 / m_frequency));
+  }
+  else
+    m_random = 0;
+}
+
+template<class Derived>
+std::string
+ConsumerEngine<Derived>::GetRandomize() const
+{
+  if (!m_random)
+    return "none";
+  return DynamicCast<ExponentialRandomVariable>(m_random) ? "exponential" : "uniform";
+}
+
+} // namespace ndn
+} // namespace ns3
+
+#endif
@@ -0,0 +1,389 @@
+#ifndef NDN_CONSUMER_ENGINE_H
+#define NDN_CONSUMER_ENGINE_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ndn-app.hpp"
+#include "ndn-app-snapshot.hpp"
+#include "ndn-name-table.hpp"
+
+#include "ns3/random-variable-stream.h"
+#include "ns3/nstime.h"
+
+#include "ns3/ndnSIM/utils/ndn-rtt-estimator.hpp"
+
+#include <set>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/tag.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index/member.hpp>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-apps
+ * @brief Retransmission core shared by the consumers (ConsumerA, PeerConsumer, ProxyReader)
+ *
+ * The engine owns the sequence bookkeeping (retransmission queue, RTO timer, delay traces) and
+ * the send schedule. Everything that differs between consumers is supplied by @p Derived and
+ * resolved at compile time, so none of it goes through a virtual call:
+ *
+ *  - naming and push: Derived::SendPacket() builds the next Interest(s) and hands each of them
+ *    to SendInterest();
+ *  - scheduling: Derived::GetSendInterval() is the gap between two SendPacket() calls and
+ *    Derived::CanSend() (default: always) stops the schedule;
+ *  - validation: Derived::OnData() checks the content and calls AcknowledgeData() for the
+ *    sequence number it accepts.
+ *
+ * Sequence numbers are tracked per request class (a small integer chosen by Derived, e.g. file
+ * fetches vs. local_sync), and every class has its own RTT estimator and RTO, so a one-hop
+ * request does not share a timer with a multi-hop one and a seq may be in flight in several
+ * classes at once. A sequence number that needed retransmissions reports, once answered, the
+ * time since its first retransmission and whether the retransmission was spurious (the Data came
+ * back faster than half the smoothed RTT of its class, so it answered an earlier copy).
+ *
+ * All of that bookkeeping lives in one Tracking block that the first tracked Interest allocates
+ * and CheckRetxTimeout frees once nothing is in flight, so an idle consumer carries a null
+ * pointer instead of a dozen empty containers. Nonces (and the gossip draws of PeerConsumer) come
+ * from one random stream shared by all consumers of a type.
+ *
+ * A NACK for a tracked Interest is answered by the engine itself. NoRoute and Duplicate NACKs
+ * re-send the same Interest with a fresh nonce at once (up to NackRetxLimit times per sequence
+ * number), so recovery takes one RTT instead of an RTO, and the strategy of the next hop can try
+ * another upstream. Only Congestion NACKs back off: the RTO doubles and the sequence number
+ * waits for it like a lost Interest.
+ *
+ * The member definitions live in consumer-engine-impl.hpp, which only the translation unit that
+ * explicitly instantiates ConsumerEngine<Derived> includes.
+ */
+template<class Derived>
+class ConsumerEngine : public App {
+public:
+  typedef void (*LastRetransmittedInterestDataDelayCallback)(Ptr<App> app, uint32_t seqno, Time delay, int32_t hopCount);
+  typedef void (*FirstInterestDataDelayCallback)(Ptr<App> app, uint32_t seqno, Time delay, uint32_t retxCount, int32_t hopCount);
+  typedef void (*TimeoutCallback)(Ptr<App> app, uint32_t seqno);
+  typedef void (*RetransmissionRecoveredCallback)(Ptr<App> app, uint32_t seqno, Time recovery, bool spurious);
+
+  /**
+   * @brief Adds StartSeq, Prefix, LifeTime, RetxTimer, NackRetxLimit and the delay, timeout and
+   * recovery trace sources
+   */
+  static TypeId
+  AddEngineAttributes(TypeId tid);
+
+  /**
+   * @brief Adds the Frequency, Randomize and MaxSeq attributes of the *Cbr consumers
+   */
+  static TypeId
+  AddSchedulingAttributes(TypeId tid);
+
+  ConsumerEngine();
+
+  // From App
+  virtual void
+  OnNack(shared_ptr<const lp::Nack> nack);
+
+  /**
+   * @brief Timeout event
+   * @param sequenceNumber time outed sequence number
+   * @param requestClass request class it was sent in
+   */
+  void
+  OnTimeout(uint32_t sequenceNumber, uint32_t requestClass = 0);
+
+  /**
+   * @brief An event that is fired just before an Interest packet is actually send out (send is
+   *inevitable)
+   *
+   * The reason for "before" even is that in certain cases (when it is possible to satisfy from the
+   *local cache),
+   * the send call will immediately return data, and if "after" even was used, this after would be
+   *called after
+   * all processing of incoming data, potentially producing unexpected results.
+   */
+  void
+  WillSendOutInterest(uint32_t sequenceNumber, uint32_t requestClass = 0);
+
+  /**
+   * @brief Number of tracked Interests waiting for Data (the OutstandingInterests attribute)
+   */
+  uint32_t
+  GetOutstandingInterests() const
+  {
+    return m_tracking ? m_tracking->timeouts.size() : 0;
+  }
+
+protected:
+  // from App
+  virtual void
+  StartApplication();
+
+  virtual void
+  StopApplication();
+
+  /**
+   * \brief Schedules the next Derived::SendPacket() call
+   */
+  void
+  ScheduleNextPacket();
+
+  /**
+   * \brief Scheduling policy default: keep sending for the lifetime of the application
+   */
+  bool
+  CanSend() const
+  {
+    return true;
+  }
+
+  /**
+   * \brief Takes the next key waiting for retransmission (of any request class) out of the queue
+   * \return false if none is waiting
+   *
+   * The key stays tracked: the caller re-sends it with SendInterest, or drops it with StopTracking
+   * if the request became moot.
+   */
+  bool
+  PopRetxSeq(uint32_t& seq, uint32_t& requestClass);
+
+  /**
+   * \brief Whether @p seq of @p requestClass was sent and has neither been answered nor dropped,
+   * i.e. it is in flight or waiting for retransmission
+   */
+  bool
+  IsTracked(uint32_t seq, uint32_t requestClass) const
+  {
+    return m_tracking && m_tracking->seqs.count(MakeKey(seq, requestClass)) > 0;
+  }
+
+  /**
+   * \brief Sets nonce and lifetime of @p interest and sends it, tracking @p seq of @p requestClass
+   * for retransmission
+   */
+  void
+  SendInterest(const shared_ptr<Interest>& interest, uint32_t seq, uint32_t requestClass = 0);
+
+  /**
+   * \brief Like SendInterest, but without retransmission tracking, for Interests that are meant
+   * to stay pending at the producer (e.g. sync notifications) and are renewed by the schedule
+   */
+  void
+  TransmitInterest(const shared_ptr<Interest>& interest);
+
+  /**
+   * \brief Fires the delay traces for @p seq of @p requestClass, feeds the RTT estimator of the
+   * class and stops tracking it
+   */
+  void
+  AcknowledgeData(const Data& data, uint32_t seq, uint32_t requestClass = 0);
+
+  /**
+   * \brief Stops tracking @p seq of @p requestClass without an RTT sample, e.g. because the
+   * request became moot when the content arrived through another class
+   */
+  void
+  StopTracking(uint32_t seq, uint32_t requestClass);
+
+  /**
+   * \brief RTT estimator of @p requestClass, created on first use
+   */
+  Ptr<RttEstimator>
+  GetRtt(uint32_t requestClass);
+
+  /**
+   * \brief Random stream of the nonces, shared by all consumers of the type
+   */
+  static const Ptr<UniformRandomVariable>&
+  GetRand();
+
+  /**
+   * \brief Writes the sequence counter and every tracked key with its send times and counts
+   */
+  void
+  SaveEngineState(SnapshotWriter& writer) const;
+
+  /**
+   * \brief Restores what SaveEngineState() wrote
+   *
+   * The Interests of the tracked keys died with the PIT of the saving run, so all of them are
+   * queued for retransmission.
+   */
+  void
+  LoadEngineState(SnapshotReader& reader);
+
+  /**
+   * \brief Checks if the packet need to be retransmitted becuase of retransmission timer expiration
+   */
+  void
+  CheckRetxTimeout();
+
+  /**
+   * \brief Modifies the frequency of checking the retransmission timeouts
+   * \param retxTimer Timeout defining how frequent retransmission timeouts should be checked
+   */
+  void
+  SetRetxTimer(Time retxTimer);
+
+  /**
+   * \brief Returns the frequency of checking the retransmission timeouts
+   * \return Timeout defining how frequent retransmission timeouts should be checked
+   */
+  Time
+  GetRetxTimer() const;
+
+  /**
+   * @brief Set type of frequency randomization
+   * @param value Either 'none', 'uniform', or 'exponential'
+   */
+  void
+  SetRandomize(const std::string& value);
+
+  /**
+   * @brief Get type of frequency randomization
+   * @returns either 'none', 'uniform', or 'exponential'
+   */
+  std::string
+  GetRandomize() const;
+
+private:
+  Derived&
+  derived()
+  {
+    return static_cast<Derived&>(*this);
+  }
+
+  /**
+   * \brief Key of @p seq in the tracking containers: the request class in the upper 32 bits
+   */
+  static uint64_t
+  MakeKey(uint32_t seq, uint32_t requestClass)
+  {
+    return (static_cast<uint64_t>(requestClass) << 32) | seq;
+  }
+
+protected:
+  uint32_t m_seq;      ///< @brief currently requested sequence number
+  uint32_t m_seqMax;   ///< @brief maximum number of sequence number
+  EventId m_sendEvent; ///< @brief EventId of pending "send packet" event
+  Time m_retxTimer;    ///< @brief Currently estimated retransmission timer
+  EventId m_retxEvent; ///< @brief Event to check whether or not retransmission should be performed
+
+  std::vector<Ptr<RttEstimator>> m_rtts; ///< @brief RTT estimator of each request class
+
+  uint32_t m_nackRetxLimit; ///< @brief immediate re-sends of a sequence number after NACKs
+
+  Time m_offTime;              ///< \brief Time interval between packets
+  InternedName m_interestName; ///< \brief NDN Name of the Interest (use Name)
+  Time m_interestLifeTime;     ///< \brief LifeTime for interest packet
+
+  double m_frequency; // Frequency of interest packets (in hertz)
+  bool m_firstTime;
+  Ptr<RandomVariableStream> m_random; ///< \brief send time randomization, null for none
+
+  /// @cond include_hidden
+  /**
+   * \struct This struct contains sequence numbers of packets to be retransmitted
+   */
+  struct RetxSeqsContainer : public std::set<uint64_t> {
+  };
+
+  /**
+   * \brief Bookkeeping of one tracked key (MakeKey), from its first Interest until its Data
+   */
+  struct SeqState {
+    Time firstSent;                ///< \brief first Interest, for FirstInterestDataDelay
+    Time lastSent;                 ///< \brief last Interest, for LastRetransmittedInterestDataDelay
+    Time retxStart;                ///< \brief first retransmission, valid if sentCount > 1
+    uint32_t sentCount = 0;        ///< \brief Interests sent, the first one included
+    uint32_t nackRetxCount = 0;    ///< \brief immediate re-sends after NACKs
+    shared_ptr<Interest> interest; ///< \brief last Interest, null once it timed out
+  };
+
+  /**
+   * \struct This struct contains a pair of packet key (MakeKey) and its timeout
+   */
+  struct SeqTimeout {
+    SeqTimeout(uint64_t _seq, Time _time)
+      : seq(_seq)
+      , time(_time)
+    {
+    }
+
+    uint64_t seq;
+    Time time;
+  };
+  /// @endcond
+
+  /// @cond include_hidden
+  class i_seq {
+  };
+  class i_timestamp {
+  };
+  /// @endcond
+
+  /// @cond include_hidden
+  /**
+   * \struct This struct contains a multi-index for the set of SeqTimeout structs
+   */
+  struct SeqTimeoutsContainer
+    : public boost::multi_index::
+        multi_index_container<SeqTimeout,
+                              boost::multi_index::
+                                indexed_by<boost::multi_index::
+                                             ordered_unique<boost::multi_index::tag<i_seq>,
+                                                            boost::multi_index::
+                                                              member<SeqTimeout, uint64_t,
+                                                                     &SeqTimeout::seq>>,
+                                           boost::multi_index::
+                                             ordered_non_unique<boost::multi_index::
+                                                                  tag<i_timestamp>,
+                                                                boost::multi_index::
+                                                                  member<SeqTimeout, Time,
+                                                                         &SeqTimeout::time>>>> {
+  };
+
+  /**
+   * \brief Everything the engine tracks while Interests are in flight
+   */
+  struct Tracking {
+    std::map<uint64_t, SeqState> seqs; ///< \brief state of every tracked key
+    SeqTimeoutsContainer timeouts;     ///< \brief send time of the keys waiting for Data or RTO
+    RetxSeqsContainer retxSeqs;        ///< \brief ordered set of keys to be retransmitted
+  };
+  /// @endcond
+
+  /**
+   * \brief Returns m_tracking, allocating it if nothing was tracked so far
+   */
+  Tracking&
+  GetTracking()
+  {
+    if (!m_tracking)
+      m_tracking.reset(new Tracking());
+    return *m_tracking;
+  }
+
+  std::unique_ptr<Tracking> m_tracking; ///< \brief null while no Interest is tracked
+
+  /// @cond include_hidden
+
+  TracedCallback<Ptr<App> /* app */, uint32_t /* seqno */, Time /* delay */, int32_t /*hop count*/>
+    m_lastRetransmittedInterestDataDelay;
+  TracedCallback<Ptr<App> /* app */, uint32_t /* seqno */, Time /* delay */,
+                 uint32_t /*retx count*/, int32_t /*hop count*/> m_firstInterestDataDelay;
+  TracedCallback<Ptr<App> /* app */, uint32_t /* seqno */> m_timeout;
+  TracedCallback<Ptr<App> /* app */, uint32_t /* seqno */, Time /* recovery */, bool /* spurious */>
+    m_retransmissionRecovered;
+
+  /// @endcond
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif
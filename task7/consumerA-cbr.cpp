@@ -19,15 +19,7 @@
 
 #include "consumerA-cbr.hpp"
 #include "ns3/ptr.h"
-#include "ns3/log.h"
-#include "ns3/simulator.h"
-#include "ns3/packet.h"
-#include "ns3/callback.h"
-#include "ns3/string.h"
-#include "ns3/boolean.h"
-#include "ns3/uinteger.h"
-#include "ns3/integer.h"
-#include "ns3/double.h"
+#include "ndn-app-log.hpp"
 
 NS_LOG_COMPONENT_DEFINE("ndn.ConsumerACbr");
 
@@ -40,79 +32,22 @@ TypeId
 ConsumerACbr::GetTypeId(void)
 {
   static TypeId tid =
-    TypeId("ns3::ndn::ConsumerACbr")
-      .SetGroupName("Ndn")
-      .SetParent<ConsumerA>()
-      .AddConstructor<ConsumerACbr>()
-
-      .AddAttribute("Frequency", "Frequency of interest packets", StringValue("1.0"),
-                    MakeDoubleAccessor(&ConsumerACbr::m_frequency), MakeDoubleChecker<double>())
-
-      .AddAttribute("Randomize",
-                    "Type of send time randomization: none (default), uniform, exponential",
-                    StringValue("none"),
-                    MakeStringAccessor(&ConsumerACbr::SetRandomize, &ConsumerACbr::GetRandomize),
-                    MakeStringChecker())
-
-      .AddAttribute("MaxSeq", "Maximum sequence number to request",
-                    IntegerValue(std::numeric_limits<uint32_t>::max()),
-                    MakeIntegerAccessor(&ConsumerACbr::m_seqMax), MakeIntegerChecker<uint32_t>())
-
-    ;
+    AddSchedulingAttributes(TypeId("ns3::ndn::ConsumerACbr")
+                              .SetGroupName("Ndn")
+                              .SetParent<ConsumerA>()
+                              .AddConstructor<ConsumerACbr>());
 
   return tid;
 }
 
 ConsumerACbr::ConsumerACbr()
-  : m_frequency(1.0)
-  , m_firstTime(true)
 {
-  NS_LOG_FUNCTION_NOARGS();
-  m_seqMax = std::numeric_limits<uint32_t>::max();
+  NDN_APP_LOG_FUNCTION_NOARGS();
 }
 
 ConsumerACbr::~ConsumerACbr()
 {
 }
 
-void
-ConsumerACbr::ScheduleNextPacket()
-{
-  // double mean = 8.0 * m_payloadSize / m_desiredRate.GetBitRate ();
-  // std::cout << "next: " << Simulator::Now().ToDouble(Time::S) + mean << "s\n";
-
-  if (m_firstTime) {
-    m_sendEvent = Simulator::Schedule(Seconds(0.0), &ConsumerA::SendPacket, this);
-    m_firstTime = false;
-  }
-  else if (!m_sendEvent.IsRunning())
-    m_sendEvent = Simulator::Schedule(Seconds(0.01),&ConsumerA::SendPacket, this);
-}
-
-void
-ConsumerACbr::SetRandomize(const std::string& value)
-{
-  if (value == "uniform") {
-    m_random = CreateObject<UniformRandomVariable>();
-    m_random->SetAttribute("Min", DoubleValue(0.0));
-    m_random->SetAttribute("Max", DoubleValue(2 * 1.0 / m_frequency));
-  }
-  else if (value == "exponential") {
-    m_random = CreateObject<ExponentialRandomVariable>();
-    m_random->SetAttribute("Mean", DoubleValue(1.0 / m_frequency));
-    m_random->SetAttribute("Bound", DoubleValue(50 * 1.0 / m_frequency));
-  }
-  else
-    m_random = 0;
-
-  m_randomType = value;
-}
-
-std::string
-ConsumerACbr::GetRandomize() const
-{
-  return m_randomType;
-}
-
 } // namespace ndn
 } // namespace ns3
@@ -30,6 +30,9 @@ namespace ndn {
 /**
  * @ingroup ndn-apps
  * @brief Ndn application for sending out Interest packets at a "constant" rate (Poisson process)
+ *
+ * Registers the scheduling attributes of the engine; the send schedule itself is the
+ * GetSendInterval/CanSend policy of ConsumerA.
  */
 class ConsumerACbr : public ConsumerA {
 public:
@@ -42,34 +45,6 @@ public:
    */
   ConsumerACbr();
   virtual ~ConsumerACbr();
-
-protected:
-  /**
-   * \brief Constructs the Interest packet and sends it using a callback to the underlying NDN
-   * protocol
-   */
-  virtual void
-  ScheduleNextPacket();
-
-  /**
-   * @brief Set type of frequency randomization
-   * @param value Either 'none', 'uniform', or 'exponential'
-   */
-  void
-  SetRandomize(const std::string& value);
-
-  /**
-   * @brief Get type of frequency randomization
-   * @returns either 'none', 'uniform', or 'exponential'
-   */
-  std::string
-  GetRandomize() const;
-
-protected:
-  double m_frequency; // Frequency of interest packets (in hertz)
-  bool m_firstTime;
-  Ptr<RandomVariableStream> m_random;
-  std::string m_randomType;
 };
 
 } // namespace ndn
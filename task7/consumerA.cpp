@@ -19,7 +19,8 @@
 
 #include "consumerA.hpp"
 #include "ns3/ptr.h"
-#include "ns3/log.h"
+#include "ndn-app-log.hpp"
+#include "ndn-app-profile.hpp"
 #include "ns3/simulator.h"
 #include "ns3/packet.h"
 #include "ns3/callback.h"
@@ -30,130 +31,49 @@
 #include "ns3/double.h"
 
 #include "utils/ndn-ns3-packet-tag.hpp"
-#include "utils/ndn-rtt-mean-deviation.hpp"
-
-#include <ndn-cxx/lp/tags.hpp>
 
 #include <boost/lexical_cast.hpp>
 #include <boost/ref.hpp>
 
 NS_LOG_COMPONENT_DEFINE("ndn.ConsumerA");
 
+// after the log component: the engine logs through this unit's g_log
+#include "consumer-engine-impl.hpp"
+
 namespace ns3 {
 namespace ndn {
 
+template class ConsumerEngine<ConsumerA>;
+
 NS_OBJECT_ENSURE_REGISTERED(ConsumerA);
 
 TypeId
 ConsumerA::GetTypeId(void)
 {
   static TypeId tid =
-    TypeId("ns3::ndn::ConsumerA")
-      .SetGroupName("Ndn")
-      .SetParent<App>()
-      .AddAttribute("StartSeq", "Initial sequence number", IntegerValue(0),
-                    MakeIntegerAccessor(&ConsumerA::m_seq), MakeIntegerChecker<int32_t>())
-
-      .AddAttribute("Prefix", "Name of the Interest", StringValue("/"),
-                    MakeNameAccessor(&ConsumerA::m_interestName), MakeNameChecker())
-      .AddAttribute("LifeTime", "LifeTime for interest packet", StringValue("2s"),
-                    MakeTimeAccessor(&ConsumerA::m_interestLifeTime), MakeTimeChecker())
-
-      .AddAttribute("RetxTimer",
-                    "Timeout defining how frequent retransmission timeouts should be checked",
-                    StringValue("50ms"),
-                    MakeTimeAccessor(&ConsumerA::GetRetxTimer, &ConsumerA::SetRetxTimer),
-                    MakeTimeChecker())
-
-      .AddTraceSource("LastRetransmittedInterestDataDelay",
-                      "Delay between last retransmitted Interest and received Data",
-                      MakeTraceSourceAccessor(&ConsumerA::m_lastRetransmittedInterestDataDelay),
-                      "ns3::ndn::ConsumerA::LastRetransmittedInterestDataDelayCallback")
-
-      .AddTraceSource("FirstInterestDataDelay",
-                      "Delay between first transmitted Interest and received Data",
-                      MakeTraceSourceAccessor(&ConsumerA::m_firstInterestDataDelay),
-                      "ns3::ndn::ConsumerA::FirstInterestDataDelayCallback");
+    AddEngineAttributes(TypeId("ns3::ndn::ConsumerA")
+                          .SetGroupName("Ndn")
+                          .SetParent<App>())
+      .AddAttribute("Notify", "Keep a sync Interest pending at ProducerA instead of polling",
+                    BooleanValue(false), MakeBooleanAccessor(&ConsumerA::m_notify),
+                    MakeBooleanChecker())
 
-  return tid;
-}
+      .AddTraceSource("SyncRequested", "A sync Interest (poll or notification) was sent",
+                      MakeTraceSourceAccessor(&ConsumerA::m_syncRequested),
+                      "ns3::ndn::ConsumerA::SyncCallback")
 
-ConsumerA::ConsumerA()
-  : m_rand(CreateObject<UniformRandomVariable>())
-  , m_seq(0)
-  , m_seqMax(0)
-  , m_Sync(false)
-{
-  NS_LOG_FUNCTION_NOARGS();
-
-  m_rtt = CreateObject<RttMeanDeviation>();
-}
-
-void
-ConsumerA::SetRetxTimer(Time retxTimer)
-{
-  m_retxTimer = retxTimer;
-  if (m_retxEvent.IsRunning()) {
-    // m_retxEvent.Cancel (); // cancel any scheduled cleanup events
-    Simulator::Remove(m_retxEvent); // slower, but better for memory
-  }
-
-  // schedule even with new timeout
-  m_retxEvent = Simulator::Schedule(m_retxTimer, &ConsumerA::CheckRetxTimeout, this);
-}
-
-Time
-ConsumerA::GetRetxTimer() const
-{
-  return m_retxTimer;
-}
-
-void
-ConsumerA::CheckRetxTimeout()
-{
-  Time now = Simulator::Now();
-
-  Time rto = m_rtt->RetransmitTimeout();
-  // NS_LOG_DEBUG ("Current RTO: " << rto.ToDouble (Time::S) << "s");
-
-  while (!m_seqTimeouts.empty()) {
-    SeqTimeoutsContainer::index<i_timestamp>::type::iterator entry =
-      m_seqTimeouts.get<i_timestamp>().begin();
-    if (entry->time + rto <= now) // timeout expired?
-    {
-      uint32_t seqNo = entry->seq;
-      m_seqTimeouts.get<i_timestamp>().erase(entry);
-      OnTimeout(seqNo);
-    }
-    else
-      break; // nothing else to do. All later packets need not be retransmitted
-  }
-
-  m_retxEvent = Simulator::Schedule(m_retxTimer, &ConsumerA::CheckRetxTimeout, this);
-}
+      .AddTraceSource("FilePushed", "The original of a flagged file was pushed to its peer",
+                      MakeTraceSourceAccessor(&ConsumerA::m_filePushed),
+                      "ns3::ndn::ConsumerA::SyncCallback");
 
-// Application Methods
-void
-ConsumerA::StartApplication() // Called at time specified by Start
-{
-  NS_LOG_FUNCTION_NOARGS();
-
-  // do base stuff
-  App::StartApplication();
-
-  ScheduleNextPacket();
+  return tid;
 }
 
-void
-ConsumerA::StopApplication() // Called at time specified by Stop
+ConsumerA::ConsumerA()
+  : m_Sync(false)
+  , m_notify(false)
 {
-  NS_LOG_FUNCTION_NOARGS();
-
-  // cancel periodic packet generation
-  Simulator::Cancel(m_sendEvent);
-
-  // cleanup base stuff
-  App::StopApplication();
+  NDN_APP_LOG_FUNCTION_NOARGS();
 }
 
 void
@@ -162,67 +82,19 @@ ConsumerA::SendPacket()
   if (!m_active)
     return;
 
-  NS_LOG_FUNCTION_NOARGS();
-
-  uint32_t seq = std::numeric_limits<uint32_t>::max(); // invalid
-
-  while (m_retxSeqs.size()) {
-    seq = *m_retxSeqs.begin();
-    m_retxSeqs.erase(m_retxSeqs.begin());
-    break;
-  }
-
-  if (seq == std::numeric_limits<uint32_t>::max()) {
-    if (m_seqMax != std::numeric_limits<uint32_t>::max()) {
-      if (m_seq >= m_seqMax) {
-        return; // we are totally done
-      }
-    }
-
-    seq = m_seq++;
-  }
-
+  NDN_APP_PROFILE("SendPacket");
 
-  shared_ptr<Interest> interest = make_shared<Interest>();
+  NDN_APP_LOG_FUNCTION_NOARGS();
 
-  if(!m_Sync)
+  // /prefix/peer/<peer>/<file>, OnData only takes sync replies that end in a file number
+  uint32_t file_number = 0;
+  if(m_Sync && names::ParseFileId(m_sendPeerName.at(-1), file_number))
   {
-	  shared_ptr<Name> nameWithSequence = make_shared<Name>(m_interestName);
-	  nameWithSequence->appendSequenceNumber(seq);
-
-	  interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
-	  interest->setName(*nameWithSequence);
-	  interest->setCanBePrefix(false);
-	  time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
-	  interest->setInterestLifetime(interestLifeTime);
+	  shared_ptr<Interest> interest = make_shared<Interest>();
 
-	  NS_LOG_INFO("> Interest for " << *nameWithSequence);
+	  interest->setName(m_sendPeerName);
 
-	  WillSendOutInterest(seq);
-
-	  m_transmittedInterests(interest, this, m_face);
-	  m_appLink->onReceiveInterest(*interest);
-
-	  ScheduleNextPacket();
-
-  }
-
-
-  if(m_Sync)
-  {
-
-	  shared_ptr<Name> nameWithSequence = make_shared<Name>(m_sendPeerName);
-
-	  //shared_ptr<Interest> interest = make_shared<Interest>();
-	  interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
-	  interest->setName(*nameWithSequence);
-	  interest->setCanBePrefix(false);
-	  time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
-	  interest->setInterestLifetime(interestLifeTime);
-
-	  uint32_t file_number = std::strtoul(m_sendPeerName.getSubName(3,2).toUri().substr(1,3).c_str(), nullptr,10);
-
-	  NS_LOG_INFO("File Number in ConsumerA = "<< file_number);
+	  NDN_APP_LOG_INFO("File Number in ConsumerA = "<< file_number);
 	  std::stringstream temp_Parameter;
 	  if(file_number < 10)
 	  {
@@ -241,15 +113,43 @@ ConsumerA::SendPacket()
 	  m_Sync = false;
 	  interest->setParameters(make_shared< ::ndn::Buffer>(buf,buf_size));
 
-	  NS_LOG_INFO("> Interest for " << *nameWithSequence);
+	  // nothing answers a push: tracked, it would time out and inflate the RTO of the polls
+	  TransmitInterest(interest);
+	  m_filePushed(this, file_number);
+
+	  // a poll goes out on the next tick, a notification must be pending again right away
+	  if(!m_notify)
+		  return;
+  }
 
-	  WillSendOutInterest(file_number);
+  // notifications and pushes are untracked, so only polls are ever retransmitted; a poll is
+  // taken only here, after the push, so that a popped one is always re-sent
+  uint32_t seq = 0;
+  uint32_t requestClass = 0;
 
-	  m_transmittedInterests(interest, this, m_face);
-	  m_appLink->onReceiveInterest(*interest);
+  if (!PopRetxSeq(seq, requestClass)) {
+    if (m_seqMax != std::numeric_limits<uint32_t>::max()) {
+      if (m_seq >= m_seqMax) {
+        return; // we are totally done
+      }
+    }
 
-	  ScheduleNextPacket();
+    seq = m_seq++;
   }
+
+  shared_ptr<Interest> interest = make_shared<Interest>();
+  Name nameWithSequence(m_interestName.Get());
+  if(m_notify)
+	  nameWithSequence.append(names::Notify());
+  nameWithSequence.appendSequenceNumber(seq);
+
+  interest->setName(nameWithSequence);
+
+  m_syncRequested(this, seq);
+  if(m_notify)
+	  TransmitInterest(interest); // stays pending at ProducerA until a file is flagged
+  else
+	  SendInterest(interest, seq);
 }
 
 ///////////////////////////////////////////////////
@@ -262,95 +162,71 @@ ConsumerA::OnData(shared_ptr<const Data> data)
   if (!m_active)
     return;
 
+  NDN_APP_PROFILE("OnData");
+
   App::OnData(data); // tracing inside
 
-  NS_LOG_FUNCTION(this << data);
+  NDN_APP_LOG_FUNCTION(this << data);
 
   Block contentBlock = data->getContent();
-  std::string content = std::string((char*)contentBlock.value());
+  std::string content(reinterpret_cast<const char*>(contentBlock.value()), contentBlock.value_size());
 
-  NS_LOG_INFO("content = "<< content);
+  NDN_APP_LOG_INFO("content = "<< content);
   if(content.substr(0,3) == "All")
   {
-	  NS_LOG_INFO("All Synced");
+	  NDN_APP_LOG_INFO("All Synced");
 	  m_Sync = false;
   }
 
   else
   {
-	  m_Sync = true;
-	  m_sendPeerName = content.substr(0,21) ;
-	  NS_LOG_INFO("ConsumerA m_sendPeerName = "<< m_sendPeerName);
+	  // the URI of /prefix/peer/<peer>/<file>, see ProducerA::TakeSyncContent()
+	  Name peerName(content);
+	  uint32_t file_number = 0;
+	  if(!names::PrefixPeer().isPrefixOf(peerName) || !names::ParseFileId(peerName.at(-1), file_number))
+	  {
+		  NDN_APP_LOG_INFO("No file number in sync reply " << content << ", nothing pushed");
+	  }
+	  else
+	  {
+		  m_Sync = true;
+		  m_sendPeerName = peerName;
+		  NDN_APP_LOG_INFO("ConsumerA m_sendPeerName = "<< m_sendPeerName);
+
+		  if(m_notify)
+		  {
+			  // push now and put a new notification in place instead of waiting for the renewal
+			  Simulator::Cancel(m_sendEvent);
+			  m_sendEvent = Simulator::ScheduleNow(&ConsumerA::SendPacket, this);
+		  }
+	  }
   }
   uint32_t seq = data->getName().at(-1).toSequenceNumber();
-  NS_LOG_INFO("< DATA for " << data->getName());
-
-  int hopCount = 0;
-  auto hopCountTag = data->getTag<lp::HopCountTag>();
-  if (hopCountTag != nullptr) { // e.g., packet came from local node's cache
-    hopCount = *hopCountTag;
-  }
-  NS_LOG_DEBUG("Hop count: " << hopCount);
-
-  SeqTimeoutsContainer::iterator entry = m_seqLastDelay.find(seq);
-  if (entry != m_seqLastDelay.end()) {
-    m_lastRetransmittedInterestDataDelay(this, seq, Simulator::Now() - entry->time, hopCount);
-  }
-
-  entry = m_seqFullDelay.find(seq);
-  if (entry != m_seqFullDelay.end()) {
-    m_firstInterestDataDelay(this, seq, Simulator::Now() - entry->time, m_seqRetxCounts[seq], hopCount);
-  }
+  NDN_APP_LOG_INFO("< DATA for " << data->getName());
 
-  m_seqRetxCounts.erase(seq);
-  m_seqFullDelay.erase(seq);
-  m_seqLastDelay.erase(seq);
-
-  m_seqTimeouts.erase(seq);
-  m_retxSeqs.erase(seq);
-
-  m_rtt->AckSeq(SequenceNumber32(seq));
+  AcknowledgeData(*data, seq);
 }
 
-void
-ConsumerA::OnNack(shared_ptr<const lp::Nack> nack)
-{
-  /// tracing inside
-  App::OnNack(nack);
-
-  NS_LOG_INFO("NACK received for: " << nack->getInterest().getName()
-              << ", reason: " << nack->getReason());
-}
+///////////////////////////////////////////////////
+//          Snapshot                             //
+///////////////////////////////////////////////////
 
 void
-ConsumerA::OnTimeout(uint32_t sequenceNumber)
+ConsumerA::SaveState(SnapshotWriter& writer) const
 {
-  NS_LOG_FUNCTION(sequenceNumber);
-  // std::cout << Simulator::Now () << ", TO: " << sequenceNumber << ", current RTO: " <<
-  // m_rtt->RetransmitTimeout ().ToDouble (Time::S) << "s\n";
-
-  m_rtt->IncreaseMultiplier(); // Double the next RTO
-  m_rtt->SentSeq(SequenceNumber32(sequenceNumber),
-                 1); // make sure to disable RTT calculation for this sample
-  m_retxSeqs.insert(sequenceNumber);
-  ScheduleNextPacket();
+  SaveEngineState(writer);
+
+  writer.Put(m_Sync);
+  writer.Put(m_sendPeerName);
 }
 
 void
-ConsumerA::WillSendOutInterest(uint32_t sequenceNumber)
+ConsumerA::LoadState(SnapshotReader& reader)
 {
-  NS_LOG_DEBUG("Trying to add " << sequenceNumber << " with " << Simulator::Now() << ". already "
-                                << m_seqTimeouts.size() << " items");
-
-  m_seqTimeouts.insert(SeqTimeout(sequenceNumber, Simulator::Now()));
-  m_seqFullDelay.insert(SeqTimeout(sequenceNumber, Simulator::Now()));
-
-  m_seqLastDelay.erase(sequenceNumber);
-  m_seqLastDelay.insert(SeqTimeout(sequenceNumber, Simulator::Now()));
-
-  m_seqRetxCounts[sequenceNumber]++;
+  LoadEngineState(reader);
 
-  m_rtt->SentSeq(SequenceNumber32(sequenceNumber), 1);
+  reader.Get(m_Sync);
+  reader.Get(m_sendPeerName);
 }
 
 } // namespace ndn
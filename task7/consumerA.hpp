@@ -22,22 +22,7 @@
 
 #include "ns3/ndnSIM/model/ndn-common.hpp"
 
-#include "ndn-app.hpp"
-
-#include "ns3/random-variable-stream.h"
-#include "ns3/nstime.h"
-#include "ns3/data-rate.h"
-
-#include "ns3/ndnSIM/model/ndn-common.hpp"
-#include "ns3/ndnSIM/utils/ndn-rtt-estimator.hpp"
-
-#include <set>
-#include <map>
-
-#include <boost/multi_index_container.hpp>
-#include <boost/multi_index/tag.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-#include <boost/multi_index/member.hpp>
+#include "consumer-engine.hpp"
 
 namespace ns3 {
 namespace ndn {
@@ -45,8 +30,15 @@ namespace ndn {
 /**
  * @ingroup ndn-apps
  * \brief NDN application for sending out Interest packets
+ *
+ * Requests <Prefix>/<seq> (/prefix/file/sync/<seq> in the scenarios) and, once ProducerA reports
+ * an unsynced file, pushes the original data packet of that file to the peer named in the reply.
+ *
+ * With Notify set, the sync Interest (<Prefix>/notify/<seq>, i.e. /prefix/file/sync/notify/<seq>)
+ * is not a poll: ProducerA holds it until a file is flagged, and the consumer only renews it every
+ * LifeTime.
  */
-class ConsumerA : public App {
+class ConsumerA : public ConsumerEngine<ConsumerA>, public SnapshotState {
 public:
   static TypeId
   GetTypeId();
@@ -62,16 +54,12 @@ public:
   virtual void
   OnData(shared_ptr<const Data> contentObject);
 
-  // From App
+  // From SnapshotState
   virtual void
-  OnNack(shared_ptr<const lp::Nack> nack);
+  SaveState(SnapshotWriter& writer) const;
 
-  /**
-   * @brief Timeout event
-   * @param sequenceNumber time outed sequence number
-   */
   virtual void
-  OnTimeout(uint32_t sequenceNumber);
+  LoadState(SnapshotReader& reader);
 
   /**
    * @brief Actually send packet
@@ -79,141 +67,32 @@ public:
   void
   SendPacket();
 
-  /**
-   * @brief An event that is fired just before an Interest packet is actually send out (send is
-   *inevitable)
-   *
-   * The reason for "before" even is that in certain cases (when it is possible to satisfy from the
-   *local cache),
-   * the send call will immediately return data, and if "after" even was used, this after would be
-   *called after
-   * all processing of incoming data, potentially producing unexpected results.
-   */
-  virtual void
-  WillSendOutInterest(uint32_t sequenceNumber);
-
 public:
-  typedef void (*LastRetransmittedInterestDataDelayCallback)(Ptr<App> app, uint32_t seqno, Time delay, int32_t hopCount);
-  typedef void (*FirstInterestDataDelayCallback)(Ptr<App> app, uint32_t seqno, Time delay, uint32_t retxCount, int32_t hopCount);
+  typedef void (*SyncCallback)(Ptr<App> app, uint32_t seqno);
 
 protected:
-  // from App
-  virtual void
-  StartApplication();
-
-  virtual void
-  StopApplication();
-
-  /**
-   * \brief Constructs the Interest packet and sends it using a callback to the underlying NDN
-   * protocol
-   */
-  virtual void
-  ScheduleNextPacket() = 0;
+  friend class ConsumerEngine<ConsumerA>;
 
   /**
-   * \brief Checks if the packet need to be retransmitted becuase of retransmission timer expiration
-   */
-  void
-  CheckRetxTimeout();
-
-  /**
-   * \brief Modifies the frequency of checking the retransmission timeouts
-   * \param retxTimer Timeout defining how frequent retransmission timeouts should be checked
-   */
-  void
-  SetRetxTimer(Time retxTimer);
-
-  /**
-   * \brief Returns the frequency of checking the retransmission timeouts
-   * \return Timeout defining how frequent retransmission timeouts should be checked
+   * \brief Scheduling policy: gap between two SendPacket calls
    */
   Time
-  GetRetxTimer() const;
+  GetSendInterval() const
+  {
+    return m_notify ? m_interestLifeTime : Seconds(0.01);
+  }
 
 protected:
-  Ptr<UniformRandomVariable> m_rand; ///< @brief nonce generator
-
-  uint32_t m_seq;      ///< @brief currently requested sequence number
-  uint32_t m_seqMax;   ///< @brief maximum number of sequence number
-  EventId m_sendEvent; ///< @brief EventId of pending "send packet" event
-  Time m_retxTimer;    ///< @brief Currently estimated retransmission timer
-  EventId m_retxEvent; ///< @brief Event to check whether or not retransmission should be performed
-
-  Ptr<RttEstimator> m_rtt; ///< @brief RTT estimator
-
-  Time m_offTime;          ///< \brief Time interval between packets
-  Name m_interestName;     ///< \brief NDN Name of the Interest (use Name)
-  Time m_interestLifeTime; ///< \brief LifeTime for interest packet
   bool m_Sync;
   Name m_sendPeerName;
+  bool m_notify; ///< @brief hold sync Interests at ProducerA instead of polling
 
-  /// @cond include_hidden
-  /**
-   * \struct This struct contains sequence numbers of packets to be retransmitted
-   */
-  struct RetxSeqsContainer : public std::set<uint32_t> {
-  };
-
-  RetxSeqsContainer m_retxSeqs; ///< \brief ordered set of sequence numbers to be retransmitted
-
-  /**
-   * \struct This struct contains a pair of packet sequence number and its timeout
-   */
-  struct SeqTimeout {
-    SeqTimeout(uint32_t _seq, Time _time)
-      : seq(_seq)
-      , time(_time)
-    {
-    }
-
-    uint32_t seq;
-    Time time;
-  };
-  /// @endcond
-
-  /// @cond include_hidden
-  class i_seq {
-  };
-  class i_timestamp {
-  };
-  /// @endcond
-
-  /// @cond include_hidden
-  /**
-   * \struct This struct contains a multi-index for the set of SeqTimeout structs
-   */
-  struct SeqTimeoutsContainer
-    : public boost::multi_index::
-        multi_index_container<SeqTimeout,
-                              boost::multi_index::
-                                indexed_by<boost::multi_index::
-                                             ordered_unique<boost::multi_index::tag<i_seq>,
-                                                            boost::multi_index::
-                                                              member<SeqTimeout, uint32_t,
-                                                                     &SeqTimeout::seq>>,
-                                           boost::multi_index::
-                                             ordered_non_unique<boost::multi_index::
-                                                                  tag<i_timestamp>,
-                                                                boost::multi_index::
-                                                                  member<SeqTimeout, Time,
-                                                                         &SeqTimeout::time>>>> {
-  };
-
-  SeqTimeoutsContainer m_seqTimeouts; ///< \brief multi-index for the set of SeqTimeout structs
-
-  SeqTimeoutsContainer m_seqLastDelay;
-  SeqTimeoutsContainer m_seqFullDelay;
-  std::map<uint32_t, uint32_t> m_seqRetxCounts;
-
-  TracedCallback<Ptr<App> /* app */, uint32_t /* seqno */, Time /* delay */, int32_t /*hop count*/>
-    m_lastRetransmittedInterestDataDelay;
-  TracedCallback<Ptr<App> /* app */, uint32_t /* seqno */, Time /* delay */,
-                 uint32_t /*retx count*/, int32_t /*hop count*/> m_firstInterestDataDelay;
-
-  /// @endcond
+  TracedCallback<Ptr<App> /* app */, uint32_t /* seqno */> m_syncRequested;
+  TracedCallback<Ptr<App> /* app */, uint32_t /* file */> m_filePushed;
 };
 
+extern template class ConsumerEngine<ConsumerA>;
+
 } // namespace ndn
 } // namespace ns3
 
@@ -0,0 +1,116 @@
+#ifndef NDN_CS_ADMISSION_H
+#define NDN_CS_ADMISSION_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/model/cs/ndn-content-store.hpp"
+
+#include "ns3/ptr.h"
+#include "ns3/traced-callback.h"
+
+#include <string>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-cs
+ * @brief Content store that decides what is cached before handing it to an ndnSIM policy
+ *
+ * Wraps one store of the Policy type (ns3::ndn::cs::Lru, Lfu, Fifo or Random) with MaxSize
+ * entries. On top of it:
+ *
+ * - Data whose KeyLocator is not TrustedKeyLocator are not admitted, so the unsigned bogus Data
+ *   of a censor never get cached and every retransmission of a censored name reaches ProducerA
+ *   again (the "requested three times" flagging depends on it). Empty admits everything.
+ * - Names under BypassPrefixes (e.g. the unique /prefix/file/sync polls) are neither looked up
+ *   nor cached, so they cannot push useful entries out.
+ * - With PrioritySize > 0, Data under PriorityPrefixes go to a second store of that size, so
+ *   ordinary traffic cannot evict them.
+ *
+ * Hits and misses are reported through the CacheHits/CacheMisses traces of ContentStore (which
+ * CsTracer and MetricsCollector use), refused Data through CacheRejected.
+ */
+class AdmissionContentStore : public ContentStore {
+public:
+  static TypeId
+  GetTypeId();
+
+  AdmissionContentStore();
+
+  virtual shared_ptr<Data>
+  Lookup(shared_ptr<const Interest> interest);
+
+  virtual bool
+  Add(shared_ptr<const Data> data);
+
+  virtual void
+  Print(std::ostream& os) const;
+
+  virtual uint32_t
+  GetSize() const;
+
+  /**
+   * @brief Iterates the entries of the main store only
+   */
+  virtual Ptr<cs::Entry>
+  Begin();
+
+  virtual Ptr<cs::Entry>
+  End();
+
+  virtual Ptr<cs::Entry>
+  Next(Ptr<cs::Entry> entry);
+
+  /**
+   * @brief Whether @p data carries the trusted KeyLocator (always true if none is set)
+   */
+  bool
+  IsAdmitted(const Data& data) const;
+
+private:
+  /**
+   * @brief Store that holds @p name, created on first use; 0 for bypassed names
+   */
+  Ptr<ContentStore>
+  GetStore(const Name& name);
+
+  void
+  SetPriorityPrefixes(const std::string& prefixes);
+
+  std::string
+  GetPriorityPrefixes() const;
+
+  void
+  SetBypassPrefixes(const std::string& prefixes);
+
+  std::string
+  GetBypassPrefixes() const;
+
+  static std::vector<Name>
+  ParsePrefixes(const std::string& prefixes);
+
+  static std::string
+  FormatPrefixes(const std::vector<Name>& prefixes);
+
+  static bool
+  HasPrefix(const std::vector<Name>& prefixes, const Name& name);
+
+private:
+  std::string m_policy;
+  uint32_t m_maxSize;
+  std::vector<Name> m_priorityPrefixes;
+  uint32_t m_prioritySize;
+  std::vector<Name> m_bypassPrefixes;
+  Name m_trustedKeyLocator;
+
+  Ptr<ContentStore> m_store;
+  Ptr<ContentStore> m_priorityStore;
+
+  TracedCallback<shared_ptr<const Data>> m_cacheRejectedTrace;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_CS_ADMISSION_H
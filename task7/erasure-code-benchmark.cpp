@@ -0,0 +1,70 @@
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM/apps/erasure-code.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+// Encode and decode throughput of the k-of-n code the PeerConsumer uses to spread a file over
+// the proxies. Decoding drops the first n-k data blocks, so it always inverts the largest matrix
+// and uses as many parity blocks as possible (the worst case); the data-blocks-only case is a
+// copy and not measured.
+int
+main(int argc, char* argv[])
+{
+  uint32_t k = 2;
+  uint32_t n = 3;
+  uint32_t fileSize = 1024 * 1024;
+  uint32_t iterations = 100;
+
+  CommandLine cmd;
+  cmd.AddValue("k", "Blocks needed to rebuild a file", k);
+  cmd.AddValue("n", "Blocks per file", n);
+  cmd.AddValue("fileSize", "Bytes per file", fileSize);
+  cmd.AddValue("iterations", "Files encoded and decoded", iterations);
+  cmd.Parse(argc, argv);
+
+  ndn::ErasureCode code(k, n);
+
+  std::string file(fileSize, '\0');
+  for (uint32_t i = 0; i < fileSize; i++)
+    file[i] = static_cast<char>(i * 131 + 7);
+
+  std::vector<std::string> blocks;
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < iterations; i++)
+    blocks = code.Encode(file);
+  double encode = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::map<uint32_t, std::string> received;
+  for (uint32_t i = n - k; i < n; i++)
+    received[i] = blocks[i];
+
+  std::string decoded;
+  uint32_t failures = 0;
+  start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < iterations; i++)
+    failures += !code.Decode(received, decoded) || decoded != file;
+  double decode = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  double megabytes = static_cast<double>(fileSize) * iterations / (1024 * 1024);
+  std::cout << "k: " << k << ", n: " << n << ", file: " << fileSize << " bytes, block: "
+            << blocks.front().size() << " bytes\n"
+            << "encode: " << megabytes / encode << " MB/s\n"
+            << "decode (" << (n - k < k ? n - k : k) << " parity blocks): " << megabytes / decode
+            << " MB/s, failures: " << failures << "\n";
+
+  return 0;
+}
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+  return ns3::main(argc, argv);
+}
@@ -0,0 +1,229 @@
+#include "erasure-code.hpp"
+
+#include "ns3/abort.h"
+
+#include <cstring>
+#include <utility>
+
+namespace ns3 {
+namespace ndn {
+
+namespace {
+
+/**
+ * @brief Product table of GF(2^8) with the polynomial x^8 + x^4 + x^3 + x^2 + 1 (0x11d)
+ */
+struct GaloisTables {
+  uint8_t mul[256][256];
+  uint8_t inv[256];
+
+  GaloisTables()
+  {
+    uint8_t exp[255];
+    uint8_t log[256] = {0};
+    uint32_t x = 1;
+    for (uint32_t i = 0; i < 255; i++) {
+      exp[i] = static_cast<uint8_t>(x);
+      log[x] = static_cast<uint8_t>(i);
+      x <<= 1;
+      if (x & 0x100)
+        x ^= 0x11d;
+    }
+
+    for (uint32_t a = 0; a < 256; a++) {
+      for (uint32_t b = 0; b < 256; b++)
+        mul[a][b] = (a == 0 || b == 0) ? 0 : exp[(log[a] + log[b]) % 255];
+      inv[a] = (a == 0) ? 0 : exp[(255 - log[a]) % 255];
+    }
+  }
+};
+
+const GaloisTables&
+GetTables()
+{
+  static const GaloisTables tables;
+  return tables;
+}
+
+const size_t LENGTH_HEADER = 4;
+
+} // namespace
+
+ErasureCode::ErasureCode(uint32_t k, uint32_t n)
+  : m_k(k)
+  , m_n(n)
+{
+  NS_ABORT_MSG_IF(k == 0 || k > n || n > 256, "ErasureCode needs 1 <= k <= n <= 256");
+
+  // a_ij = 1 / (x_i + y_j) with x_i = k + i and y_j = j: all x and y are distinct, so every
+  // square submatrix of [I; A] is invertible
+  m_parity.resize((n - k) * k);
+  for (uint32_t i = 0; i < n - k; i++) {
+    for (uint32_t j = 0; j < k; j++)
+      m_parity[i * k + j] = Inverse(static_cast<uint8_t>((k + i) ^ j));
+  }
+}
+
+uint8_t
+ErasureCode::Multiply(uint8_t a, uint8_t b)
+{
+  return GetTables().mul[a][b];
+}
+
+uint8_t
+ErasureCode::Inverse(uint8_t a)
+{
+  return GetTables().inv[a];
+}
+
+void
+ErasureCode::MultiplyAdd(uint8_t* dst, const uint8_t* src, uint8_t c, size_t size)
+{
+  if (c == 0)
+    return;
+
+  if (c == 1) {
+    for (size_t i = 0; i < size; i++)
+      dst[i] ^= src[i];
+    return;
+  }
+
+  const uint8_t* row = GetTables().mul[c];
+  for (size_t i = 0; i < size; i++)
+    dst[i] ^= row[src[i]];
+}
+
+std::vector<uint8_t>
+ErasureCode::GetRow(uint32_t index) const
+{
+  std::vector<uint8_t> row(m_k, 0);
+  if (index < m_k)
+    row[index] = 1;
+  else
+    std::memcpy(row.data(), &m_parity[(index - m_k) * m_k], m_k);
+  return row;
+}
+
+bool
+ErasureCode::Invert(std::vector<uint8_t>& matrix) const
+{
+  std::vector<uint8_t> inverse(m_k * m_k, 0);
+  for (uint32_t i = 0; i < m_k; i++)
+    inverse[i * m_k + i] = 1;
+
+  for (uint32_t col = 0; col < m_k; col++) {
+    uint32_t pivot = col;
+    while (pivot < m_k && matrix[pivot * m_k + col] == 0)
+      pivot++;
+    if (pivot == m_k)
+      return false;
+
+    if (pivot != col) {
+      for (uint32_t j = 0; j < m_k; j++) {
+        std::swap(matrix[pivot * m_k + j], matrix[col * m_k + j]);
+        std::swap(inverse[pivot * m_k + j], inverse[col * m_k + j]);
+      }
+    }
+
+    uint8_t scale = Inverse(matrix[col * m_k + col]);
+    for (uint32_t j = 0; j < m_k; j++) {
+      matrix[col * m_k + j] = Multiply(matrix[col * m_k + j], scale);
+      inverse[col * m_k + j] = Multiply(inverse[col * m_k + j], scale);
+    }
+
+    for (uint32_t row = 0; row < m_k; row++) {
+      uint8_t factor = matrix[row * m_k + col];
+      if (row == col || factor == 0)
+        continue;
+      MultiplyAdd(&matrix[row * m_k], &matrix[col * m_k], factor, m_k);
+      MultiplyAdd(&inverse[row * m_k], &inverse[col * m_k], factor, m_k);
+    }
+  }
+
+  matrix.swap(inverse);
+  return true;
+}
+
+std::vector<std::string>
+ErasureCode::Encode(const std::string& data) const
+{
+  size_t blockSize = (data.size() + LENGTH_HEADER + m_k - 1) / m_k;
+
+  // length header, data, zero padding up to k blocks
+  std::string buffer(blockSize * m_k, '\0');
+  uint32_t length = static_cast<uint32_t>(data.size());
+  for (size_t i = 0; i < LENGTH_HEADER; i++)
+    buffer[i] = static_cast<char>(length >> (8 * (LENGTH_HEADER - 1 - i)));
+  buffer.replace(LENGTH_HEADER, data.size(), data);
+
+  std::vector<std::string> blocks;
+  blocks.reserve(m_n);
+  for (uint32_t i = 0; i < m_k; i++)
+    blocks.push_back(buffer.substr(i * blockSize, blockSize));
+
+  for (uint32_t i = 0; i < m_n - m_k; i++) {
+    std::string parity(blockSize, '\0');
+    uint8_t* dst = reinterpret_cast<uint8_t*>(&parity[0]);
+    for (uint32_t j = 0; j < m_k; j++)
+      MultiplyAdd(dst, reinterpret_cast<const uint8_t*>(blocks[j].data()), m_parity[i * m_k + j],
+                  blockSize);
+    blocks.push_back(std::move(parity));
+  }
+  return blocks;
+}
+
+bool
+ErasureCode::Decode(const std::map<uint32_t, std::string>& blocks, std::string& data) const
+{
+  // the first k usable blocks, data blocks first since the map is ordered by index
+  std::vector<const std::map<uint32_t, std::string>::value_type*> used;
+  for (const auto& block : blocks) {
+    if (block.first >= m_n)
+      continue;
+    if (!used.empty() && block.second.size() != used.front()->second.size())
+      return false;
+    used.push_back(&block);
+    if (used.size() == m_k)
+      break;
+  }
+  if (used.size() < m_k || used.front()->second.empty())
+    return false;
+
+  size_t blockSize = used.front()->second.size();
+  std::string buffer(blockSize * m_k, '\0');
+
+  if (used.back()->first == m_k - 1) {
+    // all data blocks are there
+    for (uint32_t i = 0; i < m_k; i++)
+      buffer.replace(i * blockSize, blockSize, used[i]->second);
+  }
+  else {
+    std::vector<uint8_t> matrix;
+    matrix.reserve(m_k * m_k);
+    for (const auto* block : used) {
+      std::vector<uint8_t> row = GetRow(block->first);
+      matrix.insert(matrix.end(), row.begin(), row.end());
+    }
+    if (!Invert(matrix))
+      return false;
+
+    for (uint32_t i = 0; i < m_k; i++) {
+      uint8_t* dst = reinterpret_cast<uint8_t*>(&buffer[i * blockSize]);
+      for (uint32_t j = 0; j < m_k; j++)
+        MultiplyAdd(dst, reinterpret_cast<const uint8_t*>(used[j]->second.data()),
+                    matrix[i * m_k + j], blockSize);
+    }
+  }
+
+  uint32_t length = 0;
+  for (size_t i = 0; i < LENGTH_HEADER; i++)
+    length = (length << 8) | static_cast<uint8_t>(buffer[i]);
+  if (length > buffer.size() - LENGTH_HEADER)
+    return false;
+
+  data = buffer.substr(LENGTH_HEADER, length);
+  return true;
+}
+
+} // namespace ndn
+} // namespace ns3
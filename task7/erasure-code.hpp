@@ -0,0 +1,90 @@
+#ifndef NDN_ERASURE_CODE_H
+#define NDN_ERASURE_CODE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Systematic k-of-n Reed-Solomon code over GF(2^8)
+ *
+ * Encode() splits a buffer into k data blocks and appends n - k parity blocks, which are rows of
+ * a Cauchy matrix applied to the data blocks; any k of the n blocks rebuild the buffer. The
+ * buffer length is stored in front of the first data block, so blocks can be decoded without
+ * knowing it.
+ *
+ * Multiplication is table driven: one 256-entry row of the full product table per coefficient,
+ * so the inner loop is a lookup and an XOR per byte.
+ */
+class ErasureCode {
+public:
+  /**
+   * @brief Code with @p k data blocks out of @p n, requires 1 <= k <= n <= 256
+   */
+  ErasureCode(uint32_t k, uint32_t n);
+
+  uint32_t
+  GetK() const
+  {
+    return m_k;
+  }
+
+  uint32_t
+  GetN() const
+  {
+    return m_n;
+  }
+
+  /**
+   * @brief Returns the n blocks of @p data, blocks 0..k-1 carry the data itself
+   */
+  std::vector<std::string>
+  Encode(const std::string& data) const;
+
+  /**
+   * @brief Rebuilds the data from any k of @p blocks (block index -> block)
+   * @returns false if fewer than k usable blocks are given or they are inconsistent
+   */
+  bool
+  Decode(const std::map<uint32_t, std::string>& blocks, std::string& data) const;
+
+  static uint8_t
+  Multiply(uint8_t a, uint8_t b);
+
+  static uint8_t
+  Inverse(uint8_t a);
+
+private:
+  /**
+   * @brief dst[i] ^= c * src[i] for @p size bytes
+   */
+  static void
+  MultiplyAdd(uint8_t* dst, const uint8_t* src, uint8_t c, size_t size);
+
+  /**
+   * @brief Row @p index of the n x k generator matrix (identity on top of the Cauchy rows)
+   */
+  std::vector<uint8_t>
+  GetRow(uint32_t index) const;
+
+  /**
+   * @brief Gauss-Jordan inversion of a k x k matrix in row-major order, false if singular
+   */
+  bool
+  Invert(std::vector<uint8_t>& matrix) const;
+
+private:
+  uint32_t m_k;
+  uint32_t m_n;
+  std::vector<uint8_t> m_parity; ///< (n - k) x k Cauchy coefficients, row-major
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_ERASURE_CODE_H
@@ -0,0 +1,102 @@
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM-module.h"
+
+#include "ndn-name-table.hpp"
+
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace ns3 {
+
+static int g_failures = 0;
+
+static void
+Check(bool ok, const std::string& what)
+{
+  std::cout << (ok ? "ok: " : "FAILED: ") << what << "\n";
+  if (!ok)
+    g_failures++;
+}
+
+// Interns the Names of nPeers peers under /prefix/peer, as the PeerProducers do in
+// StartApplication(), and checks that every distinct Name is stored once, that handles of equal
+// Names compare equal and that references into the table survive its growth.
+static void
+CheckInterning(uint32_t nPeers)
+{
+  ndn::InternedName peer(ndn::Name("/prefix/peer"));
+  ndn::InternedName metadata(ndn::Name("/prefix/metadata"));
+
+  Check(ndn::NameTable::Get(0).empty() && ndn::InternedName() == ndn::InternedName(ndn::Name()),
+        "id 0 is the root");
+  Check(peer == ndn::InternedName(ndn::Name("/prefix/peer")), "the same Name gets the same id");
+  Check(peer != metadata && peer != ndn::InternedName(ndn::Name("/prefix")),
+        "different Names get different ids");
+
+  size_t before = ndn::NameTable::GetN();
+  Check(&ndn::names::PrefixPeer() == &peer.Get() && &ndn::names::PrefixMetadata() == &metadata.Get()
+          && ndn::NameTable::GetN() == before,
+        "the constant Names share the entries of attributes");
+
+  const ndn::Name& first = peer.Get();
+  std::vector<ndn::InternedName> peers;
+  for (uint32_t i = 0; i < nPeers; i++) {
+    ndn::Name name(peer.Get());
+    name.append(ndn::name::Component("peer" + std::to_string(i)));
+    peers.push_back(ndn::InternedName(name));
+  }
+
+  bool found = true;
+  for (uint32_t i = 0; i < nPeers; i++)
+    found = found && ndn::InternedName(ndn::Name("/prefix/peer/peer" + std::to_string(i))) == peers[i]
+            && peers[i].Get() == ndn::Name("/prefix/peer/peer" + std::to_string(i));
+
+  std::unordered_set<ndn::InternedName> distinct(peers.begin(), peers.end());
+  Check(&first == &peer.Get() && first == ndn::Name("/prefix/peer"),
+        "references stay valid while the table grows");
+  Check(distinct.size() == nPeers && ndn::NameTable::GetN() == before + nPeers,
+        "every peer Name is stored once, with an id of its own");
+  Check(found, "interning a peer Name again finds its id");
+}
+
+static void
+CheckFileIds()
+{
+  uint32_t file = 7;
+  Check(ndn::names::ParseFileId(ndn::names::FileId(1000), file) && file == 1000,
+        "file 1000 reads back");
+  Check(ndn::names::ParseFileId(ndn::names::FileId(4294967295u), file) && file == 4294967295u,
+        "file 2^32-1 reads back");
+
+  file = 7;
+  Check(!ndn::names::ParseFileId(ndn::name::Component::fromSequenceNumber(1ull << 32), file)
+          && file == 7,
+        "2^32 is no file number and leaves the output alone");
+  Check(!ndn::names::ParseFileId(ndn::name::Component("012"), file) && file == 7,
+        "a decimal component is no file number");
+}
+
+int
+main(int argc, char* argv[])
+{
+  uint32_t nPeers = 100000;
+
+  CommandLine cmd;
+  cmd.AddValue("nPeers", "Number of peer Names interned", nPeers);
+  cmd.Parse(argc, argv);
+
+  CheckInterning(nPeers);
+  CheckFileIds();
+
+  return g_failures == 0 ? 0 : 1;
+}
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+  return ns3::main(argc, argv);
+}
@@ -0,0 +1,188 @@
+#include "ndn-app-installer.hpp"
+
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/integer.h"
+#include "ns3/log.h"
+#include "ns3/object-factory.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+
+#include <map>
+
+NS_LOG_COMPONENT_DEFINE("ndn.BulkAppInstaller");
+
+namespace ns3 {
+namespace ndn {
+
+/// @cond include_hidden
+struct BulkAppInstaller::ResolvedType {
+  ObjectFactory factory;
+  std::vector<TypeId::AttributeInformation> attributes; ///< by field, no accessor if optional and missing
+
+  void
+  Set(ObjectBase* app, size_t field, const AttributeValue& value) const
+  {
+    const TypeId::AttributeInformation& info = attributes[field];
+    if (!info.accessor)
+      return;
+    if (!info.checker->Check(value) || !info.accessor->Set(app, value))
+      NS_FATAL_ERROR("Invalid value of " << factory.GetTypeId().GetName() << "::" << info.name);
+  }
+};
+/// @endcond
+
+void
+BulkAppInstaller::Add(Ptr<Node> node, TypeId type, const PeerConsumerAttributes& attributes)
+{
+  m_entries.push_back(Entry{node, type, PEER_CONSUMER, static_cast<uint32_t>(m_peerConsumers.size())});
+  m_peerConsumers.push_back(attributes);
+}
+
+void
+BulkAppInstaller::Add(Ptr<Node> node, TypeId type, const PeerProducerAttributes& attributes)
+{
+  m_entries.push_back(Entry{node, type, PEER_PRODUCER, static_cast<uint32_t>(m_peerProducers.size())});
+  m_peerProducers.push_back(attributes);
+}
+
+void
+BulkAppInstaller::Add(Ptr<Node> node, TypeId type, const ProducerAAttributes& attributes)
+{
+  m_entries.push_back(Entry{node, type, PRODUCER_A, static_cast<uint32_t>(m_producerAs.size())});
+  m_producerAs.push_back(attributes);
+}
+
+void
+BulkAppInstaller::Add(Ptr<Node> node, TypeId type, const ConsumerAAttributes& attributes)
+{
+  m_entries.push_back(Entry{node, type, CONSUMER_A, static_cast<uint32_t>(m_consumerAs.size())});
+  m_consumerAs.push_back(attributes);
+}
+
+void
+BulkAppInstaller::Add(Ptr<Node> node, TypeId type, const ProducerAttributes& attributes)
+{
+  m_entries.push_back(Entry{node, type, PRODUCER, static_cast<uint32_t>(m_producers.size())});
+  m_producers.push_back(attributes);
+}
+
+BulkAppInstaller::ResolvedType
+BulkAppInstaller::Resolve(TypeId type, Family family)
+{
+  struct Field {
+    const char* name;
+    bool optional; ///< only some types of the family have it
+  };
+
+  // attribute names in the order of the struct fields
+  static const std::vector<Field> fields[N_FAMILIES] = {
+    {{"Prefix", false}, {"PeerKey", false}, {"PeerToken", false}, {"PeerName", false},
+     {"SyncPeers", false}, {"GossipFanout", false}, {"PushToProxy", false},
+     {"MaxFilesInFlight", false}, {"CodeK", false}, {"CodeN", false}, {"Frequency", true}},
+    {{"Prefix", false}, {"PeerName", false}},
+    {{"Prefix", false}, {"AuthSecret", false}, {"AdmissionRate", false}, {"AdmissionBurst", false},
+     {"RangeStride", false}, {"RangeSize", false}},
+    {{"Prefix", false}, {"Notify", false}, {"Frequency", true}},
+    {{"Prefix", false}},
+  };
+
+  if (!type.HasConstructor())
+    NS_FATAL_ERROR(type.GetName() << " cannot be instantiated");
+
+  ResolvedType resolved;
+  resolved.factory.SetTypeId(type);
+  for (const Field& field : fields[family]) {
+    TypeId::AttributeInformation info;
+    if (!type.LookupAttributeByName(field.name, &info) && !field.optional)
+      NS_FATAL_ERROR(type.GetName() << " has no attribute " << field.name);
+    resolved.attributes.push_back(info);
+  }
+
+  NS_LOG_DEBUG("Resolved " << type.GetName() << ", " << resolved.attributes.size() << " attributes");
+  return resolved;
+}
+
+ApplicationContainer
+BulkAppInstaller::Install()
+{
+  ApplicationContainer apps;
+  std::map<std::pair<uint16_t, Family>, ResolvedType> types;
+  const ResolvedType* type = nullptr;
+  std::pair<uint16_t, Family> lastKey;
+
+  for (const Entry& entry : m_entries) {
+    // entries of one type usually come in runs, so the map is only searched at a change
+    auto key = std::make_pair(entry.type.GetUid(), entry.family);
+    if (type == nullptr || key != lastKey) {
+      auto it = types.find(key);
+      if (it == types.end())
+        it = types.emplace(key, Resolve(entry.type, entry.family)).first;
+      type = &it->second;
+      lastKey = key;
+    }
+
+    Ptr<Application> app = type->factory.Create<Application>();
+    ObjectBase* object = PeekPointer(app);
+
+    switch (entry.family) {
+    case PEER_CONSUMER: {
+      const PeerConsumerAttributes& attributes = m_peerConsumers[entry.index];
+      type->Set(object, 0, NameValue(attributes.prefix));
+      type->Set(object, 1, IntegerValue(attributes.peerKey));
+      type->Set(object, 2, StringValue(attributes.peerToken));
+      type->Set(object, 3, NameValue(attributes.peerName));
+      type->Set(object, 4, StringValue(attributes.syncPeers));
+      type->Set(object, 5, UintegerValue(attributes.gossipFanout));
+      type->Set(object, 6, BooleanValue(attributes.pushToProxy));
+      type->Set(object, 7, UintegerValue(attributes.maxFilesInFlight));
+      type->Set(object, 8, UintegerValue(attributes.codeK));
+      type->Set(object, 9, UintegerValue(attributes.codeN));
+      type->Set(object, 10, DoubleValue(attributes.frequency));
+      break;
+    }
+    case PEER_PRODUCER: {
+      const PeerProducerAttributes& attributes = m_peerProducers[entry.index];
+      type->Set(object, 0, NameValue(attributes.prefix));
+      type->Set(object, 1, NameValue(attributes.peerName));
+      break;
+    }
+    case PRODUCER_A: {
+      const ProducerAAttributes& attributes = m_producerAs[entry.index];
+      type->Set(object, 0, NameValue(attributes.prefix));
+      type->Set(object, 1, StringValue(attributes.authSecret));
+      type->Set(object, 2, DoubleValue(attributes.admissionRate));
+      type->Set(object, 3, UintegerValue(attributes.admissionBurst));
+      type->Set(object, 4, UintegerValue(attributes.rangeStride));
+      type->Set(object, 5, UintegerValue(attributes.rangeSize));
+      break;
+    }
+    case CONSUMER_A: {
+      const ConsumerAAttributes& attributes = m_consumerAs[entry.index];
+      type->Set(object, 0, NameValue(attributes.prefix));
+      type->Set(object, 1, BooleanValue(attributes.notify));
+      type->Set(object, 2, DoubleValue(attributes.frequency));
+      break;
+    }
+    case PRODUCER:
+      type->Set(object, 0, NameValue(m_producers[entry.index].prefix));
+      break;
+    case N_FAMILIES:
+      break;
+    }
+
+    entry.node->AddApplication(app);
+    apps.Add(app);
+  }
+
+  m_entries.clear();
+  m_peerConsumers.clear();
+  m_peerProducers.clear();
+  m_producerAs.clear();
+  m_consumerAs.clear();
+  m_producers.clear();
+  return apps;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,143 @@
+#ifndef NDN_APP_INSTALLER_H
+#define NDN_APP_INSTALLER_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ns3/application-container.h"
+#include "ns3/node.h"
+#include "ns3/type-id.h"
+
+#include <string>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * Typed attributes of the task7 apps, one struct per family of app types. The initial value of
+ * every field is the default of its attribute; unlike with AppHelper, every field is set on the
+ * app, so a Config::SetDefault of one of these attributes has no effect on the apps installed
+ * with BulkAppInstaller.
+ */
+
+/// @brief Attributes of PeerConsumer and PeerConsumerCbr
+struct PeerConsumerAttributes {
+  Name prefix = Name("/");
+  int32_t peerKey = 0;
+  std::string peerToken;
+  Name peerName = Name("/");
+  std::string syncPeers;
+  uint32_t gossipFanout = 0;
+  bool pushToProxy = true;
+  uint32_t maxFilesInFlight = 1;
+  uint32_t codeK = 0;
+  uint32_t codeN = 3;
+  double frequency = 1.0; ///< PeerConsumerCbr only
+};
+
+/// @brief Attributes of PeerProducer
+struct PeerProducerAttributes {
+  Name prefix = Name("/");
+  Name peerName = Name("/");
+};
+
+/// @brief Attributes of ProducerA
+struct ProducerAAttributes {
+  Name prefix = Name("/");
+  std::string authSecret;
+  double admissionRate = 0.0;
+  uint32_t admissionBurst = 10;
+  uint32_t rangeStride = 10;
+  uint32_t rangeSize = 10;
+};
+
+/// @brief Attributes of ConsumerA and ConsumerACbr
+struct ConsumerAAttributes {
+  Name prefix = Name("/");
+  bool notify = false;
+  double frequency = 1.0; ///< ConsumerACbr only
+};
+
+/// @brief Attributes of the apps that only take a prefix: ProxyProducer and ProducerCensor
+struct ProducerAttributes {
+  Name prefix = Name("/");
+};
+
+/**
+ * @brief Installs many apps at once, without an AppHelper per app
+ *
+ * Add() queues (node, app type, typed attributes); Install() creates the apps in the order they
+ * were added. An AppHelper looks its TypeId up by name, and every SetAttribute looks the attribute
+ * up in the TypeId and its parents by name and parses the value from a string. Here the caller
+ * resolves the TypeId once, the accessors and checkers of a type's attributes are looked up at
+ * its first app, and the values are set from the typed fields directly.
+ *
+ * Installing in the order of Add() keeps the order in which the apps draw their random variable
+ * streams, so a scenario converted from AppHelper blocks to the same sequence of Add() calls gives
+ * the same run.
+ */
+class BulkAppInstaller {
+public:
+  void
+  Add(Ptr<Node> node, TypeId type, const PeerConsumerAttributes& attributes);
+
+  void
+  Add(Ptr<Node> node, TypeId type, const PeerProducerAttributes& attributes);
+
+  void
+  Add(Ptr<Node> node, TypeId type, const ProducerAAttributes& attributes);
+
+  void
+  Add(Ptr<Node> node, TypeId type, const ConsumerAAttributes& attributes);
+
+  void
+  Add(Ptr<Node> node, TypeId type, const ProducerAttributes& attributes);
+
+  size_t
+  GetN() const
+  {
+    return m_entries.size();
+  }
+
+  /**
+   * @brief Creates and adds to their nodes all apps added so far, then forgets them
+   */
+  ApplicationContainer
+  Install();
+
+private:
+  /// @cond include_hidden
+  enum Family {
+    PEER_CONSUMER,
+    PEER_PRODUCER,
+    PRODUCER_A,
+    CONSUMER_A,
+    PRODUCER,
+    N_FAMILIES
+  };
+
+  struct Entry {
+    Ptr<Node> node;
+    TypeId type;
+    Family family;
+    uint32_t index; ///< into the attribute vector of the family
+  };
+
+  struct ResolvedType;
+  /// @endcond
+
+  static ResolvedType
+  Resolve(TypeId type, Family family);
+
+  std::vector<Entry> m_entries;
+  std::vector<PeerConsumerAttributes> m_peerConsumers;
+  std::vector<PeerProducerAttributes> m_peerProducers;
+  std::vector<ProducerAAttributes> m_producerAs;
+  std::vector<ConsumerAAttributes> m_consumerAs;
+  std::vector<ProducerAttributes> m_producers;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_APP_INSTALLER_H
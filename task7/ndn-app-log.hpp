@@ -0,0 +1,57 @@
+#ifndef NDN_APP_LOG_H
+#define NDN_APP_LOG_H
+
+#include "ns3/log.h"
+
+/**
+ * Compile-time log levels for the packet handlers of the censorship apps.
+ *
+ * NS_LOG_* statements still cost a log component lookup per call, and code that only exists to
+ * build log messages (substrings of the parameters, Name::toUri()) runs regardless. The
+ * NDN_APP_LOG_* macros expand to nothing unless NDN_APP_LOG_LEVEL is high enough, so neither the
+ * check nor the message arguments are compiled in. Build with e.g.
+ * -DNDN_APP_LOG_LEVEL=NDN_APP_LOG_LEVEL_INFO to get the messages back; by default they follow
+ * NS3_LOG_ENABLE, i.e. they are present in debug builds and gone in optimized ones.
+ *
+ * Use NDN_APP_LOG_IS_ENABLED(level) to guard code that only prepares log output.
+ */
+#define NDN_APP_LOG_LEVEL_NONE 0
+#define NDN_APP_LOG_LEVEL_INFO 1
+#define NDN_APP_LOG_LEVEL_DEBUG 2
+#define NDN_APP_LOG_LEVEL_FUNCTION 3
+
+#ifndef NDN_APP_LOG_LEVEL
+#ifdef NS3_LOG_ENABLE
+#define NDN_APP_LOG_LEVEL NDN_APP_LOG_LEVEL_FUNCTION
+#else
+#define NDN_APP_LOG_LEVEL NDN_APP_LOG_LEVEL_NONE
+#endif
+#endif
+
+#define NDN_APP_LOG_IS_ENABLED(level) (NDN_APP_LOG_LEVEL >= NDN_APP_LOG_LEVEL_##level)
+
+#define NDN_APP_LOG_NOOP                                                                           \
+  do {                                                                                             \
+  } while (false)
+
+#if NDN_APP_LOG_IS_ENABLED(INFO)
+#define NDN_APP_LOG_INFO(msg) NS_LOG_INFO(msg)
+#else
+#define NDN_APP_LOG_INFO(msg) NDN_APP_LOG_NOOP
+#endif
+
+#if NDN_APP_LOG_IS_ENABLED(DEBUG)
+#define NDN_APP_LOG_DEBUG(msg) NS_LOG_DEBUG(msg)
+#else
+#define NDN_APP_LOG_DEBUG(msg) NDN_APP_LOG_NOOP
+#endif
+
+#if NDN_APP_LOG_IS_ENABLED(FUNCTION)
+#define NDN_APP_LOG_FUNCTION(parameters) NS_LOG_FUNCTION(parameters)
+#define NDN_APP_LOG_FUNCTION_NOARGS() NS_LOG_FUNCTION_NOARGS()
+#else
+#define NDN_APP_LOG_FUNCTION(parameters) NDN_APP_LOG_NOOP
+#define NDN_APP_LOG_FUNCTION_NOARGS() NDN_APP_LOG_NOOP
+#endif
+
+#endif // NDN_APP_LOG_H
@@ -0,0 +1,186 @@
+#include "ndn-app-profile.hpp"
+
+#include "ns3/application.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <map>
+
+#include <time.h>
+
+NS_LOG_COMPONENT_DEFINE("ndn.AppProfiler");
+
+namespace ns3 {
+namespace ndn {
+
+bool AppProfiler::s_enabled = false;
+bool AppProfiler::s_perNode = false;
+std::string AppProfiler::s_file;
+uint64_t AppProfiler::s_start = 0;
+uint64_t AppProfiler::s_insideNs = 0;
+std::vector<std::string> AppProfiler::s_scopes;
+std::vector<std::pair<uint32_t, uint32_t>> AppProfiler::s_stacks;
+std::unordered_map<uint64_t, uint32_t> AppProfiler::s_stackIds;
+std::vector<std::string> AppProfiler::s_typeNames;
+std::vector<AppProfiler::Frame> AppProfiler::s_frames;
+std::unordered_map<uint64_t, AppProfiler::Totals> AppProfiler::s_totals;
+
+static const int NODE_SHIFT = 40;
+static const int TYPE_SHIFT = 24;
+static const uint64_t STACK_MASK = (uint64_t(1) << TYPE_SHIFT) - 1;
+static const uint64_t TYPE_MASK = (uint64_t(1) << (NODE_SHIFT - TYPE_SHIFT)) - 1;
+
+void
+AppProfiler::Install(const std::string& file, bool perNode)
+{
+  s_enabled = true;
+  s_perNode = perNode;
+  s_file = file;
+  s_stacks.assign(1, std::make_pair(0, 0));
+  s_stackIds.clear();
+  s_frames.clear();
+  s_totals.clear();
+  s_insideNs = 0;
+
+  Simulator::ScheduleDestroy(&AppProfiler::Dump);
+  s_start = Now();
+}
+
+uint64_t
+AppProfiler::Now()
+{
+  // vDSO, no system call: a few tens of ns, like rdtsc but comparable across cores
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+uint32_t
+AppProfiler::RegisterScope(const char* name)
+{
+  for (uint32_t i = 0; i < s_scopes.size(); i++) {
+    if (s_scopes[i] == name)
+      return i;
+  }
+  s_scopes.push_back(name);
+  return s_scopes.size() - 1;
+}
+
+void
+AppProfiler::Enter(const Application* app, uint32_t scope)
+{
+  uint32_t parent = 0;
+  uint64_t owner = 0; // node and type bits of the key
+  if (!s_frames.empty() && s_frames.back().app == app) {
+    parent = s_frames.back().key & STACK_MASK;
+    owner = s_frames.back().key & ~STACK_MASK;
+  }
+  else {
+    uint16_t type = app->GetInstanceTypeId().GetUid();
+    if (type >= s_typeNames.size())
+      s_typeNames.resize(type + 1);
+    if (s_typeNames[type].empty())
+      s_typeNames[type] = app->GetInstanceTypeId().GetName();
+
+    owner = static_cast<uint64_t>(type) << TYPE_SHIFT;
+    if (s_perNode)
+      owner |= static_cast<uint64_t>(app->GetNode()->GetId()) << NODE_SHIFT;
+  }
+
+  auto inserted = s_stackIds.emplace(static_cast<uint64_t>(parent) << 32 | scope, s_stacks.size());
+  if (inserted.second)
+    s_stacks.push_back(std::make_pair(parent, scope));
+
+  s_frames.push_back(Frame{app, owner | inserted.first->second, Now(), 0});
+}
+
+void
+AppProfiler::Leave()
+{
+  if (s_frames.empty())
+    return; // entered before Install
+
+  const Frame& frame = s_frames.back();
+  uint64_t elapsed = Now() - frame.start;
+
+  Totals& totals = s_totals[frame.key];
+  totals.calls++;
+  totals.totalNs += elapsed;
+  totals.selfNs += elapsed - std::min(elapsed, frame.children);
+
+  s_frames.pop_back();
+  if (!s_frames.empty())
+    s_frames.back().children += elapsed;
+  else
+    s_insideNs += elapsed;
+}
+
+std::string
+AppProfiler::GetStackName(uint32_t stack)
+{
+  std::string name;
+  while (stack != 0) {
+    name.insert(0, name.empty() ? s_scopes[s_stacks[stack].second]
+                                : s_scopes[s_stacks[stack].second] + ";");
+    stack = s_stacks[stack].first;
+  }
+  return name;
+}
+
+void
+AppProfiler::Print(std::ostream& os)
+{
+  // over all nodes, by type name and stack name
+  std::map<std::pair<std::string, std::string>, Totals> totals;
+  for (const auto& entry : s_totals) {
+    uint32_t stack = entry.first & STACK_MASK;
+    Totals& total = totals[std::make_pair(s_typeNames[(entry.first >> TYPE_SHIFT) & TYPE_MASK],
+                                          GetStackName(stack))];
+    total.calls += entry.second.calls;
+    total.totalNs += entry.second.totalNs;
+    total.selfNs += entry.second.selfNs;
+  }
+
+  os << "Profile\tApp\tStack\tCalls\tTotal(us)\tSelf(us)\tSelf/call(ns)\n";
+  for (const auto& entry : totals) {
+    const Totals& total = entry.second;
+    os << "Profile\t" << entry.first.first << "\t" << entry.first.second << "\t" << total.calls
+       << "\t" << total.totalNs / 1000 << "\t" << total.selfNs / 1000 << "\t"
+       << (total.calls > 0 ? total.selfNs / total.calls : 0) << "\n";
+  }
+
+  uint64_t runNs = Now() - s_start;
+  os << "Profile\tOutside apps\t\t\t" << (runNs - std::min(runNs, s_insideNs)) / 1000 << "\n";
+}
+
+void
+AppProfiler::PrintFolded(std::ostream& os)
+{
+  for (const auto& entry : s_totals) {
+    os << s_typeNames[(entry.first >> TYPE_SHIFT) & TYPE_MASK] << ";";
+    if (s_perNode)
+      os << "Node" << (entry.first >> NODE_SHIFT) << ";";
+    os << GetStackName(entry.first & STACK_MASK) << " " << entry.second.selfNs << "\n";
+  }
+}
+
+void
+AppProfiler::Dump()
+{
+  Print(std::cout);
+  s_enabled = false;
+
+  std::ofstream os(s_file.c_str());
+  if (!os.is_open()) {
+    NS_LOG_ERROR("Cannot open " << s_file << " for writing the folded stacks");
+    return;
+  }
+  PrintFolded(os);
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,151 @@
+#ifndef NDN_APP_PROFILE_H
+#define NDN_APP_PROFILE_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+
+class Application;
+
+namespace ndn {
+
+/**
+ * @brief CPU time spent in the callbacks and scheduled events of the apps
+ *
+ * The handlers mark themselves with NDN_APP_PROFILE("<scope>"). Scopes nest (e.g.
+ * CheckRetxTimeout;OnTimeout or SendPacket;Transmit, where Transmit includes the forwarder's
+ * processing of the Interest), and every scope is charged its own time minus that of the scopes
+ * inside it. Totals are kept per app type, stack of scopes and, with perNode, per node, in one
+ * hash table entry each, so the cost does not depend on the number of apps.
+ *
+ * When Simulator::Destroy is called, a summary per app type and stack (calls, total and self
+ * microseconds) is printed to stdout together with the run time spent outside all scopes
+ * (scheduler, links and the forwarder's processing of received packets). The folded stacks
+ * ("<type>;[Node<id>;]<scope>;... <self ns>") go to the given file, ready for flamegraph.pl.
+ *
+ * NDN_APP_PROFILE compiles to nothing unless the build defines NDN_APP_PROFILE_ENABLED=1. Even
+ * then nothing is measured until Install() is called; the macros only check a flag.
+ */
+class AppProfiler {
+public:
+  /**
+   * @param file folded stacks output file
+   * @param perNode keep the totals of every node apart instead of per app type only
+   */
+  static void
+  Install(const std::string& file, bool perNode = false);
+
+  static bool
+  IsEnabled()
+  {
+    return s_enabled;
+  }
+
+  /**
+   * @brief Returns the id of scope @p name, the same for every call with the same name
+   */
+  static uint32_t
+  RegisterScope(const char* name);
+
+  static void
+  Enter(const Application* app, uint32_t scope);
+
+  static void
+  Leave();
+
+  static void
+  Print(std::ostream& os);
+
+  static void
+  PrintFolded(std::ostream& os);
+
+private:
+  static uint64_t
+  Now();
+
+  static void
+  Dump();
+
+  static std::string
+  GetStackName(uint32_t stack);
+
+private:
+  /// @cond include_hidden
+  struct Frame {
+    const Application* app;
+    uint64_t key;      ///< node << 40 | type << 24 | stack
+    uint64_t start;    ///< ns
+    uint64_t children; ///< ns spent in nested scopes
+  };
+
+  struct Totals {
+    uint64_t calls = 0;
+    uint64_t totalNs = 0;
+    uint64_t selfNs = 0;
+  };
+  /// @endcond
+
+  static bool s_enabled;
+  static bool s_perNode;
+  static std::string s_file;
+  static uint64_t s_start;
+  static uint64_t s_insideNs; ///< ns spent in outermost scopes
+
+  static std::vector<std::string> s_scopes;
+  static std::vector<std::pair<uint32_t, uint32_t>> s_stacks; ///< stack -> (parent, scope), 0 is the root
+  static std::unordered_map<uint64_t, uint32_t> s_stackIds;   ///< parent << 32 | scope -> stack
+  static std::vector<std::string> s_typeNames;                ///< app type names by TypeId uid
+  static std::vector<Frame> s_frames;
+  static std::unordered_map<uint64_t, Totals> s_totals;
+};
+
+/**
+ * @brief Charges the time until the end of the enclosing block to @p scope of @p app
+ */
+class ScopedProfile {
+public:
+  ScopedProfile(const Application* app, uint32_t scope)
+    : m_active(AppProfiler::IsEnabled())
+  {
+    if (m_active)
+      AppProfiler::Enter(app, scope);
+  }
+
+  ~ScopedProfile()
+  {
+    if (m_active)
+      AppProfiler::Leave();
+  }
+
+  ScopedProfile(const ScopedProfile&) = delete;
+  ScopedProfile&
+  operator=(const ScopedProfile&) = delete;
+
+private:
+  bool m_active;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#ifndef NDN_APP_PROFILE_ENABLED
+#define NDN_APP_PROFILE_ENABLED 0
+#endif
+
+#if NDN_APP_PROFILE_ENABLED
+#define NDN_APP_PROFILE(scope)                                                                     \
+  static const uint32_t ndnAppProfileScope = ::ns3::ndn::AppProfiler::RegisterScope(scope);        \
+  ::ns3::ndn::ScopedProfile ndnAppProfile(this, ndnAppProfileScope)
+#else
+#define NDN_APP_PROFILE(scope)                                                                     \
+  do {                                                                                             \
+  } while (false)
+#endif
+
+#endif // NDN_APP_PROFILE_H
@@ -0,0 +1,223 @@
+#include "ndn-app-snapshot.hpp"
+
+#include "ns3/application.h"
+#include "ns3/log.h"
+#include "ns3/node-list.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+NS_LOG_COMPONENT_DEFINE("ndn.AppSnapshot");
+
+namespace ns3 {
+namespace ndn {
+
+static const uint32_t SNAPSHOT_MAGIC = 0x534e444e; // "NDNS"
+static const uint32_t SNAPSHOT_VERSION = 2; // 2: ProxyReader keys relative to FirstFile
+
+void
+SnapshotWriter::PutBytes(const void* data, size_t size)
+{
+  m_buffer.append(static_cast<const char*>(data), size);
+}
+
+void
+SnapshotWriter::Put(bool value)
+{
+  uint8_t byte = value ? 1 : 0;
+  PutBytes(&byte, sizeof(byte));
+}
+
+void
+SnapshotWriter::Put(uint32_t value)
+{
+  PutBytes(&value, sizeof(value));
+}
+
+void
+SnapshotWriter::Put(uint64_t value)
+{
+  PutBytes(&value, sizeof(value));
+}
+
+void
+SnapshotWriter::Put(const std::string& value)
+{
+  Put(static_cast<uint32_t>(value.size()));
+  PutBytes(value.data(), value.size());
+}
+
+void
+SnapshotWriter::Put(const Name& value)
+{
+  Put(value.toUri());
+}
+
+void
+SnapshotWriter::Put(Time value)
+{
+  int64_t relative = (value - Simulator::Now()).GetTimeStep();
+  PutBytes(&relative, sizeof(relative));
+}
+
+SnapshotReader::SnapshotReader(const std::string& buffer)
+  : m_buffer(buffer)
+  , m_position(0)
+{
+}
+
+void
+SnapshotReader::GetBytes(void* data, size_t size)
+{
+  if (size > m_buffer.size() - m_position)
+    NS_FATAL_ERROR("Snapshot record is truncated");
+
+  std::memcpy(data, m_buffer.data() + m_position, size);
+  m_position += size;
+}
+
+void
+SnapshotReader::Get(bool& value)
+{
+  uint8_t byte = 0;
+  GetBytes(&byte, sizeof(byte));
+  value = byte != 0;
+}
+
+void
+SnapshotReader::Get(uint32_t& value)
+{
+  GetBytes(&value, sizeof(value));
+}
+
+void
+SnapshotReader::Get(uint64_t& value)
+{
+  GetBytes(&value, sizeof(value));
+}
+
+void
+SnapshotReader::Get(std::string& value)
+{
+  uint32_t size = 0;
+  Get(size);
+  if (size > m_buffer.size() - m_position)
+    NS_FATAL_ERROR("Snapshot record is truncated");
+
+  value.assign(m_buffer, m_position, size);
+  m_position += size;
+}
+
+void
+SnapshotReader::Get(Name& value)
+{
+  std::string uri;
+  Get(uri);
+  value = Name(uri);
+}
+
+void
+SnapshotReader::Get(Time& value)
+{
+  int64_t relative = 0;
+  GetBytes(&relative, sizeof(relative));
+  value = Simulator::Now() + TimeStep(relative);
+}
+
+void
+AppSnapshot::Install(const std::string& file, Time time)
+{
+  Simulator::Schedule(time, &AppSnapshot::Save, file);
+}
+
+void
+AppSnapshot::Save(const std::string& file)
+{
+  // file: magic, version, time, then per app node, index, type and state
+  SnapshotWriter writer;
+  writer.Put(SNAPSHOT_MAGIC);
+  writer.Put(SNAPSHOT_VERSION);
+  writer.Put(static_cast<uint64_t>(Simulator::Now().GetTimeStep()));
+
+  uint32_t apps = 0;
+  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+    for (uint32_t i = 0; i < (*node)->GetNApplications(); i++) {
+      Ptr<Application> app = (*node)->GetApplication(i);
+      const SnapshotState* state = dynamic_cast<const SnapshotState*>(PeekPointer(app));
+      if (state == nullptr)
+        continue;
+
+      SnapshotWriter record;
+      state->SaveState(record);
+
+      writer.Put((*node)->GetId());
+      writer.Put(i);
+      writer.Put(app->GetInstanceTypeId().GetName());
+      writer.Put(record.GetBuffer());
+      apps++;
+    }
+  }
+
+  std::ofstream os(file.c_str(), std::ios::binary);
+  os.write(writer.GetBuffer().data(), writer.GetBuffer().size());
+  if (!os)
+    NS_FATAL_ERROR("Cannot write snapshot " << file);
+
+  NS_LOG_INFO("Saved " << apps << " apps to " << file << " at " << Simulator::Now().GetSeconds()
+                       << "s");
+}
+
+Time
+AppSnapshot::Load(const std::string& file)
+{
+  std::ifstream is(file.c_str(), std::ios::binary);
+  if (!is)
+    NS_FATAL_ERROR("Cannot read snapshot " << file);
+  std::string buffer((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+
+  SnapshotReader reader(buffer);
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  uint64_t time = 0;
+  reader.Get(magic);
+  reader.Get(version);
+  if (magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION)
+    NS_FATAL_ERROR(file << " is not a snapshot of this version");
+  reader.Get(time);
+
+  uint32_t apps = 0;
+  while (!reader.AtEnd()) {
+    uint32_t nodeId = 0;
+    uint32_t index = 0;
+    std::string type;
+    std::string record;
+    reader.Get(nodeId);
+    reader.Get(index);
+    reader.Get(type);
+    reader.Get(record);
+
+    if (nodeId >= NodeList::GetNNodes() || index >= NodeList::GetNode(nodeId)->GetNApplications())
+      NS_FATAL_ERROR("Snapshot app " << index << " of node " << nodeId << " is not installed");
+
+    Ptr<Application> app = NodeList::GetNode(nodeId)->GetApplication(index);
+    SnapshotState* state = dynamic_cast<SnapshotState*>(PeekPointer(app));
+    if (state == nullptr || app->GetInstanceTypeId().GetName() != type)
+      NS_FATAL_ERROR("App " << index << " of node " << nodeId << " is not the " << type
+                            << " of the snapshot");
+
+    SnapshotReader recordReader(record);
+    state->LoadState(recordReader);
+    if (!recordReader.AtEnd())
+      NS_FATAL_ERROR("State of " << type << " on node " << nodeId << " was not read completely");
+    apps++;
+  }
+
+  NS_LOG_INFO("Restored " << apps << " apps from " << file);
+  return TimeStep(static_cast<int64_t>(time));
+}
+
+} // namespace ndn
+} // namespace ns3
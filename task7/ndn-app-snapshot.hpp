@@ -0,0 +1,157 @@
+#ifndef NDN_APP_SNAPSHOT_H
+#define NDN_APP_SNAPSHOT_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ns3/nstime.h"
+
+#include <cstdint>
+#include <string>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Serializes the state of one app into a snapshot
+ *
+ * Integers are copied in host (little endian) order, strings and Names (as URIs) with a 32-bit
+ * length. Times are stored relative to the time of the snapshot, see SnapshotReader.
+ */
+class SnapshotWriter {
+public:
+  void
+  Put(bool value);
+
+  void
+  Put(uint32_t value);
+
+  void
+  Put(uint64_t value);
+
+  void
+  Put(const std::string& value);
+
+  void
+  Put(const Name& value);
+
+  /**
+   * @brief Writes @p value - Simulator::Now()
+   */
+  void
+  Put(Time value);
+
+  const std::string&
+  GetBuffer() const
+  {
+    return m_buffer;
+  }
+
+private:
+  void
+  PutBytes(const void* data, size_t size);
+
+private:
+  std::string m_buffer;
+};
+
+/**
+ * @brief Reads what a SnapshotWriter wrote, in the same order
+ *
+ * Times come back shifted by the offset of the resumed run: a time written as t at snapshot time
+ * T reads as t - T + Simulator::Now(), so delays and ages measured across the snapshot stay
+ * right. Reading past the end is a fatal error.
+ */
+class SnapshotReader {
+public:
+  explicit SnapshotReader(const std::string& buffer);
+
+  void
+  Get(bool& value);
+
+  void
+  Get(uint32_t& value);
+
+  void
+  Get(uint64_t& value);
+
+  void
+  Get(std::string& value);
+
+  void
+  Get(Name& value);
+
+  void
+  Get(Time& value);
+
+  bool
+  AtEnd() const
+  {
+    return m_position == m_buffer.size();
+  }
+
+private:
+  void
+  GetBytes(void* data, size_t size);
+
+private:
+  const std::string& m_buffer;
+  size_t m_position;
+};
+
+/**
+ * @brief Interface of the apps that AppSnapshot saves and restores
+ *
+ * LoadState() is called before the app starts, with the reader positioned where SaveState()
+ * began to write. StartApplication() must not overwrite restored state.
+ */
+class SnapshotState {
+public:
+  virtual ~SnapshotState()
+  {
+  }
+
+  virtual void
+  SaveState(SnapshotWriter& writer) const = 0;
+
+  virtual void
+  LoadState(SnapshotReader& reader) = 0;
+};
+
+/**
+ * @brief Checkpoint of the app state of a run, to branch many runs off one warm-up
+ *
+ * A snapshot holds, for every app that implements SnapshotState, its node id, its index on the
+ * node, its type name and its state: file ranges and file states, the tracked Interests of the
+ * consumers (the retransmission table), the originals of the PeerProducers, the request counts
+ * of ProducerA and the stores of the proxies.
+ *
+ * The simulator itself cannot be serialized: pending events, PIT and content store entries and
+ * packets in flight are not part of it. A resumed run therefore starts at time 0 with the
+ * snapshot time as an offset (Load() returns it), re-sends the Interests that were outstanding
+ * (they count as retransmissions), starts with fresh RTT estimators and collects metrics from
+ * the snapshot on only. Load() must follow the same topology and app installation as the run
+ * that saved it; a record whose node, app index or type does not match is a fatal error.
+ */
+class AppSnapshot {
+public:
+  /**
+   * @brief Saves the state of all apps to @p file at @p time
+   */
+  static void
+  Install(const std::string& file, Time time);
+
+  static void
+  Save(const std::string& file);
+
+  /**
+   * @brief Restores the state saved in @p file into the installed apps
+   * @return time of the snapshot in the run that saved it
+   */
+  static Time
+  Load(const std::string& file);
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_APP_SNAPSHOT_H
@@ -0,0 +1,67 @@
+#ifndef NDN_BINARY_TRACE_FORMAT_H
+#define NDN_BINARY_TRACE_FORMAT_H
+
+#include <cstdint>
+
+namespace ns3 {
+namespace ndn {
+namespace trace {
+
+/**
+ * @brief On-disk layout of the binary packet trace written by BinaryTracer
+ *
+ * The file starts with a FileHeader followed by any number of blocks. Every block is a
+ * BlockHeader with the record count n, followed by one column per field, in this order:
+ *
+ *     uint32_t node[n]; uint32_t app[n]; uint8_t event[n]; uint64_t nameHash[n];
+ *     uint32_t seq[n];  int64_t time[n];
+ *
+ * Integers are in the native byte order of the host that wrote the trace, as the columns are
+ * copied out of memory; a reader on a host of the other byte order sees a wrong FILE_MAGIC and
+ * rejects the file. Times are simulation time in nanoseconds.
+ *
+ * Sampler writes its time series in the same layout, one record per sampled value: the event is
+ * one of the EVENT_SAMPLE_* kinds, app is the device index (queue) or the app id (outstanding),
+ * 0 otherwise, seq holds the value and nameHash is 0.
+ */
+static const uint32_t FILE_MAGIC = 0x544e444e; // "NDNT"
+static const uint32_t BLOCK_MAGIC = 0x4b4c4231; // "1BLK"
+static const uint32_t VERSION = 1;
+
+static const uint32_t NO_SEQ = 0xffffffff;
+
+enum EventType : uint8_t {
+  EVENT_INTEREST = 0,
+  EVENT_DATA = 1,
+  EVENT_NACK = 2,
+  EVENT_TIMEOUT = 3,
+  EVENT_PUSH = 4,
+  EVENT_SAMPLE_QUEUE = 5,      ///< packets in the queue of a point-to-point device
+  EVENT_SAMPLE_PIT = 6,        ///< PIT entries of a node
+  EVENT_SAMPLE_CS = 7,         ///< content store entries of a node
+  EVENT_SAMPLE_OUTSTANDING = 8 ///< Interests a consumer waits Data for
+};
+
+inline const char*
+GetEventName(uint8_t event)
+{
+  static const char* names[] = {"interest", "data", "nack", "timeout", "push",
+                                "queue", "pit", "cs", "outstanding"};
+  return event <= EVENT_SAMPLE_OUTSTANDING ? names[event] : "unknown";
+}
+
+struct FileHeader {
+  uint32_t magic;
+  uint32_t version;
+};
+
+struct BlockHeader {
+  uint32_t magic;
+  uint32_t count;
+};
+
+} // namespace trace
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_BINARY_TRACE_FORMAT_H
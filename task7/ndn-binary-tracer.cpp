@@ -0,0 +1,245 @@
+#include "ndn-binary-tracer.hpp"
+#include "ndn-app.hpp"
+#include "ndn-name-table.hpp"
+
+#include "ns3/config.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+
+#include <cerrno>
+#include <cstring>
+
+NS_LOG_COMPONENT_DEFINE("ndn.BinaryTracer");
+
+namespace ns3 {
+namespace ndn {
+
+BinaryTracer* BinaryTracer::s_instance = nullptr;
+
+BinaryTracer::Columns::Columns(size_t capacity)
+  : count(0)
+  , node(capacity)
+  , app(capacity)
+  , event(capacity)
+  , nameHash(capacity)
+  , seq(capacity)
+  , time(capacity)
+{
+}
+
+BinaryTracer::BinaryTracer(const std::string& file, size_t blockRecords, size_t maxBlocks)
+  : m_file(std::fopen(file.c_str(), "wb"))
+  , m_fileName(file)
+  , m_blockRecords(blockRecords)
+  , m_closing(false)
+{
+  if (m_file == nullptr) {
+    NS_FATAL_ERROR("Cannot open " << file << " for the binary trace");
+  }
+
+  trace::FileHeader header = {trace::FILE_MAGIC, trace::VERSION};
+  if (std::fwrite(&header, sizeof(header), 1, m_file) != 1) {
+    NS_FATAL_ERROR("Cannot write the binary trace " << file << ": " << std::strerror(errno));
+  }
+
+  m_current.reset(new Columns(blockRecords));
+  for (size_t i = 1; i < maxBlocks; i++) {
+    m_free.emplace_back(new Columns(blockRecords));
+  }
+
+  m_writer = std::thread(&BinaryTracer::WriterLoop, this);
+}
+
+BinaryTracer::~BinaryTracer()
+{
+  Close();
+}
+
+void
+BinaryTracer::Record(uint32_t node, uint32_t app, trace::EventType event, uint64_t nameHash,
+                     uint32_t seq, Time time)
+{
+  Columns& block = *m_current;
+  size_t i = block.count++;
+  block.node[i] = node;
+  block.app[i] = app;
+  block.event[i] = event;
+  block.nameHash[i] = nameHash;
+  block.seq[i] = seq;
+  block.time[i] = time.GetNanoSeconds();
+
+  if (block.count == m_blockRecords)
+    Submit();
+}
+
+void
+BinaryTracer::Submit()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_full.push_back(std::move(m_current));
+  m_cv.notify_all();
+
+  // bounded memory: wait for the writer if every block is in use
+  m_cv.wait(lock, [this] { return !m_free.empty(); });
+  m_current = std::move(m_free.back());
+  m_free.pop_back();
+  m_current->Clear();
+
+  CheckError();
+}
+
+void
+BinaryTracer::CheckError() const
+{
+  if (!m_error.empty()) {
+    NS_FATAL_ERROR("Writing the binary trace " << m_fileName << " failed: " << m_error);
+  }
+}
+
+void
+BinaryTracer::WriterLoop()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    m_cv.wait(lock, [this] { return !m_full.empty() || m_closing; });
+    if (m_full.empty())
+      break;
+
+    std::unique_ptr<Columns> block = std::move(m_full.front());
+    m_full.pop_front();
+
+    // only this thread sets m_error, so it can read it unlocked
+    lock.unlock();
+    bool written = m_error.empty() && WriteBlock(*block);
+    int error = errno;
+    lock.lock();
+
+    if (!written && m_error.empty())
+      m_error = std::strerror(error);
+    m_free.push_back(std::move(block));
+    m_cv.notify_all();
+  }
+}
+
+bool
+BinaryTracer::WriteBlock(const Columns& block)
+{
+  size_t n = block.count;
+  trace::BlockHeader header = {trace::BLOCK_MAGIC, static_cast<uint32_t>(n)};
+  // flushed per block, so a full disk shows at the next block and not only at Close()
+  return std::fwrite(&header, sizeof(header), 1, m_file) == 1
+         && std::fwrite(block.node.data(), sizeof(uint32_t), n, m_file) == n
+         && std::fwrite(block.app.data(), sizeof(uint32_t), n, m_file) == n
+         && std::fwrite(block.event.data(), sizeof(uint8_t), n, m_file) == n
+         && std::fwrite(block.nameHash.data(), sizeof(uint64_t), n, m_file) == n
+         && std::fwrite(block.seq.data(), sizeof(uint32_t), n, m_file) == n
+         && std::fwrite(block.time.data(), sizeof(int64_t), n, m_file) == n
+         && std::fflush(m_file) == 0;
+}
+
+void
+BinaryTracer::Close()
+{
+  if (m_file == nullptr)
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_current && m_current->count > 0)
+      m_full.push_back(std::move(m_current));
+    m_closing = true;
+  }
+  m_cv.notify_all();
+  m_writer.join();
+
+  if (std::fclose(m_file) != 0 && m_error.empty())
+    m_error = std::strerror(errno);
+  m_file = nullptr;
+  CheckError();
+}
+
+uint64_t
+BinaryTracer::HashName(const Name& name)
+{
+  // FNV-1a over the TLV encoding, which Name caches after the first use
+  const Block& wire = name.wireEncode();
+  uint64_t hash = 14695981039346656037ULL;
+  for (auto it = wire.value_begin(); it != wire.value_end(); ++it) {
+    hash ^= *it;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+void
+BinaryTracer::InstallAll(const std::string& file, size_t blockRecords, size_t maxBlocks)
+{
+  delete s_instance;
+  s_instance = new BinaryTracer(file, blockRecords, maxBlocks);
+
+  std::string apps = "/NodeList/*/ApplicationList/*/$ns3::ndn::App/";
+  Config::ConnectWithoutContext(apps + "TransmittedInterests",
+                                MakeCallback(&BinaryTracer::OnTransmittedInterest));
+  Config::ConnectWithoutContext(apps + "ReceivedDatas", MakeCallback(&BinaryTracer::OnReceivedData));
+  Config::ConnectWithoutContext(apps + "ReceivedNacks", MakeCallback(&BinaryTracer::OnReceivedNack));
+
+  static const char* consumers[] = {"ns3::ndn::ConsumerA", "ns3::ndn::PeerConsumer"};
+  for (const char* consumer : consumers) {
+    Config::ConnectWithoutContext(std::string("/NodeList/*/ApplicationList/*/$") + consumer
+                                    + "/Timeout",
+                                  MakeCallback(&BinaryTracer::OnTimeout));
+  }
+
+  Simulator::ScheduleDestroy(&BinaryTracer::Destroy);
+}
+
+void
+BinaryTracer::RecordApp(Ptr<App> app, trace::EventType event, const Name& name)
+{
+  uint32_t seq = trace::NO_SEQ;
+  if (!name.empty() && name.at(-1).isSequenceNumber())
+    seq = static_cast<uint32_t>(name.at(-1).toSequenceNumber());
+
+  s_instance->Record(app->GetNode()->GetId(), app->GetId(), event, HashName(name), seq,
+                     Simulator::Now());
+}
+
+void
+BinaryTracer::OnTransmittedInterest(shared_ptr<const Interest> interest, Ptr<App> app,
+                                    shared_ptr<Face> face)
+{
+  // pushes carry the content in the parameters, metadata requests only the peer key
+  const Name& name = interest->getName();
+  bool isPush = interest->hasParameters() && !(name.size() > 1 && name.get(1) == names::Metadata());
+  RecordApp(app, isPush ? trace::EVENT_PUSH : trace::EVENT_INTEREST, name);
+}
+
+void
+BinaryTracer::OnReceivedData(shared_ptr<const Data> data, Ptr<App> app, shared_ptr<Face> face)
+{
+  RecordApp(app, trace::EVENT_DATA, data->getName());
+}
+
+void
+BinaryTracer::OnReceivedNack(shared_ptr<const lp::Nack> nack, Ptr<App> app, shared_ptr<Face> face)
+{
+  RecordApp(app, trace::EVENT_NACK, nack->getInterest().getName());
+}
+
+void
+BinaryTracer::OnTimeout(Ptr<App> app, uint32_t seqno)
+{
+  s_instance->Record(app->GetNode()->GetId(), app->GetId(), trace::EVENT_TIMEOUT, 0, seqno,
+                     Simulator::Now());
+}
+
+void
+BinaryTracer::Destroy()
+{
+  delete s_instance;
+  s_instance = nullptr;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,138 @@
+#ifndef NDN_BINARY_TRACER_H
+#define NDN_BINARY_TRACER_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ndn-binary-trace-format.hpp"
+
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+class App;
+
+/**
+ * @brief Append-only binary sink for packet-level app events
+ *
+ * Records are appended column-wise into fixed-size blocks. Full blocks are handed to a writer
+ * thread, so the simulation never waits for the disk unless all @p maxBlocks blocks are in
+ * flight; memory is bounded by maxBlocks * blockRecords * 29 bytes. See
+ * ndn-binary-trace-format.hpp for the file layout and ndn-trace-to-csv.cpp for the reader.
+ */
+class BinaryTracer {
+public:
+  BinaryTracer(const std::string& file, size_t blockRecords, size_t maxBlocks);
+
+  ~BinaryTracer();
+
+  /**
+   * @brief Traces Interests, Data, NACKs, timeouts and pushes of every app until
+   *        Simulator::Destroy
+   */
+  static void
+  InstallAll(const std::string& file, size_t blockRecords = 65536, size_t maxBlocks = 4);
+
+  void
+  Record(uint32_t node, uint32_t app, trace::EventType event, uint64_t nameHash, uint32_t seq,
+         Time time);
+
+  /**
+   * @brief Writes all buffered records and closes the file
+   *
+   * A failed write (e.g. a full disk) is a fatal error here or at the next full block, so a
+   * trace is never silently truncated.
+   */
+  void
+  Close();
+
+  static uint64_t
+  HashName(const Name& name);
+
+private:
+  struct Columns {
+    explicit Columns(size_t capacity);
+
+    void
+    Clear()
+    {
+      count = 0;
+    }
+
+    size_t count;
+    std::vector<uint32_t> node;
+    std::vector<uint32_t> app;
+    std::vector<uint8_t> event;
+    std::vector<uint64_t> nameHash;
+    std::vector<uint32_t> seq;
+    std::vector<int64_t> time;
+  };
+
+  void
+  Submit();
+
+  void
+  WriterLoop();
+
+  /**
+   * \return false if a write or the flush failed, see m_error
+   */
+  bool
+  WriteBlock(const Columns& block);
+
+  /**
+   * \brief Stops the simulation with m_error, if the writer has set it
+   */
+  void
+  CheckError() const;
+
+  static void
+  OnTransmittedInterest(shared_ptr<const Interest> interest, Ptr<App> app, shared_ptr<Face> face);
+
+  static void
+  OnReceivedData(shared_ptr<const Data> data, Ptr<App> app, shared_ptr<Face> face);
+
+  static void
+  OnReceivedNack(shared_ptr<const lp::Nack> nack, Ptr<App> app, shared_ptr<Face> face);
+
+  static void
+  OnTimeout(Ptr<App> app, uint32_t seqno);
+
+  static void
+  RecordApp(Ptr<App> app, trace::EventType event, const Name& name);
+
+  static void
+  Destroy();
+
+private:
+  std::FILE* m_file;
+  std::string m_fileName;
+  size_t m_blockRecords;
+
+  std::unique_ptr<Columns> m_current;
+  std::vector<std::unique_ptr<Columns>> m_free; ///< \brief blocks ready to be filled
+  std::deque<std::unique_ptr<Columns>> m_full;  ///< \brief blocks waiting for the writer
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  bool m_closing;
+  std::string m_error; ///< \brief first write error, blocks after it are dropped
+  std::thread m_writer;
+
+  static BinaryTracer* s_instance;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_BINARY_TRACER_H
@@ -0,0 +1,341 @@
+#include "ndn-metrics.hpp"
+#include "ndn-app.hpp"
+
+#include "ns3/config.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+NS_LOG_COMPONENT_DEFINE("ndn.MetricsCollector");
+
+namespace ns3 {
+namespace ndn {
+
+LatencyHistogram::LatencyHistogram()
+  : m_count(0)
+  , m_max(0)
+{
+  m_counts.fill(0);
+}
+
+size_t
+LatencyHistogram::GetIndex(uint64_t value)
+{
+  if (value < LINEAR_BUCKETS)
+    return value;
+
+  int msb = 63 - __builtin_clzll(value);
+  int shift = msb - 4;
+  return LINEAR_BUCKETS + (shift - 1) * SUB_BUCKETS + ((value >> shift) - SUB_BUCKETS);
+}
+
+uint64_t
+LatencyHistogram::GetUpperBound(size_t index)
+{
+  if (index < LINEAR_BUCKETS)
+    return index;
+
+  int shift = (index - LINEAR_BUCKETS) / SUB_BUCKETS + 1;
+  uint64_t sub = (index - LINEAR_BUCKETS) % SUB_BUCKETS + SUB_BUCKETS;
+  return ((sub + 1) << shift) - 1;
+}
+
+void
+LatencyHistogram::Record(uint64_t value)
+{
+  m_counts[GetIndex(value)]++;
+  m_count++;
+  if (value > m_max)
+    m_max = value;
+}
+
+uint64_t
+LatencyHistogram::GetPercentile(double percentile) const
+{
+  if (m_count == 0)
+    return 0;
+
+  uint64_t target = static_cast<uint64_t>(std::ceil(percentile / 100.0 * m_count));
+  if (target == 0)
+    target = 1;
+
+  uint64_t seen = 0;
+  for (size_t i = 0; i < N_BUCKETS; i++) {
+    seen += m_counts[i];
+    if (seen >= target)
+      return std::min(GetUpperBound(i), m_max);
+  }
+  return m_max;
+}
+
+std::map<std::string, MetricsCollector::RoleMetrics> MetricsCollector::s_roles;
+MetricsCollector::SyncMetrics MetricsCollector::s_sync;
+std::map<uint32_t, Time> MetricsCollector::s_flagTimes;
+std::map<std::pair<uint32_t, std::string>, MetricsCollector::CacheMetrics> MetricsCollector::s_caches;
+std::string MetricsCollector::s_file;
+Time MetricsCollector::s_startTime;
+
+void
+MetricsCollector::Install(const std::string& file)
+{
+  s_roles.clear();
+  s_sync = SyncMetrics();
+  s_flagTimes.clear();
+  s_caches.clear();
+  s_file = file;
+  s_startTime = Simulator::Now();
+
+  static const char* consumers[] = {"ns3::ndn::ConsumerA", "ns3::ndn::PeerConsumer"};
+  for (const char* consumer : consumers) {
+    std::string path = std::string("/NodeList/*/ApplicationList/*/$") + consumer;
+    Config::ConnectWithoutContext(path + "/FirstInterestDataDelay",
+                                  MakeCallback(&MetricsCollector::FirstInterestDataDelay));
+    Config::ConnectWithoutContext(path + "/LastRetransmittedInterestDataDelay",
+                                  MakeCallback(&MetricsCollector::LastRetransmittedInterestDataDelay));
+    Config::ConnectWithoutContext(path + "/RetransmissionRecovered",
+                                  MakeCallback(&MetricsCollector::RetransmissionRecovered));
+  }
+  Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/$ns3::ndn::App/ReceivedDatas",
+                                MakeCallback(&MetricsCollector::ReceivedData));
+
+  Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/$ns3::ndn::ConsumerA/SyncRequested",
+                                MakeCallback(&MetricsCollector::SyncRequested));
+  Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/$ns3::ndn::ConsumerA/FilePushed",
+                                MakeCallback(&MetricsCollector::FilePushed));
+  Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/$ns3::ndn::ProducerA/FileFlagged",
+                                MakeCallback(&MetricsCollector::FileFlagged));
+  Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/$ns3::ndn::PeerConsumer/FileRecovered",
+                                MakeCallback(&MetricsCollector::FileRecovered));
+  Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/$ns3::ndn::ProxyReader/FileRead",
+                                MakeCallback(&MetricsCollector::FileRead));
+
+  // with context: the node id is only in the path
+  Config::Connect("/NodeList/*/$ns3::ndn::ContentStore/CacheHits",
+                  MakeCallback(&MetricsCollector::CacheHit));
+  Config::Connect("/NodeList/*/$ns3::ndn::ContentStore/CacheMisses",
+                  MakeCallback(&MetricsCollector::CacheMiss));
+  Config::Connect("/NodeList/*/$ns3::ndn::cs::Admission/CacheRejected",
+                  MakeCallback(&MetricsCollector::CacheRejected));
+
+  Simulator::ScheduleDestroy(&MetricsCollector::Dump);
+}
+
+MetricsCollector::RoleMetrics&
+MetricsCollector::GetRole(Ptr<App> app)
+{
+  return s_roles[app->GetInstanceTypeId().GetName()];
+}
+
+void
+MetricsCollector::FirstInterestDataDelay(Ptr<App> app, uint32_t seqno, Time delay,
+                                         uint32_t retxCount, int32_t hopCount)
+{
+  RoleMetrics& role = GetRole(app);
+  role.firstDelay.Record(delay.GetMicroSeconds());
+  role.retxCount.Record(retxCount);
+  role.hopCount.Record(hopCount < 0 ? 0 : hopCount);
+}
+
+void
+MetricsCollector::LastRetransmittedInterestDataDelay(Ptr<App> app, uint32_t seqno, Time delay,
+                                                     int32_t hopCount)
+{
+  GetRole(app).lastDelay.Record(delay.GetMicroSeconds());
+}
+
+void
+MetricsCollector::RetransmissionRecovered(Ptr<App> app, uint32_t seqno, Time recovery,
+                                          bool spurious)
+{
+  RoleMetrics& role = GetRole(app);
+  role.recovery.Record(recovery.GetMicroSeconds());
+  if (spurious)
+    role.spuriousRetx++;
+}
+
+void
+MetricsCollector::ReceivedData(shared_ptr<const Data> data, Ptr<App> app, shared_ptr<Face> face)
+{
+  RoleMetrics& role = GetRole(app);
+  role.receivedDatas++;
+  role.receivedBytes += data->wireEncode().size();
+}
+
+void
+MetricsCollector::SyncRequested(Ptr<App> app, uint32_t seqno)
+{
+  s_sync.syncInterests++;
+}
+
+void
+MetricsCollector::FileFlagged(Ptr<App> app, uint32_t file)
+{
+  s_sync.flaggedFiles++;
+  s_flagTimes.emplace(file, Simulator::Now());
+}
+
+void
+MetricsCollector::FilePushed(Ptr<App> app, uint32_t file)
+{
+  auto flagged = s_flagTimes.find(file);
+  if (flagged == s_flagTimes.end())
+    return;
+
+  s_sync.flagToPush.Record((Simulator::Now() - flagged->second).GetMicroSeconds());
+  s_flagTimes.erase(flagged);
+}
+
+void
+MetricsCollector::FileRecovered(Ptr<App> app, uint32_t file, bool fromPeer)
+{
+  if (fromPeer)
+    s_sync.recoveredFromPeers++;
+  else
+    s_sync.recoveredLocal++;
+  s_sync.lastRecovery = Simulator::Now();
+}
+
+void
+MetricsCollector::FileRead(Ptr<App> app, uint32_t file, Time delay)
+{
+  s_sync.proxyRead.Record(delay.GetMicroSeconds());
+}
+
+MetricsCollector::CacheMetrics&
+MetricsCollector::GetCache(const std::string& context, const Name& name)
+{
+  // context is /NodeList/<id>/...
+  uint32_t node = std::strtoul(context.c_str() + std::strlen("/NodeList/"), nullptr, 10);
+
+  size_t depth = 0;
+  while (depth < 2 && depth < name.size() && !name.at(depth).isSequenceNumber() &&
+         !name.at(depth).isNumber())
+    depth++;
+
+  return s_caches[std::make_pair(node, name.getPrefix(depth).toUri())];
+}
+
+void
+MetricsCollector::CacheHit(std::string context, shared_ptr<const Interest> interest,
+                           shared_ptr<const Data> data)
+{
+  GetCache(context, interest->getName()).hits++;
+}
+
+void
+MetricsCollector::CacheMiss(std::string context, shared_ptr<const Interest> interest)
+{
+  GetCache(context, interest->getName()).misses++;
+}
+
+void
+MetricsCollector::CacheRejected(std::string context, shared_ptr<const Data> data)
+{
+  GetCache(context, data->getName()).rejected++;
+}
+
+void
+MetricsCollector::Print(std::ostream& os)
+{
+  double duration = (Simulator::Now() - s_startTime).GetSeconds();
+
+  os << "Role\tMetric\tCount\tp50\tp99\tp999\tMax\n";
+  for (const auto& entry : s_roles) {
+    const RoleMetrics& role = entry.second;
+    const std::pair<const char*, const LatencyHistogram*> histograms[] =
+      {{"FirstDelay(us)", &role.firstDelay},
+       {"LastDelay(us)", &role.lastDelay},
+       {"RetxCount", &role.retxCount},
+       {"HopCount", &role.hopCount},
+       {"Recovery(us)", &role.recovery}};
+
+    for (const auto& histogram : histograms) {
+      const LatencyHistogram& h = *histogram.second;
+      os << entry.first << "\t" << histogram.first << "\t" << h.GetCount() << "\t"
+         << h.GetPercentile(50) << "\t" << h.GetPercentile(99) << "\t" << h.GetPercentile(99.9)
+         << "\t" << h.GetMax() << "\n";
+    }
+    if (role.recovery.GetCount() > 0) {
+      os << entry.first << "\tSpuriousRetx\t" << role.spuriousRetx << " of "
+         << role.recovery.GetCount() << " recovered\n";
+    }
+    if (duration > 0) {
+      os << entry.first << "\tThroughput\t" << role.receivedDatas << " Data\t"
+         << role.receivedDatas / duration << " Data/s\t" << role.receivedBytes * 8 / duration / 1000
+         << " kbps\n";
+    }
+  }
+
+  if (s_sync.syncInterests > 0 || s_sync.flaggedFiles > 0) {
+    const LatencyHistogram& h = s_sync.flagToPush;
+    os << "Sync\tSyncInterests\t" << s_sync.syncInterests << "\n"
+       << "Sync\tFlaggedFiles\t" << s_sync.flaggedFiles << "\n"
+       << "Sync\tFlagToPush(us)\t" << h.GetCount() << "\t" << h.GetPercentile(50) << "\t"
+       << h.GetPercentile(99) << "\t" << h.GetPercentile(99.9) << "\t" << h.GetMax() << "\n";
+  }
+
+  if (s_sync.recoveredLocal > 0 || s_sync.recoveredFromPeers > 0) {
+    os << "Recovery\tFromProducerA\t" << s_sync.recoveredLocal << "\n"
+       << "Recovery\tFromPeers\t" << s_sync.recoveredFromPeers << "\n"
+       << "Recovery\tLastFile(s)\t" << s_sync.lastRecovery.GetSeconds() << "\n";
+  }
+
+  if (s_sync.proxyRead.GetCount() > 0) {
+    const LatencyHistogram& h = s_sync.proxyRead;
+    os << "Recovery\tProxyRead(us)\t" << h.GetCount() << "\t" << h.GetPercentile(50) << "\t"
+       << h.GetPercentile(99) << "\t" << h.GetPercentile(99.9) << "\t" << h.GetMax() << "\n";
+  }
+
+  // nodes without a cache only miss, so they are left out of the per-node lines
+  std::map<std::string, CacheMetrics> prefixes;
+  bool caching = false;
+  for (const auto& entry : s_caches) {
+    CacheMetrics& total = prefixes[entry.first.second];
+    total.hits += entry.second.hits;
+    total.misses += entry.second.misses;
+    total.rejected += entry.second.rejected;
+    caching = caching || entry.second.hits > 0 || entry.second.rejected > 0;
+  }
+
+  auto printCache = [&os](const std::string& node, const std::string& prefix,
+                          const CacheMetrics& cache) {
+    uint64_t lookups = cache.hits + cache.misses;
+    os << "Cache\t" << node << "\t" << prefix << "\t" << cache.hits << " hits\t" << lookups
+       << " lookups\t" << (lookups > 0 ? static_cast<double>(cache.hits) / lookups : 0.0)
+       << " hit ratio\t" << cache.rejected << " rejected\n";
+  };
+
+  if (caching) {
+    for (const auto& entry : s_caches) {
+      if (entry.second.hits > 0 || entry.second.rejected > 0)
+        printCache("Node" + std::to_string(entry.first.first), entry.first.second, entry.second);
+    }
+    for (const auto& prefix : prefixes)
+      printCache("All", prefix.first, prefix.second);
+  }
+}
+
+void
+MetricsCollector::Dump()
+{
+  if (s_file.empty()) {
+    Print(std::cout);
+    return;
+  }
+
+  std::ofstream os(s_file.c_str());
+  if (!os.is_open()) {
+    NS_LOG_ERROR("Cannot open " << s_file << " for writing metrics");
+    return;
+  }
+  Print(os);
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,184 @@
+#ifndef NDN_METRICS_H
+#define NDN_METRICS_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+#include <array>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+
+namespace ns3 {
+namespace ndn {
+
+class App;
+
+/**
+ * @brief Fixed-memory histogram with HDR-style log-linear buckets
+ *
+ * Values below 32 are counted exactly, larger values land in one of 16 sub-buckets per power of
+ * two, which keeps the relative error of every percentile below 1/16 for the whole uint64_t range
+ * in 8KB.
+ */
+class LatencyHistogram {
+public:
+  LatencyHistogram();
+
+  void
+  Record(uint64_t value);
+
+  uint64_t
+  GetCount() const
+  {
+    return m_count;
+  }
+
+  uint64_t
+  GetMax() const
+  {
+    return m_max;
+  }
+
+  /**
+   * @brief Returns an upper bound of the value below which @p percentile percent of samples fall
+   */
+  uint64_t
+  GetPercentile(double percentile) const;
+
+private:
+  static size_t
+  GetIndex(uint64_t value);
+
+  static uint64_t
+  GetUpperBound(size_t index);
+
+private:
+  static const size_t LINEAR_BUCKETS = 32;
+  static const size_t SUB_BUCKETS = 16;
+  static const size_t N_BUCKETS = LINEAR_BUCKETS + 59 * SUB_BUCKETS;
+
+  std::array<uint64_t, N_BUCKETS> m_counts;
+  uint64_t m_count;
+  uint64_t m_max;
+};
+
+/**
+ * @brief Collects Interest/Data delay metrics of all consumer apps
+ *
+ * Install() connects to the FirstInterestDataDelay and LastRetransmittedInterestDataDelay trace
+ * sources of ConsumerA and PeerConsumer and to ReceivedDatas of every app. Delays (in
+ * microseconds), retransmission and hop counts go into one set of histograms per role (app
+ * TypeId), so memory does not grow with the number of apps. At Simulator::Destroy the collector
+ * prints p50/p99/p999 and the Data throughput of each role, plus how long retransmitted
+ * sequence numbers took to recover and how many of those retransmissions were spurious.
+ *
+ * It also counts the sync Interests of ConsumerA and the latency from ProducerA flagging a file
+ * to ConsumerA pushing its original, which compares polling against the Notify mode.
+ *
+ * Content store hits, misses and admission rejections are counted per node and per prefix (the
+ * leading name components up to the first number, at most two), so the summary shows how many
+ * Interests caches answered before they reached a producer.
+ */
+class MetricsCollector {
+public:
+  /**
+   * @brief Enables the collector for the current simulation
+   * @param file output file, empty for stdout
+   */
+  static void
+  Install(const std::string& file = "");
+
+  static void
+  Print(std::ostream& os);
+
+private:
+  struct RoleMetrics {
+    LatencyHistogram firstDelay;
+    LatencyHistogram lastDelay;
+    LatencyHistogram retxCount;
+    LatencyHistogram hopCount;
+    LatencyHistogram recovery; ///< microseconds from the first retransmission to the Data
+    uint64_t spuriousRetx = 0; ///< recoveries where the Data answered an earlier copy
+    uint64_t receivedDatas = 0;
+    uint64_t receivedBytes = 0;
+  };
+
+  static RoleMetrics&
+  GetRole(Ptr<App> app);
+
+  static void
+  FirstInterestDataDelay(Ptr<App> app, uint32_t seqno, Time delay, uint32_t retxCount,
+                         int32_t hopCount);
+
+  static void
+  LastRetransmittedInterestDataDelay(Ptr<App> app, uint32_t seqno, Time delay, int32_t hopCount);
+
+  static void
+  RetransmissionRecovered(Ptr<App> app, uint32_t seqno, Time recovery, bool spurious);
+
+  static void
+  ReceivedData(shared_ptr<const Data> data, Ptr<App> app, shared_ptr<Face> face);
+
+  static void
+  SyncRequested(Ptr<App> app, uint32_t seqno);
+
+  static void
+  FileFlagged(Ptr<App> app, uint32_t file);
+
+  static void
+  FilePushed(Ptr<App> app, uint32_t file);
+
+  static void
+  FileRecovered(Ptr<App> app, uint32_t file, bool fromPeer);
+
+  static void
+  FileRead(Ptr<App> app, uint32_t file, Time delay);
+
+  static void
+  CacheHit(std::string context, shared_ptr<const Interest> interest, shared_ptr<const Data> data);
+
+  static void
+  CacheMiss(std::string context, shared_ptr<const Interest> interest);
+
+  static void
+  CacheRejected(std::string context, shared_ptr<const Data> data);
+
+  static void
+  Dump();
+
+private:
+  struct SyncMetrics {
+    uint64_t syncInterests = 0;
+    uint64_t flaggedFiles = 0;
+    LatencyHistogram flagToPush; ///< microseconds
+    uint64_t recoveredLocal = 0;     ///< originals a PeerConsumer got through ProducerA's push
+    uint64_t recoveredFromPeers = 0; ///< originals fetched from another peer's PeerProducer
+    Time lastRecovery;               ///< time of the last recovered file
+    LatencyHistogram proxyRead;      ///< microseconds from ProxyReader start to each file read
+  };
+
+  struct CacheMetrics {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t rejected = 0; ///< Data refused by the admission of AdmissionContentStore
+  };
+
+  static CacheMetrics&
+  GetCache(const std::string& context, const Name& name);
+
+  static std::map<std::string, RoleMetrics> s_roles;
+  static SyncMetrics s_sync;
+  static std::map<uint32_t, Time> s_flagTimes; ///< \brief file -> time ProducerA flagged it
+  static std::map<std::pair<uint32_t, std::string>, CacheMetrics> s_caches; ///< (node, prefix)
+  static std::string s_file;
+  static Time s_startTime;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_METRICS_H
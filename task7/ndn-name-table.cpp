@@ -0,0 +1,130 @@
+#include "ndn-name-table.hpp"
+
+#include <limits>
+
+namespace ns3 {
+namespace ndn {
+
+NameTable::Table::Table()
+  : ids(IdLess{&names})
+{
+  // id 0 is the root, the Name of a default constructed InternedName
+  names.push_back(Name());
+  ids.insert(0);
+}
+
+NameTable::Table&
+NameTable::GetTable()
+{
+  // constructed on first use: attributes may be set from static initializers of other units
+  static Table table;
+  return table;
+}
+
+uint32_t
+NameTable::Intern(const Name& name)
+{
+  Table& table = GetTable();
+  auto id = table.ids.find(name);
+  if (id != table.ids.end())
+    return *id;
+
+  table.names.push_back(name);
+  table.ids.insert(table.names.size() - 1);
+  return table.names.size() - 1;
+}
+
+namespace names {
+
+const Name&
+PrefixPeer()
+{
+  static const InternedName name(Name("/prefix/peer"));
+  return name.Get();
+}
+
+const Name&
+PrefixMetadata()
+{
+  static const InternedName name(Name("/prefix/metadata"));
+  return name.Get();
+}
+
+const Name&
+PrefixFile()
+{
+  static const InternedName name(Name("/prefix/file"));
+  return name.Get();
+}
+
+const Name&
+PrefixFileSync()
+{
+  static const InternedName name(Name("/prefix/file/sync"));
+  return name.Get();
+}
+
+const Name&
+Proxy(uint32_t index)
+{
+  static const InternedName proxies[] = {InternedName(Name("/cnn")), InternedName(Name("/bbc")),
+                                         InternedName(Name("/nytimes"))};
+  return proxies[index % 3].Get();
+}
+
+const name::Component&
+Metadata()
+{
+  static const name::Component component("metadata");
+  return component;
+}
+
+const name::Component&
+File()
+{
+  static const name::Component component("file");
+  return component;
+}
+
+const name::Component&
+LocalSync()
+{
+  static const name::Component component("local_sync");
+  return component;
+}
+
+const name::Component&
+SummaryVector()
+{
+  static const name::Component component("sv");
+  return component;
+}
+
+const name::Component&
+Notify()
+{
+  static const name::Component component("notify");
+  return component;
+}
+
+name::Component
+FileId(uint32_t fileNumber)
+{
+  return name::Component::fromSequenceNumber(fileNumber);
+}
+
+bool
+ParseFileId(const name::Component& component, uint32_t& fileNumber)
+{
+  if (!component.isSequenceNumber() ||
+      component.toSequenceNumber() > std::numeric_limits<uint32_t>::max())
+    return false;
+
+  fileNumber = static_cast<uint32_t>(component.toSequenceNumber());
+  return true;
+}
+
+} // namespace names
+
+} // namespace ndn
+} // namespace ns3
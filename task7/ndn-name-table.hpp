@@ -0,0 +1,276 @@
+#ifndef NDN_NAME_TABLE_H
+#define NDN_NAME_TABLE_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ns3/attribute-accessor-helper.h"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <set>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Process-wide table of immutable Names
+ *
+ * Every distinct Name is stored once, at a stable address, and never removed. Apps keep the
+ * Names of their attributes (prefixes, peer names, key locators) as InternedName handles of
+ * 4 bytes, so 100k peers with the prefix /prefix/ share one parsed Name instead of holding 100k
+ * copies with their encoding buffers.
+ */
+class NameTable {
+public:
+  /**
+   * @brief Returns the id of @p name, adding it to the table if it is new
+   */
+  static uint32_t
+  Intern(const Name& name);
+
+  static const Name&
+  Get(uint32_t id)
+  {
+    return GetTable().names[id];
+  }
+
+  /**
+   * @brief Number of distinct Names interned so far
+   */
+  static size_t
+  GetN()
+  {
+    return GetTable().names.size();
+  }
+
+private:
+  /// @cond include_hidden
+  /**
+   * @brief Orders ids by their Names, and finds the id of a Name without a copy of it
+   */
+  struct IdLess {
+    typedef void is_transparent;
+
+    const std::deque<Name>* names;
+
+    bool
+    operator()(uint32_t a, uint32_t b) const
+    {
+      return (*names)[a] < (*names)[b];
+    }
+
+    bool
+    operator()(uint32_t a, const Name& b) const
+    {
+      return (*names)[a] < b;
+    }
+
+    bool
+    operator()(const Name& a, uint32_t b) const
+    {
+      return a < (*names)[b];
+    }
+  };
+
+  struct Table {
+    Table();
+
+    std::deque<Name> names;         ///< by id, a deque so that Get() references stay valid
+    std::set<uint32_t, IdLess> ids; ///< all ids, ordered by Name
+  };
+  /// @endcond
+
+  static Table&
+  GetTable();
+};
+
+/**
+ * @brief Handle of a Name in the NameTable, 4 bytes, compared by id
+ *
+ * A default constructed handle refers to the root Name "/".
+ */
+class InternedName {
+public:
+  InternedName()
+    : m_id(0)
+  {
+  }
+
+  explicit InternedName(const Name& name)
+    : m_id(NameTable::Intern(name))
+  {
+  }
+
+  const Name&
+  Get() const
+  {
+    return NameTable::Get(m_id);
+  }
+
+  uint32_t
+  GetId() const
+  {
+    return m_id;
+  }
+
+  bool
+  operator==(InternedName other) const
+  {
+    return m_id == other.m_id;
+  }
+
+  bool
+  operator!=(InternedName other) const
+  {
+    return m_id != other.m_id;
+  }
+
+  /**
+   * @brief Orders by id, i.e. by first use, not by Name: for maps keyed by handle
+   */
+  bool
+  operator<(InternedName other) const
+  {
+    return m_id < other.m_id;
+  }
+
+private:
+  uint32_t m_id;
+};
+
+inline std::ostream&
+operator<<(std::ostream& os, InternedName name)
+{
+  return os << name.Get();
+}
+
+/**
+ * @brief Like MakeNameAccessor(&T::m_name), for a member that is an InternedName
+ *
+ * The attribute still takes and returns a NameValue (and strings through the Name checker).
+ */
+template<class T>
+Ptr<const AttributeAccessor>
+MakeInternedNameAccessor(InternedName T::*member)
+{
+  class MemberAccessor : public AccessorHelper<T, NameValue> {
+  public:
+    explicit MemberAccessor(InternedName T::*member)
+      : m_member(member)
+    {
+    }
+
+  private:
+    virtual bool
+    DoSet(T* object, const NameValue* value) const
+    {
+      object->*m_member = InternedName(value->Get());
+      return true;
+    }
+
+    virtual bool
+    DoGet(const T* object, NameValue* value) const
+    {
+      value->Set((object->*m_member).Get());
+      return true;
+    }
+
+    virtual bool
+    HasGetter() const
+    {
+      return true;
+    }
+
+    virtual bool
+    HasSetter() const
+    {
+      return true;
+    }
+
+    InternedName T::*m_member;
+  };
+
+  return Ptr<const AttributeAccessor>(new MemberAccessor(member), false);
+}
+
+/**
+ * @brief Names and components of the scenario namespace, built once on first use
+ *
+ * The apps append to and compare against these instead of string literals, which ndn-cxx would
+ * parse again on every packet. The Names are interned, so they are also shared with attributes set
+ * to the same prefix.
+ */
+namespace names {
+
+const Name&
+PrefixPeer(); ///< /prefix/peer, PeerProducers and their local_sync
+
+const Name&
+PrefixMetadata(); ///< /prefix/metadata
+
+const Name&
+PrefixFile(); ///< /prefix/file
+
+const Name&
+PrefixFileSync(); ///< /prefix/file/sync
+
+/**
+ * @brief /cnn, /bbc and /nytimes, by @p index modulo 3
+ */
+const Name&
+Proxy(uint32_t index);
+
+const name::Component&
+Metadata(); ///< metadata
+
+const name::Component&
+File(); ///< file
+
+const name::Component&
+LocalSync(); ///< local_sync
+
+const name::Component&
+SummaryVector(); ///< sv
+
+const name::Component&
+Notify(); ///< notify
+
+/**
+ * @brief Component of a file number, a sequence-number TLV rather than a zero-padded decimal
+ *
+ * Used wherever a name addresses a file (/prefix/file, local_sync, peer files, proxy pushes and
+ * blocks), so file numbers are not limited by a string width.
+ */
+name::Component
+FileId(uint32_t fileNumber);
+
+/**
+ * @brief Reads a component made by FileId()
+ * @return false, leaving @p fileNumber unchanged, if @p component is not a 32-bit sequence number
+ */
+bool
+ParseFileId(const name::Component& component, uint32_t& fileNumber);
+
+} // namespace names
+
+} // namespace ndn
+} // namespace ns3
+
+namespace std {
+
+/**
+ * @brief Hash of the id, no pass over the Name
+ */
+template<>
+struct hash<ns3::ndn::InternedName> {
+  size_t
+  operator()(ns3::ndn::InternedName name) const
+  {
+    return std::hash<uint32_t>()(name.GetId());
+  }
+};
+
+} // namespace std
+
+#endif // NDN_NAME_TABLE_H
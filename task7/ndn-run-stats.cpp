@@ -0,0 +1,64 @@
+#include "ndn-run-stats.hpp"
+
+#include "ns3/config.h"
+#include "ns3/simulator.h"
+
+#include <iostream>
+
+#include <sys/resource.h>
+
+namespace ns3 {
+namespace ndn {
+
+std::chrono::steady_clock::time_point RunStats::s_wallStart;
+uint64_t RunStats::s_packets = 0;
+
+void
+RunStats::Install()
+{
+  s_packets = 0;
+
+  Config::ConnectWithoutContext("/NodeList/*/$ns3::ndn::L3Protocol/InInterests",
+                                MakeCallback(&RunStats::CountInterest));
+  Config::ConnectWithoutContext("/NodeList/*/$ns3::ndn::L3Protocol/InData",
+                                MakeCallback(&RunStats::CountData));
+
+  Simulator::ScheduleDestroy(&RunStats::Dump);
+  s_wallStart = std::chrono::steady_clock::now();
+}
+
+void
+RunStats::CountInterest(const Interest& interest, const Face& face)
+{
+  s_packets++;
+}
+
+void
+RunStats::CountData(const Data& data, const Face& face)
+{
+  s_packets++;
+}
+
+void
+RunStats::Print(std::ostream& os)
+{
+  double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - s_wallStart).count();
+  uint64_t events = Simulator::GetEventCount();
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+
+  os << "RunStats wall_s=" << wall << " events=" << events
+     << " events_per_s=" << (wall > 0 ? events / wall : 0.0) << " packets=" << s_packets
+     << " packets_per_s=" << (wall > 0 ? s_packets / wall : 0.0)
+     << " max_rss_kb=" << usage.ru_maxrss << "\n";
+}
+
+void
+RunStats::Dump()
+{
+  Print(std::cerr);
+}
+
+} // namespace ndn
+} // namespace ns3
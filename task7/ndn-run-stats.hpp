@@ -0,0 +1,51 @@
+#ifndef NDN_RUN_STATS_H
+#define NDN_RUN_STATS_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Cost of a simulation run, for the benchmark harness (scenario-benchmark.py)
+ *
+ * Install() starts the wall clock and counts the Interests and Data received by the forwarders
+ * of all nodes. When Simulator::Destroy is called, one line is printed to stderr:
+ *
+ *     RunStats wall_s=<s> events=<n> events_per_s=<n/s> packets=<n> packets_per_s=<n/s> max_rss_kb=<kB>
+ *
+ * events is the number of events the simulator executed and max_rss_kb the peak resident set
+ * size of the process. Call Install() right before Simulator::Run(), after the topology and the
+ * apps are set up, so that only the run itself is timed.
+ */
+class RunStats {
+public:
+  static void
+  Install();
+
+  static void
+  Print(std::ostream& os);
+
+private:
+  static void
+  CountInterest(const Interest& interest, const Face& face);
+
+  static void
+  CountData(const Data& data, const Face& face);
+
+  static void
+  Dump();
+
+private:
+  static std::chrono::steady_clock::time_point s_wallStart;
+  static uint64_t s_packets;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_RUN_STATS_H
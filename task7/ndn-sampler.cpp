@@ -0,0 +1,80 @@
+#include "ndn-sampler.hpp"
+#include "ndn-app.hpp"
+#include "ndn-binary-tracer.hpp"
+
+#include "ns3/node-list.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/queue.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include "model/cs/ndn-content-store.hpp"
+#include "model/ndn-l3-protocol.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+BinaryTracer* Sampler::s_tracer = nullptr;
+Time Sampler::s_interval;
+EventId Sampler::s_event;
+
+void
+Sampler::Install(const std::string& file, Time interval, size_t blockRecords)
+{
+  delete s_tracer;
+  s_tracer = new BinaryTracer(file, blockRecords, 4);
+  s_interval = interval;
+
+  Simulator::Cancel(s_event);
+  s_event = Simulator::ScheduleNow(&Sampler::Sample);
+  Simulator::ScheduleDestroy(&Sampler::Destroy);
+}
+
+void
+Sampler::Sample()
+{
+  Time now = Simulator::Now();
+
+  for (NodeList::Iterator it = NodeList::Begin(); it != NodeList::End(); ++it) {
+    Ptr<Node> node = *it;
+    uint32_t id = node->GetId();
+
+    for (uint32_t i = 0; i < node->GetNDevices(); i++) {
+      Ptr<PointToPointNetDevice> device = DynamicCast<PointToPointNetDevice>(node->GetDevice(i));
+      if (device)
+        s_tracer->Record(id, i, trace::EVENT_SAMPLE_QUEUE, 0, device->GetQueue()->GetNPackets(),
+                         now);
+    }
+
+    Ptr<L3Protocol> l3 = node->GetObject<L3Protocol>();
+    if (l3) {
+      s_tracer->Record(id, 0, trace::EVENT_SAMPLE_PIT, 0, l3->getForwarder()->getPit().size(), now);
+
+      // with SetOldContentStore the forwarder's own Cs stays empty
+      Ptr<ContentStore> cs = node->GetObject<ContentStore>();
+      uint32_t csSize = cs ? cs->GetSize() : l3->getForwarder()->getCs().size();
+      s_tracer->Record(id, 0, trace::EVENT_SAMPLE_CS, 0, csSize, now);
+    }
+
+    for (uint32_t i = 0; i < node->GetNApplications(); i++) {
+      Ptr<App> app = DynamicCast<App>(node->GetApplication(i));
+      UintegerValue outstanding;
+      if (app && app->GetAttributeFailSafe("OutstandingInterests", outstanding))
+        s_tracer->Record(id, app->GetId(), trace::EVENT_SAMPLE_OUTSTANDING, 0, outstanding.Get(),
+                         now);
+    }
+  }
+
+  s_event = Simulator::Schedule(s_interval, &Sampler::Sample);
+}
+
+void
+Sampler::Destroy()
+{
+  Simulator::Cancel(s_event);
+  delete s_tracer;
+  s_tracer = nullptr;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,52 @@
+#ifndef NDN_SAMPLER_H
+#define NDN_SAMPLER_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+
+#include <string>
+
+namespace ns3 {
+namespace ndn {
+
+class BinaryTracer;
+
+/**
+ * @brief Samples queue, PIT, content store and consumer occupancy of every node periodically
+ *
+ * Every @p interval it records, for each node:
+ *
+ * - the packets in the queue of each point-to-point device, to find the links whose 20p queues
+ *   fill up,
+ * - the PIT entries and the content store entries,
+ * - the OutstandingInterests of each app that has this attribute (the ConsumerEngine apps).
+ *
+ * Samples go through a BinaryTracer of their own, i.e. into a bounded ring of column blocks
+ * that a writer thread flushes to @p file, so memory does not grow with the run. The file has
+ * the layout of ndn-binary-trace-format.hpp (EVENT_SAMPLE_* records) and ndn-trace-to-csv reads
+ * it.
+ */
+class Sampler {
+public:
+  static void
+  Install(const std::string& file, Time interval, size_t blockRecords = 16384);
+
+private:
+  static void
+  Sample();
+
+  static void
+  Destroy();
+
+private:
+  static BinaryTracer* s_tracer;
+  static Time s_interval;
+  static EventId s_event;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_SAMPLER_H
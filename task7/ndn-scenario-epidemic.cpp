@@ -0,0 +1,210 @@
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/ndnSIM-module.h"
+#include "ns3/ndnSIM/apps/ndn-app-profile.hpp"
+#include "ns3/ndnSIM/apps/ndn-run-stats.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <vector>
+
+namespace ns3 {
+
+static uint64_t g_originFileDatas = 0;
+static uint64_t g_peerFileDatas = 0;
+static std::map<uint32_t, Time> g_startTimes; ///< node id -> start of its PeerConsumer
+static std::vector<double> g_completionTimes; ///< seconds from start to the last file, per peer
+
+static void
+OriginData(shared_ptr<const ndn::Data> data, Ptr<ndn::App>, shared_ptr<ndn::Face>)
+{
+  if (data->getName().get(1) == ndn::name::Component("file"))
+    g_originFileDatas++;
+}
+
+static void
+PeerData(shared_ptr<const ndn::Data> data, Ptr<ndn::App>, shared_ptr<ndn::Face>)
+{
+  if (data->getName().size() > 3 && data->getName().get(3) == ndn::name::Component("file"))
+    g_peerFileDatas++;
+}
+
+static void
+RangeCompleted(Ptr<ndn::App> app)
+{
+  Time start = g_startTimes[app->GetNode()->GetId()];
+  g_completionTimes.push_back((Simulator::Now() - start).GetSeconds());
+}
+
+static std::string
+PeerName(uint32_t node)
+{
+  return "P" + std::to_string(node);
+}
+
+// Epidemic dissemination of the files of one origin among nPeers peers.
+//
+// Node 0 runs ProducerA (metadata and files), nodes 1..nPeers each run a PeerConsumer and a
+// PeerProducer and form a tree of the given degree below it. Every peer gets the same range, so
+// all of them want every file. With fanout > 0 each peer gossips with its tree neighbours: it polls
+// the state vector of fanout random neighbours per round, takes files from whichever holds them
+// and re-serves everything it validated. With fanout=0 every file comes from the origin.
+//
+// Reports the file Data sent by the origin and by peers and the CDF of the per-peer completion
+// time (start of the PeerConsumer to its last file).
+int
+main(int argc, char* argv[])
+{
+  uint32_t nPeers = 1000;
+  uint32_t degree = 4;
+  uint32_t nFiles = 10;
+  uint32_t fanout = 2;
+  uint32_t maxFilesInFlight = 3;
+  double startSpread = 10.0;
+  double simTime = 120.0;
+  std::string dataRate = "10Mbps";
+  std::string delay = "5ms";
+  std::string queueSize = "100p";
+  double frequency = 1.0;
+  std::string cdfFile = "";
+  std::string profileFile = "";
+
+  CommandLine cmd;
+  cmd.AddValue("nPeers", "Number of peers", nPeers);
+  cmd.AddValue("degree", "Children per node of the distribution tree", degree);
+  cmd.AddValue("nFiles", "Files every peer has to get (at most 255)", nFiles);
+  cmd.AddValue("fanout", "Neighbours polled per round, 0 disables gossip", fanout);
+  cmd.AddValue("maxFilesInFlight", "Files each PeerConsumer fetches concurrently", maxFilesInFlight);
+  cmd.AddValue("startSpread", "Peers start uniformly within this many seconds", startSpread);
+  cmd.AddValue("simTime", "Simulated time in seconds", simTime);
+  cmd.AddValue("dataRate", "DataRate of every point-to-point link", dataRate);
+  cmd.AddValue("delay", "Delay of every point-to-point channel", delay);
+  cmd.AddValue("queueSize", "MaxSize of the queue of every link (e.g. 20p)", queueSize);
+  cmd.AddValue("frequency", "Interests per second of each PeerConsumerCbr", frequency);
+  cmd.AddValue("cdfFile", "File for the completion time CDF (seconds, fraction), none if empty", cdfFile);
+  cmd.AddValue("profileFile", "Folded stacks of the app handlers (needs NDN_APP_PROFILE_ENABLED=1), disabled if empty", profileFile);
+  cmd.Parse(argc, argv);
+
+  Config::SetDefault("ns3::PointToPointNetDevice::DataRate", StringValue(dataRate));
+  Config::SetDefault("ns3::PointToPointChannel::Delay", StringValue(delay));
+  Config::SetDefault("ns3::QueueBase::MaxSize", StringValue(queueSize));
+
+  NodeContainer nodes;
+  nodes.Create(nPeers + 1);
+
+  PointToPointHelper p2p;
+  for (uint32_t i = 1; i <= nPeers; i++) {
+    p2p.Install(nodes.Get((i - 1) / degree), nodes.Get(i));
+  }
+
+  ndn::StackHelper ndnHelper;
+  ndnHelper.SetOldContentStore("ns3::ndn::cs::Nocache");
+  ndnHelper.InstallAll();
+
+  ndn::StrategyChoiceHelper::InstallAll("/prefix", "/localhost/nfd/strategy/best-route");
+
+  // origin prefixes point up the tree, peer prefixes to the neighbour that serves them
+  for (uint32_t i = 1; i <= nPeers; i++) {
+    uint32_t parent = (i - 1) / degree;
+    ndn::FibHelper::AddRoute(nodes.Get(i), "/prefix/metadata", nodes.Get(parent), 1);
+    ndn::FibHelper::AddRoute(nodes.Get(i), "/prefix/file", nodes.Get(parent), 1);
+    ndn::FibHelper::AddRoute(nodes.Get(parent), "/prefix/peer/" + PeerName(i), nodes.Get(i), 1);
+    if (parent != 0)
+      ndn::FibHelper::AddRoute(nodes.Get(i), "/prefix/peer/" + PeerName(parent), nodes.Get(parent), 1);
+  }
+
+  ndn::AppHelper producerAMetaDataHelper("ns3::ndn::ProducerA");
+  producerAMetaDataHelper.SetPrefix("/prefix/metadata");
+  producerAMetaDataHelper.SetAttribute("RangeSize", UintegerValue(nFiles));
+  producerAMetaDataHelper.Install(nodes.Get(0));
+
+  ndn::AppHelper producerAFileHelper("ns3::ndn::ProducerA");
+  producerAFileHelper.SetPrefix("/prefix/file");
+  producerAFileHelper.Install(nodes.Get(0));
+
+  Ptr<UniformRandomVariable> start = CreateObject<UniformRandomVariable>();
+  for (uint32_t i = 1; i <= nPeers; i++) {
+    std::string neighbours;
+    if (fanout > 0) {
+      uint32_t parent = (i - 1) / degree;
+      if (parent != 0)
+        neighbours = PeerName(parent);
+      for (uint32_t child = i * degree + 1; child <= std::min(nPeers, i * degree + degree); child++)
+        neighbours += (neighbours.empty() ? "" : ",") + PeerName(child);
+    }
+
+    // every peer uses the key of B, so all of them get the same range of files
+    ndn::AppHelper consumerHelper("ns3::ndn::PeerConsumerCbr");
+    consumerHelper.SetPrefix("/prefix/");
+    consumerHelper.SetAttribute("PeerKey", StringValue("10001"));
+    consumerHelper.SetAttribute("PeerName", StringValue(PeerName(i)));
+    consumerHelper.SetAttribute("SyncPeers", StringValue(neighbours));
+    consumerHelper.SetAttribute("GossipFanout", UintegerValue(fanout));
+    consumerHelper.SetAttribute("PushToProxy", BooleanValue(false));
+    consumerHelper.SetAttribute("Frequency", DoubleValue(frequency));
+    consumerHelper.SetAttribute("MaxFilesInFlight", UintegerValue(maxFilesInFlight));
+    ApplicationContainer consumer = consumerHelper.Install(nodes.Get(i));
+
+    g_startTimes[nodes.Get(i)->GetId()] = Seconds(start->GetValue(0, startSpread));
+    consumer.Start(g_startTimes[nodes.Get(i)->GetId()]);
+
+    ndn::AppHelper producerHelper("ns3::ndn::PeerProducer");
+    producerHelper.SetPrefix("/prefix/peer");
+    producerHelper.SetAttribute("PeerName", StringValue(PeerName(i)));
+    producerHelper.Install(nodes.Get(i));
+  }
+
+  Config::ConnectWithoutContext("/NodeList/0/ApplicationList/*/$ns3::ndn::ProducerA/TransmittedDatas",
+                                MakeCallback(&OriginData));
+  Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/$ns3::ndn::PeerProducer/TransmittedDatas",
+                                MakeCallback(&PeerData));
+  Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/$ns3::ndn::PeerConsumer/RangeCompleted",
+                                MakeCallback(&RangeCompleted));
+
+  Simulator::Stop(Seconds(simTime));
+
+  if (!profileFile.empty())
+    ndn::AppProfiler::Install(profileFile);
+  ndn::RunStats::Install();
+  auto wallStart = std::chrono::steady_clock::now();
+  Simulator::Run();
+  double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+  Simulator::Destroy();
+
+  std::sort(g_completionTimes.begin(), g_completionTimes.end());
+
+  std::cout << "peers: " << nPeers << ", fanout: " << fanout << ", files: " << nFiles << "\n"
+            << "file Data from origin: " << g_originFileDatas << ", from peers: " << g_peerFileDatas
+            << "\n"
+            << "completed: " << g_completionTimes.size() << "/" << nPeers << "\n";
+
+  const double percentiles[] = {10, 50, 90, 99, 100};
+  for (double percentile : percentiles) {
+    if (g_completionTimes.empty())
+      break;
+    size_t index = std::min(g_completionTimes.size() - 1,
+                            static_cast<size_t>(percentile / 100 * g_completionTimes.size()));
+    std::cout << "completion p" << percentile << ": " << g_completionTimes[index] << " s\n";
+  }
+  std::cout << "wall: " << wall << " s\n";
+
+  if (!cdfFile.empty()) {
+    std::ofstream os(cdfFile.c_str());
+    for (size_t i = 0; i < g_completionTimes.size(); i++)
+      os << g_completionTimes[i] << "\t" << static_cast<double>(i + 1) / nPeers << "\n";
+  }
+
+  return 0;
+}
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+  return ns3::main(argc, argv);
+}
@@ -4,25 +4,151 @@
 #include "ns3/network-module.h"
 #include "ns3/point-to-point-module.h"
 #include "ns3/ndnSIM-module.h"
+#include "ns3/ndnSIM/apps/ndn-app-installer.hpp"
+#include "ns3/ndnSIM/apps/ndn-app-snapshot.hpp"
+#include "ns3/ndnSIM/apps/ndn-binary-tracer.hpp"
+#include "ns3/ndnSIM/apps/ndn-metrics.hpp"
+#include "ns3/ndnSIM/apps/ndn-app-profile.hpp"
+#include "ns3/ndnSIM/apps/ndn-run-stats.hpp"
+#include "ns3/ndnSIM/apps/ndn-sampler.hpp"
+#include "ns3/ndnSIM/apps/peer-auth.hpp"
 
 namespace ns3 {
 
+// "Nocache", or "<Lru|Lfu|Fifo|Random>:<entries>" behind the admission of cs-admission.hpp
+static void
+SetContentStore(ndn::StackHelper& ndnHelper, const std::string& cs)
+{
+  size_t colon = cs.find(':');
+  if (colon == std::string::npos) {
+    ndnHelper.SetOldContentStore("ns3::ndn::cs::Nocache");
+    return;
+  }
+  ndnHelper.SetOldContentStore("ns3::ndn::cs::Admission", "Policy", "ns3::ndn::cs::" + cs.substr(0, colon),
+                               "MaxSize", cs.substr(colon + 1));
+}
 
 int
 main(int argc, char* argv[])
 {
-  // setting default parameters for PointToPoint links and channels
-  Config::SetDefault("ns3::PointToPointNetDevice::DataRate", StringValue("1Mbps"));
-  Config::SetDefault("ns3::PointToPointChannel::Delay", StringValue("10ms"));
-  Config::SetDefault("ns3::QueueBase::MaxSize", StringValue("20p"));
-
   // Read optional command-line parameters (e.g., enable visualizer with ./waf --run=<> --visualize
+  std::string dataRate = "1Mbps";
+  std::string delay = "10ms";
+  std::string queueSize = "20p";
+  double frequency = 3.0;
+  uint32_t censorNode = 2;
+  uint32_t proxyCount = 10;
+  std::string authSecret = "ndn-censorship-secret";
+  double admissionRate = 0.0;
+  uint32_t admissionBurst = 4;
+  std::string metricsFile = "";
+  std::string traceFile = "";
+  std::string profileFile = "";
+  bool profilePerNode = false;
+  std::string sampleFile = "";
+  double sampleInterval = 0.1;
+  uint32_t maxFilesInFlight = 3;
+  bool notify = false;
+  uint32_t rangeStride = 10;
+  uint32_t rangeSize = 10;
+  bool svSync = false;
+  uint32_t codeK = 0;
+  uint32_t codeN = 3;
+  std::string failedProxies = "";
+  double failTime = 29.0;
+  double readerStart = 0.0;
+  std::string csPeer = "Nocache";
+  std::string csRouter = "Nocache";
+  std::string csProxy = "Nocache";
+  std::string csPeerA = "Nocache";
+  std::string csPriority = "";
+  uint32_t csPrioritySize = 0;
+  std::string csBypass = "/prefix/file/sync";
+  std::string csTrustedKey = "/prefix/KEY";
+  std::string saveSnapshot = "";
+  double snapshotTime = 10.0;
+  std::string loadSnapshot = "";
+
   CommandLine cmd;
+  cmd.AddValue("dataRate", "DataRate of every point-to-point link", dataRate);
+  cmd.AddValue("delay", "Delay of every point-to-point channel", delay);
+  cmd.AddValue("queueSize", "MaxSize of the queue of every link (e.g. 20p)", queueSize);
+  cmd.AddValue("frequency", "Interests per second of each PeerConsumerCbr", frequency);
+  cmd.AddValue("censorNode", "Node of the ProducerCensor (2 sits between the routers and Peer A)", censorNode);
+  cmd.AddValue("proxyCount", "Proxy nodes with ProxyProducers, the first of 5, 6, 7 and 33-39 (at most 10)", proxyCount);
+  cmd.AddValue("authSecret", "HMAC secret shared by ProducerA and the token issuer", authSecret);
+  cmd.AddValue("admissionRate", "Metadata Interests per second ProducerA admits from each peer, 0 disables admission control", admissionRate);
+  cmd.AddValue("admissionBurst", "Token bucket depth of every peer at ProducerA", admissionBurst);
+  cmd.AddValue("metricsFile", "File for the delay metrics summary, stdout if empty", metricsFile);
+  cmd.AddValue("traceFile", "Binary packet trace (see ndn-trace-to-csv), disabled if empty", traceFile);
+  cmd.AddValue("profileFile", "Folded stacks of the app handlers (needs NDN_APP_PROFILE_ENABLED=1), disabled if empty", profileFile);
+  cmd.AddValue("profilePerNode", "Profile every node apart instead of per app type only", profilePerNode);
+  cmd.AddValue("sampleFile", "Queue, PIT, CS and outstanding Interest samples (see ndn-trace-to-csv), disabled if empty", sampleFile);
+  cmd.AddValue("sampleInterval", "Seconds between two samples", sampleInterval);
+  cmd.AddValue("maxFilesInFlight", "Files each PeerConsumer fetches concurrently", maxFilesInFlight);
+  cmd.AddValue("notify", "ConsumerA keeps a sync Interest pending at ProducerA instead of polling", notify);
+  cmd.AddValue("rangeStride", "Files between the ranges of two consecutive peer keys", rangeStride);
+  cmd.AddValue("rangeSize", "Files per peer range, more than rangeStride makes neighbours overlap", rangeSize);
+  cmd.AddValue("svSync", "Peers poll the state vector of their neighbours and fetch recovered files from them", svSync);
+  cmd.AddValue("codeK", "Peers push files as codeN erasure coded blocks of which codeK rebuild them, 0 pushes whole files", codeK);
+  cmd.AddValue("codeN", "Erasure coded blocks per file, spread over /cnn, /bbc and /nytimes", codeN);
+  cmd.AddValue("failedProxies", "Comma separated proxy prefixes (e.g. /cnn) whose producers fail at failTime", failedProxies);
+  cmd.AddValue("failTime", "Time at which the failedProxies stop", failTime);
+  cmd.AddValue("readerStart", "Start of a ProxyReader on node 8 that reads all files back, 0 for none", readerStart);
+  cmd.AddValue("csPeer", "Content store of the peer nodes: Nocache or <Lru|Lfu|Fifo|Random>:<entries>", csPeer);
+  cmd.AddValue("csRouter", "Content store of the routers (nodes 1, 3 and 8)", csRouter);
+  cmd.AddValue("csProxy", "Content store of the proxy nodes", csProxy);
+  cmd.AddValue("csPeerA", "Content store of Peer A (node 4)", csPeerA);
+  cmd.AddValue("csPriority", "Comma separated prefixes cached apart from the rest (e.g. /cnn,/bbc,/nytimes)", csPriority);
+  cmd.AddValue("csPrioritySize", "Entries of the priority part of every content store, 0 disables it", csPrioritySize);
+  cmd.AddValue("csBypass", "Comma separated prefixes that are never cached", csBypass);
+  cmd.AddValue("csTrustedKey", "KeyLocator of ProducerA, the peers and the proxies; caches only admit Data with it", csTrustedKey);
+  cmd.AddValue("saveSnapshot", "Save the app state to this file at snapshotTime and end the run there, disabled if empty", saveSnapshot);
+  cmd.AddValue("snapshotTime", "Time of the saveSnapshot snapshot", snapshotTime);
+  cmd.AddValue("loadSnapshot", "Resume from the app state saved by a run with the same apps; failTime, readerStart and the end stay absolute", loadSnapshot);
   cmd.Parse(argc, argv);
 
+  // setting default parameters for PointToPoint links and channels
+  Config::SetDefault("ns3::PointToPointNetDevice::DataRate", StringValue(dataRate));
+  Config::SetDefault("ns3::PointToPointChannel::Delay", StringValue(delay));
+  Config::SetDefault("ns3::QueueBase::MaxSize", StringValue(queueSize));
+
+  Config::SetDefault("ns3::ndn::cs::Admission::PriorityPrefixes", StringValue(csPriority));
+  Config::SetDefault("ns3::ndn::cs::Admission::PrioritySize", UintegerValue(csPrioritySize));
+  Config::SetDefault("ns3::ndn::cs::Admission::BypassPrefixes", StringValue(csBypass));
+  Config::SetDefault("ns3::ndn::cs::Admission::TrustedKeyLocator", StringValue(csTrustedKey));
+
+  // the censor does not sign with the trusted key, so its bogus Data never enter a cache
+  std::string roles = csPeer + csRouter + csProxy + csPeerA;
+  if (roles.find(':') != std::string::npos && !csTrustedKey.empty()) {
+    Config::SetDefault("ns3::ndn::ProducerA::KeyLocator", StringValue(csTrustedKey));
+    Config::SetDefault("ns3::ndn::PeerProducer::KeyLocator", StringValue(csTrustedKey));
+    Config::SetDefault("ns3::ndn::ProxyProducer::KeyLocator", StringValue(csTrustedKey));
+  }
+
+  // neighbours in key order (B = 10001 ... U = 10020) share files when the ranges overlap
+  auto syncPeers = [svSync](char peer) {
+    std::string peers;
+    if (!svSync)
+      return peers;
+    if (peer > 'B')
+      peers.push_back(peer - 1);
+    if (peer < 'U') {
+      if (!peers.empty())
+        peers.push_back(',');
+      peers.push_back(peer + 1);
+    }
+    return peers;
+  };
+
+  // nodes 5, 6, 7 and 33-39 = Proxies 1-10
+  const uint32_t proxyNodes[] = {5, 6, 7, 33, 34, 35, 36, 37, 38, 39};
+  NS_ABORT_MSG_IF(proxyCount > sizeof(proxyNodes) / sizeof(proxyNodes[0]), "proxyCount is at most 10");
+
   // Creating nodes
   NodeContainer nodes;
   nodes.Create(40);
+  NS_ABORT_MSG_IF(censorNode >= nodes.GetN(), "censorNode must be one of the 40 nodes");
 
   // Connecting nodes using two links
   PointToPointHelper p2p;
@@ -86,11 +212,24 @@ main(int argc, char* argv[])
 
 
 
-  // Install NDN stack on all nodes
+  // Install NDN stack on all nodes, with the content store of the node's role
   ndn::StackHelper ndnHelper;
   ndnHelper.SetDefaultRoutes(true);
-  ndnHelper.SetOldContentStore("ns3::ndn::cs::Nocache");
-  ndnHelper.InstallAll();
+  for (uint32_t i = 0; i < nodes.GetN(); i++) {
+    std::string cs = csPeer;
+    if (i == censorNode)
+      cs = "Nocache"; // the censor
+    else if (i == 1 || i == 2 || i == 3 || i == 8)
+      cs = csRouter;
+    else if (i == 4)
+      cs = csPeerA;
+    else if (i == 5 || i == 7 || i >= 33)
+      cs = csProxy;
+    else if (i == 6)
+      cs = "Nocache"; // the proxy behind node 2
+    SetContentStore(ndnHelper, cs);
+    ndnHelper.Install(nodes.Get(i));
+  }
 
   // Choosing forwarding strategy
   ndn::StrategyChoiceHelper::InstallAll("/prefix", "/localhost/nfd/strategy/multicast");
@@ -98,503 +237,123 @@ main(int argc, char* argv[])
   ndn::StrategyChoiceHelper::InstallAll("/bbc", "/localhost/nfd/strategy/multicast");
   ndn::StrategyChoiceHelper::InstallAll("/nytimes", "/localhost/nfd/strategy/multicast");
 
-  // Installing applications
-
-  // node 0 = Peer B
-
-  ndn::AppHelper consumerBHelper("ns3::ndn::PeerConsumerCbr");
-  consumerBHelper.SetPrefix("/prefix/");
-  consumerBHelper.SetAttribute("PeerKey", StringValue("10001"));
-  consumerBHelper.SetAttribute("PeerName", StringValue("B"));
-  consumerBHelper.SetAttribute("Frequency", StringValue("3"));
-  consumerBHelper.Install(nodes.Get(0));
-
-  ndn::AppHelper producerBHelper("ns3::ndn::PeerProducer");
-  producerBHelper.SetPrefix("/prefix/peer");
-  producerBHelper.SetAttribute("PeerName", StringValue("B"));
-  producerBHelper.Install(nodes.Get(0));
-
-  // node 9 = Peer C
-  ndn::AppHelper consumerCHelper("ns3::ndn::PeerConsumerCbr");
-  consumerCHelper.SetPrefix("/prefix/");
-  consumerCHelper.SetAttribute("PeerKey", StringValue("10002"));
-  consumerCHelper.SetAttribute("PeerName", StringValue("C"));
-  consumerCHelper.SetAttribute("Frequency", StringValue("3"));
-  auto appsC = consumerCHelper.Install(nodes.Get(9));
-  //apps.Stop(Seconds(10.0));
-
-  ndn::AppHelper producerCHelper("ns3::ndn::PeerProducer");
-  producerCHelper.SetPrefix("/prefix/peer");
-  producerCHelper.SetAttribute("PeerName", StringValue("C"));
-  //producerCensorHelper.SetAttribute("PayloadSize", StringValue("1024"));
-  producerCHelper.Install(nodes.Get(9));
-
-
-  // node 10 = Peer D
-  ndn::AppHelper consumerDHelper("ns3::ndn::PeerConsumerCbr");
-  consumerDHelper.SetPrefix("/prefix/");
-  consumerDHelper.SetAttribute("PeerKey", StringValue("10003"));
-  consumerDHelper.SetAttribute("PeerName", StringValue("D"));
-  consumerDHelper.SetAttribute("Frequency", StringValue("3"));
-  consumerDHelper.Install(nodes.Get(10));
-
-  ndn::AppHelper producerDHelper("ns3::ndn::PeerProducer");
-  producerDHelper.SetPrefix("/prefix/peer");
-  producerDHelper.SetAttribute("PeerName", StringValue("D"));
-  producerDHelper.Install(nodes.Get(10));
-
-
-  // node 11 = Peer E
-  ndn::AppHelper consumerEHelper("ns3::ndn::PeerConsumerCbr");
-  consumerEHelper.SetPrefix("/prefix/");
-  consumerEHelper.SetAttribute("PeerKey", StringValue("10004"));
-  consumerEHelper.SetAttribute("PeerName", StringValue("E"));
-  consumerEHelper.SetAttribute("Frequency", StringValue("3"));
-  consumerEHelper.Install(nodes.Get(11));
-
-  ndn::AppHelper producerEHelper("ns3::ndn::PeerProducer");
-  producerEHelper.SetPrefix("/prefix/peer");
-  producerEHelper.SetAttribute("PeerName", StringValue("E"));
-  producerEHelper.Install(nodes.Get(11));
-
-
-
-  // node 12 = Peer F
-  ndn::AppHelper consumerFHelper("ns3::ndn::PeerConsumerCbr");
-  consumerFHelper.SetPrefix("/prefix/");
-  consumerFHelper.SetAttribute("PeerKey", StringValue("10005"));
-  consumerFHelper.SetAttribute("PeerName", StringValue("F"));
-  consumerFHelper.SetAttribute("Frequency", StringValue("3"));
-  consumerFHelper.Install(nodes.Get(12));
-
-  ndn::AppHelper producerFHelper("ns3::ndn::PeerProducer");
-  producerFHelper.SetPrefix("/prefix/peer");
-  producerFHelper.SetAttribute("PeerName", StringValue("F"));
-  producerFHelper.Install(nodes.Get(12));
-
-  // node 13 = Peer G
-  ndn::AppHelper consumerGHelper("ns3::ndn::PeerConsumerCbr");
-  consumerGHelper.SetPrefix("/prefix/");
-  consumerGHelper.SetAttribute("PeerKey", StringValue("10006"));
-  consumerGHelper.SetAttribute("PeerName", StringValue("G"));
-  consumerGHelper.SetAttribute("Frequency", StringValue("3"));
-  consumerGHelper.Install(nodes.Get(13));
-
-  ndn::AppHelper producerGHelper("ns3::ndn::PeerProducer");
-  producerGHelper.SetPrefix("/prefix/peer");
-  producerGHelper.SetAttribute("PeerName", StringValue("G"));
-  producerGHelper.Install(nodes.Get(13));
-
-
-  // node 14 = Peer H
-  ndn::AppHelper consumerHHelper("ns3::ndn::PeerConsumerCbr");
-  consumerHHelper.SetPrefix("/prefix/");
-  consumerHHelper.SetAttribute("PeerKey", StringValue("10007"));
-  consumerHHelper.SetAttribute("PeerName", StringValue("H"));
-  consumerHHelper.SetAttribute("Frequency", StringValue("3"));
-  consumerHHelper.Install(nodes.Get(14));
-
-  ndn::AppHelper producerHHelper("ns3::ndn::PeerProducer");
-  producerHHelper.SetPrefix("/prefix/peer");
-  producerHHelper.SetAttribute("PeerName", StringValue("H"));
-  producerHHelper.Install(nodes.Get(14));
-
-  // node 15 = Peer I
-  ndn::AppHelper consumerIHelper("ns3::ndn::PeerConsumerCbr");
-  consumerIHelper.SetPrefix("/prefix/");
-  consumerIHelper.SetAttribute("PeerKey", StringValue("10008"));
-  consumerIHelper.SetAttribute("PeerName", StringValue("I"));
-  consumerIHelper.SetAttribute("Frequency", StringValue("3"));
-  consumerIHelper.Install(nodes.Get(15));
-
-  ndn::AppHelper producerIHelper("ns3::ndn::PeerProducer");
-  producerIHelper.SetPrefix("/prefix/peer");
-  producerIHelper.SetAttribute("PeerName", StringValue("I"));
-  producerIHelper.Install(nodes.Get(15));
-
-
-  // node 16 = Peer J
-  ndn::AppHelper consumerJHelper("ns3::ndn::PeerConsumerCbr");
-  consumerJHelper.SetPrefix("/prefix/");
-  consumerJHelper.SetAttribute("PeerKey", StringValue("10009"));
-  consumerJHelper.SetAttribute("PeerName", StringValue("J"));
-  consumerJHelper.SetAttribute("Frequency", StringValue("3"));
-  consumerJHelper.Install(nodes.Get(16));
-
-  ndn::AppHelper producerJHelper("ns3::ndn::PeerProducer");
-  producerJHelper.SetPrefix("/prefix/peer");
-  producerJHelper.SetAttribute("PeerName", StringValue("J"));
-  producerJHelper.Install(nodes.Get(16));
-
-
-  // node 17 = Peer K
-  ndn::AppHelper consumerKHelper("ns3::ndn::PeerConsumerCbr");
-  consumerKHelper.SetPrefix("/prefix/");
-  consumerKHelper.SetAttribute("PeerKey", StringValue("10010"));
-  consumerKHelper.SetAttribute("PeerName", StringValue("K"));
-  consumerKHelper.SetAttribute("Frequency", StringValue("3"));
-  consumerKHelper.Install(nodes.Get(17));
-
-  ndn::AppHelper producerKHelper("ns3::ndn::PeerProducer");
-  producerKHelper.SetPrefix("/prefix/peer");
-  producerKHelper.SetAttribute("PeerName", StringValue("K"));
-  producerKHelper.Install(nodes.Get(17));
-
-  // node 18 = Peer L
-  ndn::AppHelper consumerLHelper("ns3::ndn::PeerConsumerCbr");
-  consumerLHelper.SetPrefix("/prefix/");
-  consumerLHelper.SetAttribute("PeerKey", StringValue("10011"));
-  consumerLHelper.SetAttribute("PeerName", StringValue("L"));
-  consumerLHelper.SetAttribute("Frequency", StringValue("3"));
-  consumerLHelper.Install(nodes.Get(18));
-
-  ndn::AppHelper producerLHelper("ns3::ndn::PeerProducer");
-  producerLHelper.SetPrefix("/prefix/peer");
-  producerLHelper.SetAttribute("PeerName", StringValue("L"));
-  producerLHelper.Install(nodes.Get(18));
-
-  // node 19 = Peer M
-  ndn::AppHelper consumerMHelper("ns3::ndn::PeerConsumerCbr");
-  consumerMHelper.SetPrefix("/prefix/");
-  consumerMHelper.SetAttribute("PeerKey", StringValue("10012"));
-  consumerMHelper.SetAttribute("PeerName", StringValue("M"));
-  consumerMHelper.SetAttribute("Frequency", StringValue("3"));
-  consumerMHelper.Install(nodes.Get(19));
-
-  ndn::AppHelper producerMHelper("ns3::ndn::PeerProducer");
-  producerMHelper.SetPrefix("/prefix/peer");
-  producerMHelper.SetAttribute("PeerName", StringValue("M"));
-  producerMHelper.Install(nodes.Get(19));
-
-  // node 20 = Peer N
-  ndn::AppHelper consumerNHelper("ns3::ndn::PeerConsumerCbr");
-  consumerNHelper.SetPrefix("/prefix/");
-  consumerNHelper.SetAttribute("PeerKey", StringValue("10013"));
-  consumerNHelper.SetAttribute("PeerName", StringValue("N"));
-  consumerNHelper.SetAttribute("Frequency", StringValue("3"));
-  consumerNHelper.Install(nodes.Get(20));
-
-  ndn::AppHelper producerNHelper("ns3::ndn::PeerProducer");
-  producerNHelper.SetPrefix("/prefix/peer");
-  producerNHelper.SetAttribute("PeerName", StringValue("N"));
-  producerNHelper.Install(nodes.Get(20));
-
-  // node 21 = Peer O
-  ndn::AppHelper consumerOHelper("ns3::ndn::PeerConsumerCbr");
-  consumerOHelper.SetPrefix("/prefix/");
-  consumerOHelper.SetAttribute("PeerKey", StringValue("10014"));
-  consumerOHelper.SetAttribute("PeerName", StringValue("O"));
-  consumerOHelper.SetAttribute("Frequency", StringValue("3"));
-  consumerOHelper.Install(nodes.Get(21));
-
-  ndn::AppHelper producerOHelper("ns3::ndn::PeerProducer");
-  producerOHelper.SetPrefix("/prefix/peer");
-  producerOHelper.SetAttribute("PeerName", StringValue("O"));
-  producerOHelper.Install(nodes.Get(21));
-
-  // node 22 = Peer P
-  ndn::AppHelper consumerPHelper("ns3::ndn::PeerConsumerCbr");
-  consumerPHelper.SetPrefix("/prefix/");
-  consumerPHelper.SetAttribute("PeerKey", StringValue("10015"));
-  consumerPHelper.SetAttribute("PeerName", StringValue("P"));
-  consumerPHelper.SetAttribute("Frequency", StringValue("3"));
-  consumerPHelper.Install(nodes.Get(22));
-
-  ndn::AppHelper producerPHelper("ns3::ndn::PeerProducer");
-  producerPHelper.SetPrefix("/prefix/peer");
-  producerPHelper.SetAttribute("PeerName", StringValue("P"));
-  producerPHelper.Install(nodes.Get(22));
-
-  // node 23 = Peer Q
-  ndn::AppHelper consumerQHelper("ns3::ndn::PeerConsumerCbr");
-  consumerQHelper.SetPrefix("/prefix/");
-  consumerQHelper.SetAttribute("PeerKey", StringValue("10016"));
-  consumerQHelper.SetAttribute("PeerName", StringValue("Q"));
-  consumerQHelper.SetAttribute("Frequency", StringValue("3"));
-  consumerQHelper.Install(nodes.Get(23));
-
-  ndn::AppHelper producerQHelper("ns3::ndn::PeerProducer");
-  producerQHelper.SetPrefix("/prefix/peer");
-  producerQHelper.SetAttribute("PeerName", StringValue("Q"));
-  producerQHelper.Install(nodes.Get(23));
-
-  // node 24 = Peer R
-  ndn::AppHelper consumerRHelper("ns3::ndn::PeerConsumerCbr");
-  consumerRHelper.SetPrefix("/prefix/");
-  consumerRHelper.SetAttribute("PeerKey", StringValue("10017"));
-  consumerRHelper.SetAttribute("PeerName", StringValue("R"));
-  consumerRHelper.SetAttribute("Frequency", StringValue("3"));
-  consumerRHelper.Install(nodes.Get(24));
-
-  ndn::AppHelper producerRHelper("ns3::ndn::PeerProducer");
-  producerRHelper.SetPrefix("/prefix/peer");
-  producerRHelper.SetAttribute("PeerName", StringValue("R"));
-  producerRHelper.Install(nodes.Get(24));
-
-  // node 25 = Peer S
-  ndn::AppHelper consumerSHelper("ns3::ndn::PeerConsumerCbr");
-  consumerSHelper.SetPrefix("/prefix/");
-  consumerSHelper.SetAttribute("PeerKey", StringValue("10018"));
-  consumerSHelper.SetAttribute("PeerName", StringValue("S"));
-  consumerSHelper.SetAttribute("Frequency", StringValue("3"));
-  consumerSHelper.Install(nodes.Get(25));
-
-  ndn::AppHelper producerSHelper("ns3::ndn::PeerProducer");
-  producerSHelper.SetPrefix("/prefix/peer");
-  producerSHelper.SetAttribute("PeerName", StringValue("S"));
-  producerSHelper.Install(nodes.Get(25));
-
-  // node 26 = Peer T
-  ndn::AppHelper consumerTHelper("ns3::ndn::PeerConsumerCbr");
-  consumerTHelper.SetPrefix("/prefix/");
-  consumerTHelper.SetAttribute("PeerKey", StringValue("10019"));
-  consumerTHelper.SetAttribute("PeerName", StringValue("T"));
-  consumerTHelper.SetAttribute("Frequency", StringValue("3"));
-  consumerTHelper.Install(nodes.Get(26));
-
-  ndn::AppHelper producerTHelper("ns3::ndn::PeerProducer");
-  producerTHelper.SetPrefix("/prefix/peer");
-  producerTHelper.SetAttribute("PeerName", StringValue("T"));
-  producerTHelper.Install(nodes.Get(26));
-
-  // node 27 = Peer U
-  ndn::AppHelper consumerUHelper("ns3::ndn::PeerConsumerCbr");
-  consumerUHelper.SetPrefix("/prefix/");
-  consumerUHelper.SetAttribute("PeerKey", StringValue("10020"));
-  consumerUHelper.SetAttribute("PeerName", StringValue("U"));
-  consumerUHelper.SetAttribute("Frequency", StringValue("3"));
-  consumerUHelper.Install(nodes.Get(27));
-
-  ndn::AppHelper producerUHelper("ns3::ndn::PeerProducer");
-  producerUHelper.SetPrefix("/prefix/peer");
-  producerUHelper.SetAttribute("PeerName", StringValue("U"));
-  producerUHelper.Install(nodes.Get(27));
-
-
-  // node 28 = Peer V (Invalid Peer)
-  ndn::AppHelper consumerVHelper("ns3::ndn::PeerConsumerCbr");
-  consumerVHelper.SetPrefix("/prefix/");
-  consumerVHelper.SetAttribute("PeerKey", StringValue("20001"));
-  consumerVHelper.SetAttribute("PeerName", StringValue("V"));
-  consumerVHelper.SetAttribute("Frequency", StringValue("3"));
-  consumerVHelper.Install(nodes.Get(28));
-
-  ndn::AppHelper producerVHelper("ns3::ndn::PeerProducer");
-  producerVHelper.SetPrefix("/prefix/peer");
-  producerVHelper.SetAttribute("PeerName", StringValue("V"));
-  producerVHelper.Install(nodes.Get(28));
-
-  // node 29 = Peer W (Invalid Peer)
-  ndn::AppHelper consumerWHelper("ns3::ndn::PeerConsumerCbr");
-  consumerWHelper.SetPrefix("/prefix/");
-  consumerWHelper.SetAttribute("PeerKey", StringValue("20002"));
-  consumerWHelper.SetAttribute("PeerName", StringValue("W"));
-  consumerWHelper.SetAttribute("Frequency", StringValue("3"));
-  consumerWHelper.Install(nodes.Get(29));
-
-  ndn::AppHelper producerWHelper("ns3::ndn::PeerProducer");
-  producerWHelper.SetPrefix("/prefix/peer");
-  producerWHelper.SetAttribute("PeerName", StringValue("W"));
-  producerWHelper.Install(nodes.Get(29));
-
-  // node 30 = Peer X (Invalid Peer)
-  ndn::AppHelper consumerXHelper("ns3::ndn::PeerConsumerCbr");
-  consumerXHelper.SetPrefix("/prefix/");
-  consumerXHelper.SetAttribute("PeerKey", StringValue("20003"));
-  consumerXHelper.SetAttribute("PeerName", StringValue("X"));
-  consumerXHelper.SetAttribute("Frequency", StringValue("3"));
-  consumerXHelper.Install(nodes.Get(30));
-
-  ndn::AppHelper producerXHelper("ns3::ndn::PeerProducer");
-  producerXHelper.SetPrefix("/prefix/peer");
-  producerXHelper.SetAttribute("PeerName", StringValue("X"));
-  producerXHelper.Install(nodes.Get(30));
-
-  // node 31 = Peer Y (Invalid Peer)
-  ndn::AppHelper consumerYHelper("ns3::ndn::PeerConsumerCbr");
-  consumerYHelper.SetPrefix("/prefix/");
-  consumerYHelper.SetAttribute("PeerKey", StringValue("20004"));
-  consumerYHelper.SetAttribute("PeerName", StringValue("Y"));
-  consumerYHelper.SetAttribute("Frequency", StringValue("3"));
-  consumerYHelper.Install(nodes.Get(31));
-
-  ndn::AppHelper producerYHelper("ns3::ndn::PeerProducer");
-  producerYHelper.SetPrefix("/prefix/peer");
-  producerYHelper.SetAttribute("PeerName", StringValue("Y"));
-  producerYHelper.Install(nodes.Get(31));
-
-  // node 32 = Peer Y (Invalid Peer)
-  ndn::AppHelper consumerZHelper("ns3::ndn::PeerConsumerCbr");
-  consumerZHelper.SetPrefix("/prefix/");
-  consumerZHelper.SetAttribute("PeerKey", StringValue("20005"));
-  consumerZHelper.SetAttribute("PeerName", StringValue("Z"));
-  consumerZHelper.SetAttribute("Frequency", StringValue("3"));
-  consumerZHelper.Install(nodes.Get(32));
-
-  ndn::AppHelper producerZHelper("ns3::ndn::PeerProducer");
-  producerZHelper.SetPrefix("/prefix/peer");
-  producerZHelper.SetAttribute("PeerName", StringValue("Z"));
-  producerZHelper.Install(nodes.Get(32));
-
-
-  // node 2 =  Censor Producer
-  ndn::AppHelper producerCensorHelper("ns3::ndn::ProducerCensor");
-  producerCensorHelper.SetPrefix("/prefix/file");
-  //producerCensorHelper.SetAttribute("PayloadSize", StringValue("1024"));
-  producerCensorHelper.Install(nodes.Get(2));
+  // Installing applications, all at once: the TypeIds are looked up here and not per app
+  TypeId peerConsumerType = TypeId::LookupByName("ns3::ndn::PeerConsumerCbr");
+  TypeId peerProducerType = TypeId::LookupByName("ns3::ndn::PeerProducer");
+  TypeId proxyProducerType = TypeId::LookupByName("ns3::ndn::ProxyProducer");
+  ndn::BulkAppInstaller apps;
+
+  // node 0 = Peer B, node 9 = Peer C, nodes 10-27 = Peers D-U,
+  // nodes 28-32 = Peers V-Z (Invalid Peers: unknown key, no token)
+  for (char peer = 'B'; peer <= 'Z'; peer++) {
+    uint32_t node = peer == 'B' ? 0 : peer == 'C' ? 9 : 10 + (peer - 'D');
+    std::string name(1, peer);
+
+    ndn::PeerConsumerAttributes consumer;
+    consumer.prefix = "/prefix/";
+    consumer.peerName = name;
+    consumer.frequency = frequency;
+    consumer.maxFilesInFlight = maxFilesInFlight;
+    consumer.codeK = codeK;
+    consumer.codeN = codeN;
+    if (peer <= 'U') {
+      consumer.peerKey = 10001 + (peer - 'B');
+      consumer.peerToken = ndn::PeerAuth::MakeToken(authSecret, name, consumer.peerKey);
+      consumer.syncPeers = syncPeers(peer);
+    }
+    else {
+      consumer.peerKey = 20001 + (peer - 'V');
+    }
+    apps.Add(nodes.Get(node), peerConsumerType, consumer);
+
+    ndn::PeerProducerAttributes producer;
+    producer.prefix = "/prefix/peer";
+    producer.peerName = name;
+    apps.Add(nodes.Get(node), peerProducerType, producer);
+  }
+
+  // node 2 (censorNode) =  Censor Producer
+  ndn::ProducerAttributes censor;
+  censor.prefix = "/prefix/file";
+  apps.Add(nodes.Get(censorNode), TypeId::LookupByName("ns3::ndn::ProducerCensor"), censor);
 
   // node 4 =  Peer A
-  ndn::AppHelper producerAMetaDataHelper("ns3::ndn::ProducerA");
-  producerAMetaDataHelper.SetPrefix("/prefix/metadata");
-  producerAMetaDataHelper.Install(nodes.Get(4));
-
-  ndn::AppHelper producerAFileHelper("ns3::ndn::ProducerA");
-  producerAFileHelper.SetPrefix("/prefix/file");
-  producerAFileHelper.Install(nodes.Get(4));
-
-
-  ndn::AppHelper consumerAHelper("ns3::ndn::ConsumerACbr");
-  consumerAHelper.SetPrefix("/prefix/file/sync");  // could be problem
-  //consumerAHelper.SetAttribute("Frequency", StringValue("3"));
-  consumerAHelper.Install(nodes.Get(4));
-
-  // node 5 =  Proxy 1
-  ndn::AppHelper producerProxy11Helper("ns3::ndn::ProxyProducer");
-  producerProxy11Helper.SetPrefix("/cnn");
-  producerProxy11Helper.Install(nodes.Get(5));
-
-  ndn::AppHelper producerProxy12Helper("ns3::ndn::ProxyProducer");
-  producerProxy12Helper.SetPrefix("/bbc");
-  producerProxy12Helper.Install(nodes.Get(5));
-
-  ndn::AppHelper producerProxy13Helper("ns3::ndn::ProxyProducer");
-  producerProxy13Helper.SetPrefix("/nytimes");
-  producerProxy13Helper.Install(nodes.Get(5));
-
-  // node 6 =  Proxy 2
-  ndn::AppHelper producerProxy21Helper("ns3::ndn::ProxyProducer");
-  producerProxy21Helper.SetPrefix("/cnn");
-  producerProxy21Helper.Install(nodes.Get(6));
-
-  ndn::AppHelper producerProxy22Helper("ns3::ndn::ProxyProducer");
-  producerProxy22Helper.SetPrefix("/bbc");
-  producerProxy22Helper.Install(nodes.Get(6));
-
-  ndn::AppHelper producerProxy23Helper("ns3::ndn::ProxyProducer");
-  producerProxy23Helper.SetPrefix("/nytimes");
-  producerProxy23Helper.Install(nodes.Get(6));
-
-
-  // node 7 =  Proxy 3
-  ndn::AppHelper producerProxy31Helper("ns3::ndn::ProxyProducer");
-  producerProxy31Helper.SetPrefix("/cnn");
-  producerProxy31Helper.Install(nodes.Get(7));
-
-  ndn::AppHelper producerProxy32Helper("ns3::ndn::ProxyProducer");
-  producerProxy32Helper.SetPrefix("/bbc");
-  producerProxy32Helper.Install(nodes.Get(7));
-
-  ndn::AppHelper producerProxy33Helper("ns3::ndn::ProxyProducer");
-  producerProxy33Helper.SetPrefix("/nytimes");
-  producerProxy33Helper.Install(nodes.Get(7));
-
-  // node 33 =  Proxy 4
-  ndn::AppHelper producerProxy41Helper("ns3::ndn::ProxyProducer");
-  producerProxy41Helper.SetPrefix("/cnn");
-  producerProxy41Helper.Install(nodes.Get(33));
-
-  ndn::AppHelper producerProxy42Helper("ns3::ndn::ProxyProducer");
-  producerProxy42Helper.SetPrefix("/bbc");
-  producerProxy42Helper.Install(nodes.Get(33));
-
-  ndn::AppHelper producerProxy43Helper("ns3::ndn::ProxyProducer");
-  producerProxy43Helper.SetPrefix("/nytimes");
-  producerProxy43Helper.Install(nodes.Get(33));
-
-  // node 34 =  Proxy 5
-  ndn::AppHelper producerProxy51Helper("ns3::ndn::ProxyProducer");
-  producerProxy51Helper.SetPrefix("/cnn");
-  producerProxy51Helper.Install(nodes.Get(34));
-
-  ndn::AppHelper producerProxy52Helper("ns3::ndn::ProxyProducer");
-  producerProxy52Helper.SetPrefix("/bbc");
-  producerProxy52Helper.Install(nodes.Get(34));
-
-  ndn::AppHelper producerProxy53Helper("ns3::ndn::ProxyProducer");
-  producerProxy53Helper.SetPrefix("/nytimes");
-  producerProxy53Helper.Install(nodes.Get(34));
-
-
-  // node 35 =  Proxy 6
-  ndn::AppHelper producerProxy61Helper("ns3::ndn::ProxyProducer");
-  producerProxy61Helper.SetPrefix("/cnn");
-  producerProxy61Helper.Install(nodes.Get(35));
-
-  ndn::AppHelper producerProxy62Helper("ns3::ndn::ProxyProducer");
-  producerProxy62Helper.SetPrefix("/bbc");
-  producerProxy62Helper.Install(nodes.Get(35));
-
-  ndn::AppHelper producerProxy63Helper("ns3::ndn::ProxyProducer");
-  producerProxy63Helper.SetPrefix("/nytimes");
-  producerProxy63Helper.Install(nodes.Get(35));
-
-
-  // node 36 =  Proxy 7
-  ndn::AppHelper producerProxy71Helper("ns3::ndn::ProxyProducer");
-  producerProxy71Helper.SetPrefix("/cnn");
-  producerProxy71Helper.Install(nodes.Get(36));
-
-  ndn::AppHelper producerProxy72Helper("ns3::ndn::ProxyProducer");
-  producerProxy72Helper.SetPrefix("/bbc");
-  producerProxy72Helper.Install(nodes.Get(36));
-
-  ndn::AppHelper producerProxy73Helper("ns3::ndn::ProxyProducer");
-  producerProxy73Helper.SetPrefix("/nytimes");
-  producerProxy73Helper.Install(nodes.Get(36));
-
-
-  // node 37 =  Proxy 8
-  ndn::AppHelper producerProxy81Helper("ns3::ndn::ProxyProducer");
-  producerProxy81Helper.SetPrefix("/cnn");
-  producerProxy81Helper.Install(nodes.Get(37));
-
-  ndn::AppHelper producerProxy82Helper("ns3::ndn::ProxyProducer");
-  producerProxy82Helper.SetPrefix("/bbc");
-  producerProxy82Helper.Install(nodes.Get(37));
-
-  ndn::AppHelper producerProxy83Helper("ns3::ndn::ProxyProducer");
-  producerProxy83Helper.SetPrefix("/nytimes");
-  producerProxy83Helper.Install(nodes.Get(37));
-
-  // node 38 =  Proxy 9
-  ndn::AppHelper producerProxy91Helper("ns3::ndn::ProxyProducer");
-  producerProxy91Helper.SetPrefix("/cnn");
-  producerProxy91Helper.Install(nodes.Get(38));
-
-  ndn::AppHelper producerProxy92Helper("ns3::ndn::ProxyProducer");
-  producerProxy92Helper.SetPrefix("/bbc");
-  producerProxy92Helper.Install(nodes.Get(38));
-
-  ndn::AppHelper producerProxy93Helper("ns3::ndn::ProxyProducer");
-  producerProxy93Helper.SetPrefix("/nytimes");
-  producerProxy93Helper.Install(nodes.Get(38));
-
-
-  // node 39 =  Proxy 10
-  ndn::AppHelper producerProxy101Helper("ns3::ndn::ProxyProducer");
-  producerProxy101Helper.SetPrefix("/cnn");
-  producerProxy101Helper.Install(nodes.Get(39));
-
-  ndn::AppHelper producerProxy102Helper("ns3::ndn::ProxyProducer");
-  producerProxy102Helper.SetPrefix("/bbc");
-  producerProxy102Helper.Install(nodes.Get(39));
-
-  ndn::AppHelper producerProxy103Helper("ns3::ndn::ProxyProducer");
-  producerProxy103Helper.SetPrefix("/nytimes");
-  producerProxy103Helper.Install(nodes.Get(39));
-
-  Simulator::Stop(Seconds(40.0));
-
+  TypeId producerAType = TypeId::LookupByName("ns3::ndn::ProducerA");
+  ndn::ProducerAAttributes producerAMetaData;
+  producerAMetaData.prefix = "/prefix/metadata";
+  producerAMetaData.authSecret = authSecret;
+  producerAMetaData.admissionRate = admissionRate;
+  producerAMetaData.admissionBurst = admissionBurst;
+  producerAMetaData.rangeStride = rangeStride;
+  producerAMetaData.rangeSize = rangeSize;
+  apps.Add(nodes.Get(4), producerAType, producerAMetaData);
+
+  ndn::ProducerAAttributes producerAFile;
+  producerAFile.prefix = "/prefix/file";
+  apps.Add(nodes.Get(4), producerAType, producerAFile);
+
+  ndn::ConsumerAAttributes consumerA;
+  consumerA.prefix = "/prefix/file/sync";  // could be problem
+  consumerA.notify = notify;
+  apps.Add(nodes.Get(4), TypeId::LookupByName("ns3::ndn::ConsumerACbr"), consumerA);
+
+  // the first proxyCount proxy nodes run the proxies, the others stay plain nodes
+  for (uint32_t p = 0; p < proxyCount; p++) {
+    uint32_t node = proxyNodes[p];
+    for (const char* prefix : {"/cnn", "/bbc", "/nytimes"}) {
+      ndn::ProducerAttributes proxy;
+      proxy.prefix = prefix;
+      apps.Add(nodes.Get(node), proxyProducerType, proxy);
+    }
+  }
+
+  apps.Install();
+
+  ApplicationContainer reader;
+  if (readerStart > 0) {
+    ndn::AppHelper proxyReaderHelper("ns3::ndn::ProxyReader");
+    proxyReaderHelper.SetAttribute("LastFile", UintegerValue(rangeStride * 19 + rangeSize - 1));
+    proxyReaderHelper.SetAttribute("CodeK", UintegerValue(codeK));
+    proxyReaderHelper.SetAttribute("CodeN", UintegerValue(codeN));
+    reader = proxyReaderHelper.Install(nodes.Get(8));
+  }
+
+  // a resumed run starts at 0 where the saved one took its snapshot, so the times shift by that
+  Time offset;
+  if (!loadSnapshot.empty())
+    offset = ndn::AppSnapshot::Load(loadSnapshot);
+  auto runTime = [&offset](double time) { return std::max(Seconds(time) - offset, Seconds(0)); };
+  reader.Start(runTime(readerStart));
+
+  // proxies of the failed prefixes stop, and everything pushed to them is gone
+  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+    for (uint32_t i = 0; i < (*node)->GetNApplications(); i++) {
+      Ptr<Application> app = (*node)->GetApplication(i);
+      if (app->GetInstanceTypeId().GetName() != "ns3::ndn::ProxyProducer")
+        continue;
+      StringValue prefix;
+      app->GetAttribute("Prefix", prefix);
+      if (("," + failedProxies + ",").find("," + prefix.Get() + ",") != std::string::npos)
+        app->SetStopTime(runTime(failTime));
+    }
+  }
+
+  ndn::MetricsCollector::Install(metricsFile);
+  if (!traceFile.empty())
+    ndn::BinaryTracer::InstallAll(traceFile);
+  if (!profileFile.empty())
+    ndn::AppProfiler::Install(profileFile, profilePerNode);
+  if (!sampleFile.empty())
+    ndn::Sampler::Install(sampleFile, Seconds(sampleInterval));
+
+  if (!saveSnapshot.empty()) {
+    ndn::AppSnapshot::Install(saveSnapshot, Seconds(snapshotTime));
+    Simulator::Stop(Seconds(snapshotTime));
+  }
+  else
+    Simulator::Stop(runTime(40.0));
+
+  ndn::RunStats::Install();
   Simulator::Run();
   Simulator::Destroy();
 
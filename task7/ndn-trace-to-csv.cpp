@@ -0,0 +1,90 @@
+#include "ndn-binary-trace-format.hpp"
+
+#include <cinttypes>
+#include <cstdio>
+#include <vector>
+
+// Converts a trace written by ns3::ndn::BinaryTracer (or the samples of ns3::ndn::Sampler) into
+// CSV, with the sampled value in the seq column:
+//
+//     ndn-trace-to-csv <trace.bin> [output.csv]
+//
+// Output goes to stdout when no output file is given.
+int
+main(int argc, char* argv[])
+{
+  using namespace ns3::ndn::trace;
+
+  if (argc < 2) {
+    std::fprintf(stderr, "Usage: %s <trace.bin> [output.csv]\n", argv[0]);
+    return 1;
+  }
+
+  std::FILE* in = std::fopen(argv[1], "rb");
+  if (in == nullptr) {
+    std::perror(argv[1]);
+    return 1;
+  }
+
+  std::FILE* out = argc > 2 ? std::fopen(argv[2], "w") : stdout;
+  if (out == nullptr) {
+    std::perror(argv[2]);
+    return 1;
+  }
+
+  FileHeader fileHeader;
+  if (std::fread(&fileHeader, sizeof(fileHeader), 1, in) != 1 || fileHeader.magic != FILE_MAGIC
+      || fileHeader.version != VERSION) {
+    std::fprintf(stderr, "%s is not a version %u binary trace\n", argv[1], VERSION);
+    return 1;
+  }
+
+  std::fprintf(out, "node,app,event,name_hash,seq,time_ns\n");
+
+  std::vector<uint32_t> node, app, seq;
+  std::vector<uint8_t> event;
+  std::vector<uint64_t> nameHash;
+  std::vector<int64_t> time;
+
+  BlockHeader header;
+  uint64_t records = 0;
+  while (std::fread(&header, sizeof(header), 1, in) == 1) {
+    if (header.magic != BLOCK_MAGIC) {
+      std::fprintf(stderr, "Corrupt block after %" PRIu64 " records\n", records);
+      return 1;
+    }
+
+    size_t n = header.count;
+    node.resize(n);
+    app.resize(n);
+    event.resize(n);
+    nameHash.resize(n);
+    seq.resize(n);
+    time.resize(n);
+
+    if (std::fread(node.data(), sizeof(uint32_t), n, in) != n
+        || std::fread(app.data(), sizeof(uint32_t), n, in) != n
+        || std::fread(event.data(), sizeof(uint8_t), n, in) != n
+        || std::fread(nameHash.data(), sizeof(uint64_t), n, in) != n
+        || std::fread(seq.data(), sizeof(uint32_t), n, in) != n
+        || std::fread(time.data(), sizeof(int64_t), n, in) != n) {
+      std::fprintf(stderr, "Truncated block after %" PRIu64 " records\n", records);
+      return 1;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+      std::fprintf(out, "%u,%u,%s,%016" PRIx64 ",", node[i], app[i], GetEventName(event[i]),
+                   nameHash[i]);
+      if (seq[i] == NO_SEQ)
+        std::fprintf(out, ",%" PRId64 "\n", time[i]);
+      else
+        std::fprintf(out, "%u,%" PRId64 "\n", seq[i], time[i]);
+    }
+    records += n;
+  }
+
+  std::fclose(in);
+  if (out != stdout)
+    std::fclose(out);
+  return 0;
+}
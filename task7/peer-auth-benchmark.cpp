@@ -0,0 +1,74 @@
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM/apps/peer-auth.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+
+// Verifications/sec of PeerAuth tokens with and without the per-peer verdict cache that
+// ProducerA keeps. Every peer sends the same metadata parameters on each (re)transmission,
+// so the cached path models a run in which only the first request of a peer is verified.
+int
+main(int argc, char* argv[])
+{
+  uint32_t nPeers = 1000;
+  uint32_t nRequests = 1000000;
+  std::string secret = "ndn-censorship-secret";
+
+  CommandLine cmd;
+  cmd.AddValue("nPeers", "Number of distinct peers", nPeers);
+  cmd.AddValue("nRequests", "Number of metadata requests to verify", nRequests);
+  cmd.Parse(argc, argv);
+
+  std::vector<std::string> peerNames;
+  std::vector<std::string> parameters;
+  for (uint32_t i = 0; i < nPeers; i++) {
+    uint32_t peerKey = 10001 + i % 9999;
+    peerNames.push_back("P" + std::to_string(i));
+    parameters.push_back("key=" + std::to_string(peerKey) + "&token="
+                         + ndn::PeerAuth::MakeToken(secret, peerNames.back(), peerKey));
+  }
+
+  auto verify = [&](uint32_t i) {
+    uint32_t peerKey = std::strtoul(parameters[i].substr(4, 5).c_str(), nullptr, 10);
+    return ndn::PeerAuth::VerifyToken(secret, peerNames[i], peerKey, parameters[i].substr(16));
+  };
+
+  uint64_t valid = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t r = 0; r < nRequests; r++) {
+    valid += verify(r % nPeers);
+  }
+  double uncached = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::unordered_map<std::string, bool> verdicts;
+  start = std::chrono::steady_clock::now();
+  for (uint32_t r = 0; r < nRequests; r++) {
+    uint32_t i = r % nPeers;
+    std::string cacheKey = peerNames[i] + "|" + parameters[i];
+    auto entry = verdicts.find(cacheKey);
+    if (entry == verdicts.end())
+      entry = verdicts.emplace(cacheKey, verify(i)).first;
+    valid += entry->second;
+  }
+  double cached = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << "valid verdicts: " << valid << " of " << 2 * static_cast<uint64_t>(nRequests) << "\n"
+            << "uncached: " << nRequests / uncached << " verifications/s, "
+            << uncached * 1e6 / nRequests << " us per metadata request\n"
+            << "cached:   " << nRequests / cached << " verifications/s, "
+            << cached * 1e6 / nRequests << " us per metadata request\n";
+
+  return 0;
+}
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+  return ns3::main(argc, argv);
+}
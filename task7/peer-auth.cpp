@@ -0,0 +1,68 @@
+#include "peer-auth.hpp"
+
+#include <ndn-cxx/util/sha256.hpp>
+#include <ndn-cxx/util/string-helper.hpp>
+
+#include <cstring>
+
+namespace ns3 {
+namespace ndn {
+
+static const size_t SHA256_BLOCK_SIZE = 64;
+
+ConstBufferPtr
+PeerAuth::ComputeHmac(const std::string& secret, const std::string& message)
+{
+  uint8_t key[SHA256_BLOCK_SIZE] = {0};
+  if (secret.size() > SHA256_BLOCK_SIZE) {
+    ::ndn::util::Sha256 keyDigest;
+    keyDigest.update(reinterpret_cast<const uint8_t*>(secret.data()), secret.size());
+    ConstBufferPtr hashedKey = keyDigest.computeDigest();
+    std::memcpy(key, hashedKey->data(), hashedKey->size());
+  }
+  else {
+    std::memcpy(key, secret.data(), secret.size());
+  }
+
+  uint8_t pad[SHA256_BLOCK_SIZE];
+  for (size_t i = 0; i < SHA256_BLOCK_SIZE; i++)
+    pad[i] = key[i] ^ 0x36;
+
+  ::ndn::util::Sha256 inner;
+  inner.update(pad, sizeof(pad));
+  inner.update(reinterpret_cast<const uint8_t*>(message.data()), message.size());
+  ConstBufferPtr innerDigest = inner.computeDigest();
+
+  for (size_t i = 0; i < SHA256_BLOCK_SIZE; i++)
+    pad[i] = key[i] ^ 0x5c;
+
+  ::ndn::util::Sha256 outer;
+  outer.update(pad, sizeof(pad));
+  outer.update(innerDigest->data(), innerDigest->size());
+  return outer.computeDigest();
+}
+
+std::string
+PeerAuth::MakeToken(const std::string& secret, const std::string& peerName, uint32_t peerKey)
+{
+  ConstBufferPtr mac = ComputeHmac(secret, peerName + "|" + std::to_string(peerKey));
+  return ::ndn::toHex(mac->data(), mac->size(), false);
+}
+
+bool
+PeerAuth::VerifyToken(const std::string& secret, const std::string& peerName, uint32_t peerKey,
+                      const std::string& token)
+{
+  if (token.size() != TOKEN_LENGTH)
+    return false;
+
+  std::string expected = MakeToken(secret, peerName, peerKey);
+
+  uint8_t diff = 0;
+  for (size_t i = 0; i < TOKEN_LENGTH; i++)
+    diff |= static_cast<uint8_t>(expected[i] ^ token[i]);
+  return diff == 0;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,39 @@
+#ifndef NDN_PEER_AUTH_H
+#define NDN_PEER_AUTH_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include <string>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief HMAC-SHA256 peer tokens carried in the /prefix/metadata Interest parameters
+ *
+ * A token is HMAC(secret, "<peer name>|<peer key>") in lowercase hex. The secret is only known
+ * to ProducerA and to whoever hands out tokens (the scenario), so a peer can no longer claim a
+ * file range just by picking a key in the valid numeric interval.
+ */
+class PeerAuth {
+public:
+  static const size_t TOKEN_LENGTH = 64; ///< @brief hex characters in a token
+
+  static std::string
+  MakeToken(const std::string& secret, const std::string& peerName, uint32_t peerKey);
+
+  /**
+   * @brief Recomputes the HMAC and compares it with @p token in constant time
+   */
+  static bool
+  VerifyToken(const std::string& secret, const std::string& peerName, uint32_t peerKey,
+              const std::string& token);
+
+  static ConstBufferPtr
+  ComputeHmac(const std::string& secret, const std::string& message);
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_PEER_AUTH_H
@@ -1,6 +1,8 @@
 #include "peer-consumer.hpp"
+#include "erasure-code.hpp"
 #include "ns3/ptr.h"
-#include "ns3/log.h"
+#include "ndn-app-log.hpp"
+#include "ndn-app-profile.hpp"
 #include "ns3/simulator.h"
 #include "ns3/packet.h"
 #include "ns3/callback.h"
@@ -11,9 +13,9 @@
 #include "ns3/double.h"
 
 #include "utils/ndn-ns3-packet-tag.hpp"
-#include "utils/ndn-rtt-mean-deviation.hpp"
 
-#include <ndn-cxx/lp/tags.hpp>
+#include <algorithm>
+#include <sstream>
 
 #include <boost/lexical_cast.hpp>
 #include <boost/ref.hpp>
@@ -21,131 +23,116 @@
 
 NS_LOG_COMPONENT_DEFINE("ndn.PeerConsumer");
 
+// after the log component: the engine logs through this unit's g_log
+#include "consumer-engine-impl.hpp"
+
 namespace ns3 {
 namespace ndn {
 
+template class ConsumerEngine<PeerConsumer>;
+
 NS_OBJECT_ENSURE_REGISTERED(PeerConsumer);
 
 TypeId
 PeerConsumer::GetTypeId(void)
 {
   static TypeId tid =
-    TypeId("ns3::ndn::PeerConsumer")
-      .SetGroupName("Ndn")
-      .SetParent<App>()
-      .AddAttribute("StartSeq", "Initial sequence number", IntegerValue(0),
-                    MakeIntegerAccessor(&PeerConsumer::m_seq), MakeIntegerChecker<int32_t>())
+    AddEngineAttributes(TypeId("ns3::ndn::PeerConsumer")
+                          .SetGroupName("Ndn")
+                          .SetParent<App>())
 	  .AddAttribute("PeerKey", "Peer validation key", IntegerValue(0),
 		            MakeIntegerAccessor(&PeerConsumer::m_peerKey), MakeIntegerChecker<int32_t>())
-
-      .AddAttribute("Prefix", "Name of the Interest", StringValue("/"),
-                    MakeNameAccessor(&PeerConsumer::m_interestName), MakeNameChecker())
+	  .AddAttribute("PeerToken", "PeerAuth token sent along with the PeerKey, empty to send the key only",
+		            StringValue(""), MakeStringAccessor(&PeerConsumer::m_peerToken), MakeStringChecker())
 	  .AddAttribute("PeerName", "Name of the Peer", StringValue("/"),
-              	    MakeNameAccessor(&PeerConsumer::m_peerName), MakeNameChecker())
-      .AddAttribute("LifeTime", "LifeTime for interest packet", StringValue("2s"),
-                    MakeTimeAccessor(&PeerConsumer::m_interestLifeTime), MakeTimeChecker())
-
-      .AddAttribute("RetxTimer",
-                    "Timeout defining how frequent retransmission timeouts should be checked",
-                    StringValue("50ms"),
-                    MakeTimeAccessor(&PeerConsumer::GetRetxTimer, &PeerConsumer::SetRetxTimer),
-                    MakeTimeChecker())
-
-      .AddTraceSource("LastRetransmittedInterestDataDelay",
-                      "Delay between last retransmitted Interest and received Data",
-                      MakeTraceSourceAccessor(&PeerConsumer::m_lastRetransmittedInterestDataDelay),
-                      "ns3::ndn::PeerConsumer::LastRetransmittedInterestDataDelayCallback")
-
-      .AddTraceSource("FirstInterestDataDelay",
-                      "Delay between first transmitted Interest and received Data",
-                      MakeTraceSourceAccessor(&PeerConsumer::m_firstInterestDataDelay),
-                      "ns3::ndn::PeerConsumer::FirstInterestDataDelayCallback");
+              	    MakeInternedNameAccessor(&PeerConsumer::m_peerName), MakeNameChecker())
+	  .AddAttribute("MaxFilesInFlight", "Number of files of the range fetched concurrently",
+		            UintegerValue(1), MakeUintegerAccessor(&PeerConsumer::m_maxFilesInFlight),
+		            MakeUintegerChecker<uint32_t>(1))
+	  .AddAttribute("SyncPeers", "Comma separated names of the peers whose state vector is polled, nearest first",
+		            StringValue(""), MakeStringAccessor(&PeerConsumer::SetSyncPeers, &PeerConsumer::GetSyncPeers),
+		            MakeStringChecker())
+	  .AddAttribute("GossipFanout", "Sync peers polled per round, 0 polls all of them",
+		            UintegerValue(0), MakeUintegerAccessor(&PeerConsumer::m_gossipFanout),
+		            MakeUintegerChecker<uint32_t>())
+	  .AddAttribute("PushToProxy", "Push every validated original to /cnn, /bbc or /nytimes",
+		            BooleanValue(true), MakeBooleanAccessor(&PeerConsumer::m_pushToProxy),
+		            MakeBooleanChecker())
+	  .AddAttribute("CodeK", "Blocks needed to rebuild a pushed file, 0 pushes files whole",
+		            UintegerValue(0), MakeUintegerAccessor(&PeerConsumer::m_codeK),
+		            MakeUintegerChecker<uint32_t>(0, 256))
+	  .AddAttribute("CodeN", "Erasure coded blocks pushed per file",
+		            UintegerValue(3), MakeUintegerAccessor(&PeerConsumer::m_codeN),
+		            MakeUintegerChecker<uint32_t>(1, 256))
+	  .AddTraceSource("FileRecovered", "A file of the range was validated",
+		              MakeTraceSourceAccessor(&PeerConsumer::m_fileRecovered),
+		              "ns3::ndn::PeerConsumer::FileRecoveredCallback")
+	  .AddTraceSource("RangeCompleted", "Every file of the range was validated",
+		              MakeTraceSourceAccessor(&PeerConsumer::m_rangeCompleted),
+		              "ns3::ndn::PeerConsumer::RangeCompletedCallback");
 
   return tid;
 }
 
 PeerConsumer::PeerConsumer()
-  : m_rand(CreateObject<UniformRandomVariable>())
-  , m_seq(0)
-  , m_seqMax(0) // don't request anything
-  , m_retxCount(0)
-  , m_sendSync(false)
-  , m_pushDataPacket(false)
-  , m_getMetaData(false)
+  : m_getMetaData(false)
   , m_start(0)
   , m_end(0)
   , m_isValidPeer(true)
+  , m_firstPendingFile(0)
+  , m_maxFilesInFlight(1)
+  , m_gossipFanout(0)
+  , m_pushToProxy(true)
+  , m_codeK(0)
+  , m_codeN(3)
 {
-  NS_LOG_FUNCTION_NOARGS();
-
-  m_rtt = CreateObject<RttMeanDeviation>();
+  NDN_APP_LOG_FUNCTION_NOARGS();
 }
 
-void
-PeerConsumer::SetRetxTimer(Time retxTimer)
+PeerConsumer::FileEntry*
+PeerConsumer::GetFile(uint32_t fileNumber)
 {
-  m_retxTimer = retxTimer;
-  if (m_retxEvent.IsRunning()) {
-    // m_retxEvent.Cancel (); // cancel any scheduled cleanup events
-    Simulator::Remove(m_retxEvent); // slower, but better for memory
-  }
-
-  // schedule even with new timeout
-  m_retxEvent = Simulator::Schedule(m_retxTimer, &PeerConsumer::CheckRetxTimeout, this);
+  if (fileNumber < m_start || fileNumber - m_start >= m_files.size())
+    return nullptr;
+  return &m_files[fileNumber - m_start];
 }
 
-Time
-PeerConsumer::GetRetxTimer() const
+const PeerConsumer::SyncPeer*
+PeerConsumer::FindHolder(uint32_t fileNumber) const
 {
-  return m_retxTimer;
-}
+  if (fileNumber >= PeerProducer::FileSet().size())
+    return nullptr;
 
-void
-PeerConsumer::CheckRetxTimeout()
-{
-  Time now = Simulator::Now();
-
-  Time rto = m_rtt->RetransmitTimeout();
-  // NS_LOG_DEBUG ("Current RTO: " << rto.ToDouble (Time::S) << "s");
-
-  while (!m_seqTimeouts.empty()) {
-    SeqTimeoutsContainer::index<i_timestamp>::type::iterator entry =
-      m_seqTimeouts.get<i_timestamp>().begin();
-    if (entry->time + rto <= now) // timeout expired?
-    {
-      uint32_t seqNo = entry->seq;
-      m_seqTimeouts.get<i_timestamp>().erase(entry);
-      OnTimeout(seqNo);
-    }
-    else
-      break; // nothing else to do. All later packets need not be retransmitted
+  for (const SyncPeer& peer : m_syncPeers) {
+    if (peer.files.test(fileNumber))
+      return &peer;
   }
-
-  m_retxEvent = Simulator::Schedule(m_retxTimer, &PeerConsumer::CheckRetxTimeout, this);
+  return nullptr;
 }
 
-// Application Methods
 void
-PeerConsumer::StartApplication()
+PeerConsumer::SetSyncPeers(const std::string& peers)
 {
-  NS_LOG_FUNCTION_NOARGS();
-
-  // do base stuff
-  App::StartApplication();
+  m_syncPeers.clear();
 
-  ScheduleNextPacket();
+  std::stringstream list(peers);
+  std::string peer;
+  while (std::getline(list, peer, ',')) {
+    if (!peer.empty())
+      m_syncPeers.push_back(SyncPeer{name::Component(peer), 0, PeerProducer::FileSet()});
+  }
 }
 
-void
-PeerConsumer::StopApplication()
+std::string
+PeerConsumer::GetSyncPeers() const
 {
-  NS_LOG_FUNCTION_NOARGS();
-
-  // cancel periodic packet generation
-  Simulator::Cancel(m_sendEvent);
-
-  // cleanup base stuff
-  App::StopApplication();
+  std::string peers;
+  for (const SyncPeer& peer : m_syncPeers) {
+    if (!peers.empty())
+      peers.push_back(',');
+    peers.append(peer.name.toUri());
+  }
+  return peers;
 }
 
 void
@@ -154,211 +141,272 @@ PeerConsumer::SendPacket()
   if (!m_active)
     return;
 
-  NS_LOG_FUNCTION_NOARGS();
-  uint32_t seq = std::numeric_limits<uint32_t>::max(); // invalid
-
-  while (m_retxSeqs.size()) {
-    seq = *m_retxSeqs.begin();
-    m_retxSeqs.erase(m_retxSeqs.begin());
-    break;
-  }
+  NDN_APP_PROFILE("SendPacket");
 
-  if (seq == std::numeric_limits<uint32_t>::max()) {
-    if (m_seqMax != std::numeric_limits<uint32_t>::max()) {
-      if (m_seq >= m_seqMax) {
-        return; // we are totally done
-      }
-    }
-    seq = m_currentFileNumber;
-    //seq = m_seq++;
-  }
+  NDN_APP_LOG_FUNCTION_NOARGS();
 
-  //
-  shared_ptr<Name> nameWithSequence = make_shared<Name>(m_interestName);
+  // timed out requests first, each class after its own RTO
+  uint32_t retxSeq = 0;
+  uint32_t retxClass = 0;
+  while (PopRetxSeq(retxSeq, retxClass))
+	  Retransmit(retxSeq, retxClass);
 
-  shared_ptr<Interest> interest = make_shared<Interest>();
+  // from the first round on, so that the holders are known by the time files are fetched
+  if (!m_syncPeers.empty())
+	  SendSummaryInterests();
 
   if(!m_getMetaData)
   {
-	  nameWithSequence->append("metadata");
-	  std::stringstream temp;
-	  temp << m_peerKey;
-	  std::string key = temp.str();
-	  key.insert(0,"key=");
-	  const char* buf = key.c_str();
-	  size_t buf_size = key.length();
-	  interest->setParameters(make_shared< ::ndn::Buffer>(buf,buf_size));
-	  nameWithSequence->append(m_peerName);
-	  nameWithSequence->appendSequenceNumber(m_currentFileNumber);
-
-
-	  interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
-	  interest->setName(*nameWithSequence);
-	  interest->setCanBePrefix(false);
-	  time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
-	  interest->setInterestLifetime(interestLifeTime);
-
-	  NS_LOG_INFO("> Interest for " << *nameWithSequence);
-
-	  WillSendOutInterest(seq);
-
-	  m_transmittedInterests(interest, this, m_face);
-	  m_appLink->onReceiveInterest(*interest);
-
-	  ScheduleNextPacket();
-
+	  if(!IsTracked(m_start, REQUEST_METADATA))
+		  SendMetadataInterest();
+	  ScheduleNextPacket(); // a round that sent nothing must not end the rounds
+	  return;
   }
-  else if(m_currentFileNumber<=m_end)
-  {
-	  nameWithSequence->append("file");
-	  nameWithSequence->append(m_peerName);
-
-
-
-
 
+  // censored files wait for their original in the background, only fetches use up the window
+  bool wasPending = m_firstPendingFile < m_files.size();
+  uint32_t fetching = 0;
+  for (uint32_t i = m_firstPendingFile; i < m_files.size(); i++) {
+	  FileEntry& file = m_files[i];
+	  uint32_t fileNumber = m_start + i;
+
+	  switch (file.state) {
+	  case FILE_FETCHING:
+		  if (fetching < m_maxFilesInFlight) {
+			  const SyncPeer* holder = m_gossipFanout > 0 ? FindHolder(fileNumber) : nullptr;
+			  if (holder != nullptr)
+				  SendPeerFileInterest(fileNumber, holder->name);
+			  else if (!IsTracked(fileNumber, REQUEST_FILE))
+				  SendFileInterest(fileNumber); // otherwise in flight or just retransmitted
+			  fetching++;
+		  }
+		  break;
+	  case FILE_CENSORED:
+		  file.state = FILE_SYNCING;
+		  // fall through
+	  case FILE_SYNCING:
+		  SendSyncInterest(fileNumber);
+		  if (const SyncPeer* holder = FindHolder(fileNumber))
+			  SendPeerFileInterest(fileNumber, holder->name);
+		  break;
+	  case FILE_PUSHING:
+		  if (m_pushToProxy)
+			  SendPush(fileNumber);
+		  file.state = FILE_DONE;
+		  break;
+	  }
+  }
 
+  while (m_firstPendingFile < m_files.size() && m_files[m_firstPendingFile].state == FILE_DONE)
+	  m_firstPendingFile++;
 
+  if (wasPending && m_firstPendingFile == m_files.size())
+	  m_rangeCompleted(this);
 
+  // sending schedules the next round, but with everything in flight nothing was sent
+  ScheduleNextPacket();
+}
 
-	  //nameWithSequence->appendSequenceNumber(m_currentFileNumber);
+void
+PeerConsumer::SendMetadataInterest()
+{
+  Name nameWithSequence(m_interestName.Get());
+  shared_ptr<Interest> interest = make_shared<Interest>();
 
-	  std::stringstream temp_file_number;
+  nameWithSequence.append(names::Metadata());
+  std::stringstream temp;
+  temp << m_peerKey;
+  std::string key = temp.str();
+  key.insert(0,"key=");
+  if(!m_peerToken.empty())
+	  key.append("&token=").append(m_peerToken);
+  const char* buf = key.c_str();
+  size_t buf_size = key.length();
+  interest->setParameters(make_shared< ::ndn::Buffer>(buf,buf_size));
+  nameWithSequence.append(m_peerName.Get());
+  nameWithSequence.append(names::FileId(m_start));
+
+  interest->setName(nameWithSequence);
+
+  SendInterest(interest, m_start, REQUEST_METADATA);
+}
 
-	  if(m_currentFileNumber<10)
-	  {
-		  temp_file_number << "00"<<m_currentFileNumber;
+void
+PeerConsumer::Retransmit(uint32_t seq, uint32_t requestClass)
+{
+  FileEntry* file = GetFile(seq);
+  switch (requestClass) {
+  case REQUEST_METADATA:
+	  if (!m_getMetaData && seq == m_start) {
+		  SendMetadataInterest();
+		  return;
 	  }
-	  else if((m_currentFileNumber>9) && (m_currentFileNumber<100))
-	  {
-		  temp_file_number << "0"<<m_currentFileNumber;
+	  break;
+  case REQUEST_FILE:
+	  if (m_getMetaData && file != nullptr && file->state == FILE_FETCHING) {
+		  SendFileInterest(seq);
+		  return;
 	  }
-	  else
-	  {
-		  temp_file_number <<m_currentFileNumber;
-	  }
-
-	  nameWithSequence->append(temp_file_number.str());
-
-
+	  break;
+  }
 
+  // answered through another class in the meantime, nothing to wait for
+  StopTracking(seq, requestClass);
+}
 
+void
+PeerConsumer::SendFileInterest(uint32_t fileNumber)
+{
+  Name nameWithSequence(m_interestName.Get());
+  nameWithSequence.append(names::File());
+  nameWithSequence.append(m_peerName.Get());
+  nameWithSequence.append(names::FileId(fileNumber));
 
+  shared_ptr<Interest> interest = make_shared<Interest>();
+  interest->setName(nameWithSequence);
 
+  SendInterest(interest, fileNumber, REQUEST_FILE);
+}
 
+void
+PeerConsumer::SendSyncInterest(uint32_t fileNumber)
+{
+  Name nameSyncWithSequence(names::PrefixPeer());
+  nameSyncWithSequence.append(m_peerName.Get());
+  nameSyncWithSequence.append(names::LocalSync());
+  nameSyncWithSequence.append(names::FileId(fileNumber));
 
+  shared_ptr<Interest> interestSync = make_shared<Interest>();
+  interestSync->setName(nameSyncWithSequence);
 
+  // stays pending at the PeerProducer until the original is released, and is renewed every
+  // round: tracked, each expiry would double the RTO and delay the recovery
+  TransmitInterest(interestSync);
+}
 
+std::string
+PeerConsumer::MakeOriginal(uint32_t fileNumber)
+{
+  // the original of a file is the same everywhere, so it is rebuilt rather than kept per file
+  std::stringstream temp_Parameter;
+  if(fileNumber < 10)
+	  temp_Parameter << "Original data packet for file 00" << fileNumber;
+  else if((fileNumber > 9) && (fileNumber < 100))
+	  temp_Parameter << "Original data packet for file 0" << fileNumber;
+  else
+	  temp_Parameter << "Original data packet for file " << fileNumber;
+
+  return temp_Parameter.str();
+}
 
-	  interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
-	  interest->setName(*nameWithSequence);
-	  interest->setCanBePrefix(false);
-	  time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
-	  interest->setInterestLifetime(interestLifeTime);
+const Name&
+PeerConsumer::GetProxyPrefix(uint32_t index)
+{
+  return names::Proxy(index);
+}
 
-	  NS_LOG_INFO("> Interest for " << *nameWithSequence);
+void
+PeerConsumer::SendPush(uint32_t fileNumber)
+{
+  std::string dataPacket = MakeOriginal(fileNumber);
 
-	  WillSendOutInterest(seq);
+  if(m_codeK > 0)
+  {
+	  // /<proxy>/<file>/<block>: any CodeK of the blocks rebuild the file, see ProxyReader
+	  ErasureCode code(m_codeK, std::max(m_codeK, m_codeN));
+	  std::vector<std::string> blocks = code.Encode(dataPacket);
+	  for (uint32_t i = 0; i < blocks.size(); i++)
+	  {
+		  Name nameBlock(GetProxyPrefix(i));
+		  nameBlock.append(names::FileId(fileNumber));
+		  nameBlock.appendSequenceNumber(i);
 
-	  m_transmittedInterests(interest, this, m_face);
-	  m_appLink->onReceiveInterest(*interest);
+		  shared_ptr<Interest> interestBlock = make_shared<Interest>();
+		  interestBlock->setName(nameBlock);
+		  interestBlock->setParameters(make_shared< ::ndn::Buffer>(blocks[i].data(), blocks[i].size()));
 
-	  ScheduleNextPacket();
-  }
-  /*else
+		  // nothing comes back for a push
+		  TransmitInterest(interestBlock);
+	  }
+	  NDN_APP_LOG_INFO("Pushed " << blocks.size() << " blocks of file " << fileNumber);
 	  return;
+  }
 
-  nameWithSequence->append(m_peerName);
-  nameWithSequence->appendSequenceNumber(m_currentFileNumber);
-
-
-  interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
-  interest->setName(*nameWithSequence);
-  interest->setCanBePrefix(false);
-  time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
-  interest->setInterestLifetime(interestLifeTime);
-
-  NS_LOG_INFO("> Interest for " << *nameWithSequence);
-
-  WillSendOutInterest(seq);
-
-  m_transmittedInterests(interest, this, m_face);
-  m_appLink->onReceiveInterest(*interest);
-
-  ScheduleNextPacket();
-
-
-  */
-
-  if(m_sendSync)
-  {
-
-	  shared_ptr<Name> nameSyncWithSequence = make_shared<Name>("/prefix/peer");
-	  nameSyncWithSequence->append(m_peerName);
-	  nameSyncWithSequence->append("local_sync");
-	  nameSyncWithSequence->appendSequenceNumber(seq);
-
-	  shared_ptr<Interest> interestSync = make_shared<Interest>();
-	  interestSync->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
-	  interestSync->setName(*nameSyncWithSequence);
-	  interestSync->setCanBePrefix(false);
-	  time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
-	  interestSync->setInterestLifetime(interestLifeTime);
+  int selectProxyName = (rand()%3);
+  NDN_APP_LOG_INFO("selectProxyName = "<< selectProxyName);
+  Name namePushDataWithSequence(GetProxyPrefix(selectProxyName));
+  namePushDataWithSequence.append(names::FileId(fileNumber));
 
-	  NS_LOG_INFO("> Interest for " << *nameSyncWithSequence);
+  shared_ptr<Interest> interestPushData = make_shared<Interest>();
+  interestPushData->setName(namePushDataWithSequence);
 
-	  WillSendOutInterest(seq);
+  NDN_APP_LOG_INFO("Push m_DataPacket = "<< dataPacket);
+  const char* buf = dataPacket.c_str();
+  size_t buf_size = dataPacket.length();
+  interestPushData->setParameters(make_shared< ::ndn::Buffer>(buf,buf_size));
 
-	  m_transmittedInterests(interestSync, this, m_face);
-	  m_appLink->onReceiveInterest(*interestSync);
+  // nothing comes back for a push either, tracking it would only inflate the RTO
+  TransmitInterest(interestPushData);
+}
 
-	  ScheduleNextPacket();
-	  m_sendSync = false;
+void
+PeerConsumer::SendSummaryInterests()
+{
+  std::vector<const SyncPeer*> peers;
+  for (const SyncPeer& peer : m_syncPeers)
+	  peers.push_back(&peer);
+
+  // gossip: a random subset, the rest is reached through the peers that are polled
+  if (m_gossipFanout > 0 && m_gossipFanout < peers.size()) {
+	  for (uint32_t i = 0; i < m_gossipFanout; i++)
+		  std::swap(peers[i], peers[GetRand()->GetInteger(i, peers.size() - 1)]);
+	  peers.resize(m_gossipFanout);
   }
 
-  if(m_pushDataPacket)
-  {
-	  int selectProxyName = (rand()%3);
-	  NS_LOG_INFO("selectProxyName = "<< selectProxyName);
-	  std::string SelectedProxyName;
-	  if(selectProxyName == 0)
-		  SelectedProxyName = "/cnn";
-	  else if(selectProxyName == 1)
-			  SelectedProxyName = "/bbc";
-	  else if(selectProxyName == 2)
-		  SelectedProxyName = "/nytimes";
+  for (const SyncPeer* peer : peers) {
+	  Name nameSummary(names::PrefixPeer());
+	  nameSummary.append(peer->name);
+	  nameSummary.append(names::SummaryVector());
+	  nameSummary.appendSequenceNumber(m_seq++); // a new name every round, never a cached reply
 
-	  shared_ptr<Name> namePushDataWithSequence = make_shared<Name>(SelectedProxyName);
-	  namePushDataWithSequence->appendSequenceNumber(seq);
+	  shared_ptr<Interest> interestSummary = make_shared<Interest>();
+	  interestSummary->setName(nameSummary);
 
-	  shared_ptr<Interest> interestPushData = make_shared<Interest>();
-	  interestPushData->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
-	  interestPushData->setName(*namePushDataWithSequence);
-	  interestPushData->setCanBePrefix(false);
-	  time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
-	  interestPushData->setInterestLifetime(interestLifeTime);
-
-	  //std::string interestParameter = "This is a real data packet";
-
-	  NS_LOG_INFO("Push m_DataPacket = "<< m_DataPacket);
-	  const char* buf = m_DataPacket.c_str();
-	  size_t buf_size = m_DataPacket.length();
-	  interestPushData->setParameters(make_shared< ::ndn::Buffer>(buf,buf_size));
+	  // re-sent every round anyway, so not tracked for retransmission
+	  TransmitInterest(interestSummary);
+  }
+}
 
+void
+PeerConsumer::SendPeerFileInterest(uint32_t fileNumber, const name::Component& holder)
+{
+  Name namePeerFile(names::PrefixPeer());
+  namePeerFile.append(holder);
+  namePeerFile.append(names::File());
+  namePeerFile.append(names::FileId(fileNumber));
 
-	  NS_LOG_INFO("> Interest for " << *namePushDataWithSequence);
+  shared_ptr<Interest> interestPeerFile = make_shared<Interest>();
+  interestPeerFile->setName(namePeerFile);
 
-	  WillSendOutInterest(m_currentFileNumber-1); // could be a problem
+  // re-sent every round while the file is pending, the holder may change in between
+  TransmitInterest(interestPeerFile);
+}
 
-	  m_transmittedInterests(interestPushData, this, m_face);
-	  m_appLink->onReceiveInterest(*interestPushData);
+void
+PeerConsumer::StoreFile(uint32_t fileNumber)
+{
+  std::string original = MakeOriginal(fileNumber);
 
-	  ScheduleNextPacket();
+  // same name and parameters as the push of Peer A, see PeerProducer::OnInterest
+  Name nameStore(names::PrefixPeer());
+  nameStore.append(m_peerName.Get());
+  nameStore.append(names::FileId(fileNumber));
 
-	  m_pushDataPacket = false;
-	  m_DataPacket = "";
+  shared_ptr<Interest> interestStore = make_shared<Interest>();
+  interestStore->setName(nameStore);
+  interestStore->setParameters(make_shared< ::ndn::Buffer>(original.c_str(), original.length()));
 
-  }
+  TransmitInterest(interestStore);
 }
 
 ///////////////////////////////////////////////////
@@ -371,175 +419,187 @@ PeerConsumer::OnData(shared_ptr<const Data> data)
   if (!m_active)
     return;
 
+  NDN_APP_PROFILE("OnData");
+
   App::OnData(data); // tracing inside
 
-  NS_LOG_FUNCTION(this << data);
+  NDN_APP_LOG_FUNCTION(this << data);
 
-  //uint32_t seq = data->getName().at(-1).toSequenceNumber();
-  Name dataName = data->getName();
-  NS_LOG_INFO("< DATA for " << dataName);
+  const Name& dataName = data->getName();
+  NDN_APP_LOG_INFO("< DATA for " << dataName);
 
+  // /prefix/peer/<peer>/sv/<round> ends with the round, every other name with a file number
+  // (for metadata the first one of the range); without it the Data matches no request
+  bool isSummary = names::PrefixPeer().isPrefixOf(dataName) && dataName.size() == 5 &&
+                   dataName.get(3) == names::SummaryVector();
+  uint32_t seq = 0;
+  if(!isSummary && (dataName.empty() || !names::ParseFileId(dataName.at(-1), seq)))
+  {
+	  NDN_APP_LOG_INFO("No file number in " << dataName << ", dropped");
+	  return;
+  }
+  uint32_t requestClass = REQUEST_FILE;
 
-  if(dataName.getSubName(0,2).equals("/prefix/metadata"))
+  if(names::PrefixMetadata().isPrefixOf(dataName))
   {
 
-	  NS_LOG_INFO("< Get Metadata!!! " );
+	  NDN_APP_LOG_INFO("< Get Metadata!!! " );
+	  requestClass = REQUEST_METADATA;
 	  Block content = data->getContent();
-	  std::string content2 = std::string((char*)content.value());
+	  std::string content2(reinterpret_cast<const char*>(content.value()), content.value_size());
 	  if(content2.substr(0,5)== "start")
 	  {
-		  m_start = std::strtoul(content2.substr(6,3).c_str(),nullptr,10);
-		  m_end = std::strtoul(content2.substr(13,3).c_str(),nullptr,10);
-		  m_currentFileNumber = m_start;
-		  NS_LOG_INFO("start =  "<<m_start<<" end = "<< m_end);
+		  // start=<first>end=<last>, each at least three digits but not limited to them
+		  size_t endPos = content2.find("end=");
+		  m_start = std::strtoul(content2.c_str() + 6, nullptr, 10);
+		  m_end = endPos != std::string::npos ? std::strtoul(content2.c_str() + endPos + 4, nullptr, 10) : 0;
+		  NDN_APP_LOG_INFO("start =  "<<m_start<<" end = "<< m_end);
+		  if(!m_getMetaData && m_end >= m_start)
+			  m_files.assign(m_end - m_start + 1, FileEntry{FILE_FETCHING, 0});
 		  m_getMetaData = true;
 
 	  }
 
 	  else
 	  {
-		  NS_LOG_INFO("Content is = " << content2 );
-		  NS_LOG_INFO(m_peerName <<" is an Invalid Peer !!!" );
+		  NDN_APP_LOG_INFO("Content is = " << content2 );
+		  NDN_APP_LOG_INFO(m_peerName <<" is an Invalid Peer !!!" );
 		  m_isValidPeer = false;
 	  }
 
   }
 
-  else if(dataName.getSubName(0,2).equals("/prefix/file") && m_getMetaData)
-
-	  //add consumer name  ?? may be no
-	  // check data validity also
-	  // somewhere in the code check the file number limit
-
+  else if(names::PrefixFile().isPrefixOf(dataName) && m_getMetaData)
   {
+	  FileEntry* file = GetFile(seq);
 	  Block contentBlock = data->getContent();
-	  std::string content = std::string((char*)contentBlock.value()).substr(0,28);
-	  NS_LOG_INFO("< Data content is : " << content);
-	  if(content.substr(0,8) == "Original") // should never be true here but must be true later
+	  // empty for a file ProducerA already flagged, so not a C string
+	  std::string content = std::string(reinterpret_cast<const char*>(contentBlock.value()), contentBlock.value_size()).substr(0,28);
+	  NDN_APP_LOG_INFO("< Data content is : " << content);
+	  if(file != nullptr && file->state == FILE_FETCHING)
 	  {
-
-		  m_currentFileNumber++;
-		  m_pushDataPacket = true;
-	  }
-
-	  else
-	  {
-		  NS_LOG_INFO("The retxCount is = "<< m_retxCount);
-		  //m_DataPacket = "";
-		  m_retxCount++;
+		  if(content.substr(0,8) == "Original")
+		  {
+			  file->state = FILE_PUSHING;
+		  }
+		  else if(++file->bogusCount == 3)
+		  {
+			  // ProducerA flags the file after the same Interest reached it three times
+			  NDN_APP_LOG_INFO("File " << seq << " is censored");
+			  file->state = FILE_CENSORED;
+		  }
 	  }
   }
 
-  else if(dataName.getSubName(0,2).equals("/prefix/peer"))
+  else if(names::PrefixPeer().isPrefixOf(dataName) && dataName.size() == 5)
   {
+	  const name::Component& kind = dataName.get(3);
 	  Block contentBlock = data->getContent();
-	  m_DataPacket = std::string((char*)contentBlock.value()).substr(0,33);
-	  NS_LOG_INFO("< Data content from PeerProducer is : " << m_DataPacket);
-	  if(m_DataPacket.substr(0,8) == "Original")
+	  std::string content(reinterpret_cast<const char*>(contentBlock.value()), contentBlock.value_size());
+
+	  // the round is not tracked, nothing to acknowledge
+	  if(isSummary)
 	  {
-		  m_pushDataPacket = true;
+		  for (SyncPeer& peer : m_syncPeers)
+		  {
+			  uint32_t version = 0;
+			  PeerProducer::FileSet files;
+			  if(peer.name == dataName.get(2) && PeerProducer::DecodeSummary(content, version, files) && version > peer.version)
+			  {
+				  peer.version = version;
+				  peer.files = files;
+			  }
+		  }
+		  return;
 	  }
-  }
 
+	  // local_sync from the own PeerProducer or file from a sync peer
+	  FileEntry* file = GetFile(seq);
+	  std::string dataPacket = content.substr(0,33);
+	  NDN_APP_LOG_INFO("< Data content from PeerProducer is : " << dataPacket);
+	  bool fromPeer = kind == names::File();
+	  if(file != nullptr && dataPacket.substr(0,8) == "Original" &&
+	     (file->state == FILE_SYNCING || (fromPeer && file->state == FILE_FETCHING)))
+	  {
+		  if(fromPeer)
+			  StoreFile(seq);
+		  if(file->state == FILE_SYNCING)
+			  m_fileRecovered(this, seq, fromPeer);
 
+		  file->state = FILE_PUSHING;
 
+		  // the fetch from ProducerA, if still out, will not be needed
+		  StopTracking(seq, REQUEST_FILE);
+	  }
 
-  if(m_retxCount==3)
-  {
-	  m_retxCount = 0;
-	  //m_seq++;
-	  m_currentFileNumber++;
-	  m_sendSync = true;
-  }
-
-  /*
-  else if(data from /prefix/peer/B/local)
-  {
-	  //original data packet
-	  Block contentBlock = data->getContent();
-	  m_DataPacket = std::string((char*)contentBlock.value());
-	  NS_LOG_INFO("< Data content is : " << m_DataPacket);
-	  m_currentFileNumber++;
-	  m_pushDataPacket = true;
-  }
-
-  if(m_retxCount==3)
-  {
-	  m_retxCount = 0;
-	  m_seq++;
-	  m_sendSync = true;
-  }
-  int hopCount = 0;
-  auto hopCountTag = data->getTag<lp::HopCountTag>();
-  if (hopCountTag != nullptr) { // e.g., packet came from local node's cache
-    hopCount = *hopCountTag;
-  }
-  NS_LOG_DEBUG("Hop count: " << hopCount);
-
-  SeqTimeoutsContainer::iterator entry = m_seqLastDelay.find(seq);
-  if (entry != m_seqLastDelay.end()) {
-    m_lastRetransmittedInterestDataDelay(this, seq, Simulator::Now() - entry->time, hopCount);
-  }
-
-  entry = m_seqFullDelay.find(seq);
-  if (entry != m_seqFullDelay.end()) {
-    m_firstInterestDataDelay(this, seq, Simulator::Now() - entry->time, m_seqRetxCounts[seq], hopCount);
+	  // local_sync and peer files are sent untracked
+	  return;
   }
 
-  m_seqRetxCounts.erase(seq);
-  m_seqFullDelay.erase(seq);
-  m_seqLastDelay.erase(seq);
-
-  m_seqTimeouts.erase(seq);
-  m_retxSeqs.erase(seq);
-
-  m_rtt->AckSeq(SequenceNumber32(seq));
-
-
-
-
-  */
+  AcknowledgeData(*data, seq, requestClass);
 }
 
-void
-PeerConsumer::OnNack(shared_ptr<const lp::Nack> nack)
-{
-  /// tracing inside
-  App::OnNack(nack);
-
-  NS_LOG_INFO("NACK received for: " << nack->getInterest().getName()
-              << ", reason: " << nack->getReason());
-}
+///////////////////////////////////////////////////
+//          Snapshot                             //
+///////////////////////////////////////////////////
 
 void
-PeerConsumer::OnTimeout(uint32_t sequenceNumber)
+PeerConsumer::SaveState(SnapshotWriter& writer) const
 {
-  NS_LOG_FUNCTION(sequenceNumber);
-  // std::cout << Simulator::Now () << ", TO: " << sequenceNumber << ", current RTO: " <<
-  // m_rtt->RetransmitTimeout ().ToDouble (Time::S) << "s\n";
-
-  m_rtt->IncreaseMultiplier(); // Double the next RTO
-  m_rtt->SentSeq(SequenceNumber32(sequenceNumber),
-                 1); // make sure to disable RTT calculation for this sample
-  m_retxSeqs.insert(sequenceNumber);
-  ScheduleNextPacket();
+  SaveEngineState(writer);
+
+  writer.Put(m_getMetaData);
+  writer.Put(m_isValidPeer);
+  writer.Put(m_start);
+  writer.Put(m_end);
+  writer.Put(m_firstPendingFile);
+  writer.Put(static_cast<uint32_t>(m_files.size()));
+  for (const FileEntry& file : m_files) {
+    writer.Put(static_cast<uint32_t>(file.state));
+    writer.Put(static_cast<uint32_t>(file.bogusCount));
+  }
+
+  // the sync peers themselves come from the attribute, only what they advertised is state
+  writer.Put(static_cast<uint32_t>(m_syncPeers.size()));
+  for (const SyncPeer& peer : m_syncPeers) {
+    writer.Put(peer.version);
+    writer.Put(peer.files.to_string());
+  }
 }
 
 void
-PeerConsumer::WillSendOutInterest(uint32_t sequenceNumber)
+PeerConsumer::LoadState(SnapshotReader& reader)
 {
-  //NS_LOG_DEBUG("Trying to add " << sequenceNumber << " with " << Simulator::Now() << ". already "
-  //                              << m_seqTimeouts.size() << " items");
-
-  m_seqTimeouts.insert(SeqTimeout(sequenceNumber, Simulator::Now()));
-  m_seqFullDelay.insert(SeqTimeout(sequenceNumber, Simulator::Now()));
-
-  m_seqLastDelay.erase(sequenceNumber);
-  m_seqLastDelay.insert(SeqTimeout(sequenceNumber, Simulator::Now()));
-
-  m_seqRetxCounts[sequenceNumber]++;
+  LoadEngineState(reader);
+
+  uint32_t fileCount = 0;
+  reader.Get(m_getMetaData);
+  reader.Get(m_isValidPeer);
+  reader.Get(m_start);
+  reader.Get(m_end);
+  reader.Get(m_firstPendingFile);
+  reader.Get(fileCount);
+  m_files.assign(fileCount, FileEntry{FILE_FETCHING, 0});
+  for (FileEntry& file : m_files) {
+    uint32_t state = 0;
+    uint32_t bogusCount = 0;
+    reader.Get(state);
+    reader.Get(bogusCount);
+    file.state = static_cast<uint8_t>(state);
+    file.bogusCount = static_cast<uint8_t>(bogusCount);
+  }
 
-  m_rtt->SentSeq(SequenceNumber32(sequenceNumber), 1);
+  uint32_t peerCount = 0;
+  reader.Get(peerCount);
+  if (peerCount != m_syncPeers.size())
+    NS_FATAL_ERROR("Snapshot of " << m_peerName << " has " << peerCount << " sync peers instead of "
+                                  << m_syncPeers.size());
+  for (SyncPeer& peer : m_syncPeers) {
+    std::string files;
+    reader.Get(peer.version);
+    reader.Get(files);
+    peer.files = PeerProducer::FileSet(files);
+  }
 }
 
 } // namespace ndn
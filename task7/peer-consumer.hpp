@@ -4,23 +4,11 @@
 
 #include "ns3/ndnSIM/model/ndn-common.hpp"
 
-#include "ndn-app.hpp"
-//#include "variables.hpp"
-
-#include "ns3/random-variable-stream.h"
-#include "ns3/nstime.h"
-#include "ns3/data-rate.h"
-
-#include "ns3/ndnSIM/model/ndn-common.hpp"
-#include "ns3/ndnSIM/utils/ndn-rtt-estimator.hpp"
-
-#include <set>
-#include <map>
+#include "consumer-engine.hpp"
+#include "peer-producer.hpp"
 
-#include <boost/multi_index_container.hpp>
-#include <boost/multi_index/tag.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-#include <boost/multi_index/member.hpp>
+#include <vector>
+//#include "variables.hpp"
 
 namespace ns3 {
 namespace ndn {
@@ -28,9 +16,32 @@ namespace ndn {
 /**
  * @ingroup ndn-apps
  * \brief NDN application for sending out Interest packets
+ *
+ * Fetches the metadata and then the files of its peer, falling back to the local_sync of the
+ * PeerProducer and pushing original data packets to a proxy when a file is censored.
+ *
+ * Every file of the range has its own state. Up to MaxFilesInFlight files are fetched at once;
+ * files that turned out censored wait for their original in the background, so they do not hold
+ * back the rest of the range.
+ *
+ * With SyncPeers set, it also polls the state vector of those peers' PeerProducers. A censored
+ * file that one of them already holds is fetched from it (/prefix/peer/<peer>/file/<file>)
+ * without waiting for ProducerA, and every file obtained that way is stored at the own
+ * PeerProducer so that it is advertised in turn.
+ *
+ * With CodeK > 0 a recovered file is not pushed whole to one random proxy but as CodeN blocks
+ * of a k-of-n erasure code, block i to proxy prefix i % 3, so that any CodeK of them rebuild it.
+ *
+ * GossipFanout > 0 turns this into epidemic dissemination: each round only that many randomly
+ * chosen sync peers are polled, files still being fetched are taken from a sync peer holding
+ * them rather than from the origin, and every validated original is re-served by the own
+ * PeerProducer.
  */
-class PeerConsumer : public App {
+class PeerConsumer : public ConsumerEngine<PeerConsumer>, public SnapshotState {
 public:
+  typedef void (*FileRecoveredCallback)(Ptr<App> app, uint32_t file, bool fromPeer);
+  typedef void (*RangeCompletedCallback)(Ptr<App> app);
+
   static TypeId
   GetTypeId();
 
@@ -45,16 +56,12 @@ public:
   virtual void
   OnData(shared_ptr<const Data> contentObject);
 
-  // From App
+  // From SnapshotState
   virtual void
-  OnNack(shared_ptr<const lp::Nack> nack);
+  SaveState(SnapshotWriter& writer) const;
 
-  /**
-   * @brief Timeout event
-   * @param sequenceNumber time outed sequence number
-   */
   virtual void
-  OnTimeout(uint32_t sequenceNumber);
+  LoadState(SnapshotReader& reader);
 
   /**
    * @brief Actually send packet
@@ -63,149 +70,152 @@ public:
   SendPacket();
 
   /**
-   * @brief An event that is fired just before an Interest packet is actually send out (send is
-   *inevitable)
-   *
-   * The reason for "before" even is that in certain cases (when it is possible to satisfy from the
-   *local cache),
-   * the send call will immediately return data, and if "after" even was used, this after would be
-   *called after
-   * all processing of incoming data, potentially producing unexpected results.
+   * \brief Proxy prefix (/cnn, /bbc or /nytimes) of push or block number @p index
    */
-  virtual void
-  WillSendOutInterest(uint32_t sequenceNumber);
-
-public:
-  typedef void (*LastRetransmittedInterestDataDelayCallback)(Ptr<App> app, uint32_t seqno, Time delay, int32_t hopCount);
-  typedef void (*FirstInterestDataDelayCallback)(Ptr<App> app, uint32_t seqno, Time delay, uint32_t retxCount, int32_t hopCount);
+  static const Name&
+  GetProxyPrefix(uint32_t index);
 
 protected:
-  // from App
-  virtual void
-  StartApplication();
+  friend class ConsumerEngine<PeerConsumer>;
 
-  virtual void
-  StopApplication();
+  /**
+   * \brief Scheduling policy: gap between two SendPacket calls
+   */
+  Time
+  GetSendInterval() const
+  {
+    return Seconds(1.0);
+  }
 
   /**
-   * \brief Constructs the Interest packet and sends it using a callback to the underlying NDN
-   * protocol
+   * \brief Scheduling policy: invalid peers stop once ProducerA has rejected them
    */
-  virtual void
-  ScheduleNextPacket() = 0;
+  bool
+  CanSend() const
+  {
+    return m_isValidPeer && (!m_getMetaData || m_firstPendingFile < m_files.size());
+  }
 
+  /// @cond include_hidden
   /**
-   * \brief Checks if the packet need to be retransmitted becuase of retransmission timer expiration
+   * \brief Request classes of the engine, each with its own RTT estimator
+   *
+   * local_sync is not tracked: it waits at the own PeerProducer until the original is released,
+   * and is renewed every round instead.
    */
-  void
-  CheckRetxTimeout();
+  enum RequestClass : uint32_t {
+    REQUEST_METADATA,
+    REQUEST_FILE
+  };
 
   /**
-   * \brief Modifies the frequency of checking the retransmission timeouts
-   * \param retxTimer Timeout defining how frequent retransmission timeouts should be checked
+   * \brief Progress of one file through the recovery protocol
    */
+  enum FileState : uint8_t {
+    FILE_FETCHING, ///< requesting /prefix/file/<peer>/<file>
+    FILE_CENSORED, ///< three bogus replies, local_sync not requested yet
+    FILE_SYNCING,  ///< waiting for the original at the local PeerProducer
+    FILE_PUSHING,  ///< original at hand, push to a proxy pending
+    FILE_DONE
+  };
+
+  struct FileEntry {
+    uint8_t state;      ///< FileState
+    uint8_t bogusCount; ///< bogus replies received while fetching
+  };
+
+  /**
+   * \brief Last state vector received from one of the SyncPeers
+   */
+  struct SyncPeer {
+    name::Component name;
+    uint32_t version;
+    PeerProducer::FileSet files;
+  };
+  /// @endcond
+
+  /**
+   * \brief Returns the entry of @p fileNumber, or nullptr if it is outside the assigned range
+   */
+  FileEntry*
+  GetFile(uint32_t fileNumber);
+
+  void
+  SendMetadataInterest();
+
   void
-  SetRetxTimer(Time retxTimer);
+  SendFileInterest(uint32_t fileNumber);
+
+  void
+  SendSyncInterest(uint32_t fileNumber);
 
   /**
-   * \brief Returns the frequency of checking the retransmission timeouts
-   * \return Timeout defining how frequent retransmission timeouts should be checked
+   * \brief Re-sends a timed out request, or stops tracking it if the file has moved on
    */
-  Time
-  GetRetxTimer() const;
+  void
+  Retransmit(uint32_t seq, uint32_t requestClass);
 
-protected:
-  Ptr<UniformRandomVariable> m_rand; ///< @brief nonce generator
-
-  uint32_t m_seq;      ///< @brief currently requested sequence number
-  uint32_t m_seqMax;   ///< @brief maximum number of sequence number
-  EventId m_sendEvent; ///< @brief EventId of pending "send packet" event
-  Time m_retxTimer;    ///< @brief Currently estimated retransmission timer
-  EventId m_retxEvent; ///< @brief Event to check whether or not retransmission should be performed
-
-  Ptr<RttEstimator> m_rtt; ///< @brief RTT estimator
-
-  Time m_offTime;          ///< \brief Time interval between packets
-  Name m_interestName;     ///< \brief NDN Name of the Interest (use Name)
-  Time m_interestLifeTime; ///< \brief LifeTime for interest packet
-  int m_retxCount;
-  bool m_sendSync;
-  bool m_pushDataPacket;
-  std::string m_DataPacket;
-  Name m_peerName;
-  bool m_getMetaData;
-  uint32_t m_start;
-  uint32_t m_end;
-  uint32_t m_currentFileNumber;
-  uint32_t m_peerKey;
-  bool m_isValidPeer;
+  void
+  SendPush(uint32_t fileNumber);
 
-  /// @cond include_hidden
   /**
-   * \struct This struct contains sequence numbers of packets to be retransmitted
+   * \brief Requests the current state vector of every sync peer, or of GossipFanout random ones
    */
-  struct RetxSeqsContainer : public std::set<uint32_t> {
-  };
+  void
+  SendSummaryInterests();
 
-  RetxSeqsContainer m_retxSeqs; ///< \brief ordered set of sequence numbers to be retransmitted
+  void
+  SendPeerFileInterest(uint32_t fileNumber, const name::Component& holder);
 
   /**
-   * \struct This struct contains a pair of packet sequence number and its timeout
+   * \brief Hands an original to the own PeerProducer, which then advertises it
    */
-  struct SeqTimeout {
-    SeqTimeout(uint32_t _seq, Time _time)
-      : seq(_seq)
-      , time(_time)
-    {
-    }
-
-    uint32_t seq;
-    Time time;
-  };
-  /// @endcond
+  void
+  StoreFile(uint32_t fileNumber);
 
-  /// @cond include_hidden
-  class i_seq {
-  };
-  class i_timestamp {
-  };
-  /// @endcond
+  /**
+   * \brief Content of the original of @p fileNumber, as served by ProducerA
+   */
+  static std::string
+  MakeOriginal(uint32_t fileNumber);
 
-  /// @cond include_hidden
   /**
-   * \struct This struct contains a multi-index for the set of SeqTimeout structs
+   * \brief Returns the first (nearest) sync peer advertising @p fileNumber, or nullptr
    */
-  struct SeqTimeoutsContainer
-    : public boost::multi_index::
-        multi_index_container<SeqTimeout,
-                              boost::multi_index::
-                                indexed_by<boost::multi_index::
-                                             ordered_unique<boost::multi_index::tag<i_seq>,
-                                                            boost::multi_index::
-                                                              member<SeqTimeout, uint32_t,
-                                                                     &SeqTimeout::seq>>,
-                                           boost::multi_index::
-                                             ordered_non_unique<boost::multi_index::
-                                                                  tag<i_timestamp>,
-                                                                boost::multi_index::
-                                                                  member<SeqTimeout, Time,
-                                                                         &SeqTimeout::time>>>> {
-  };
+  const SyncPeer*
+  FindHolder(uint32_t fileNumber) const;
+
+  void
+  SetSyncPeers(const std::string& peers);
 
-  SeqTimeoutsContainer m_seqTimeouts; ///< \brief multi-index for the set of SeqTimeout structs
+  std::string
+  GetSyncPeers() const;
 
-  SeqTimeoutsContainer m_seqLastDelay;
-  SeqTimeoutsContainer m_seqFullDelay;
-  std::map<uint32_t, uint32_t> m_seqRetxCounts;
+protected:
+  InternedName m_peerName;
+  bool m_getMetaData;
+  uint32_t m_start;
+  uint32_t m_end;
+  uint32_t m_peerKey;
+  std::string m_peerToken;
+  bool m_isValidPeer;
 
-  TracedCallback<Ptr<App> /* app */, uint32_t /* seqno */, Time /* delay */, int32_t /*hop count*/>
-    m_lastRetransmittedInterestDataDelay;
-  TracedCallback<Ptr<App> /* app */, uint32_t /* seqno */, Time /* delay */,
-                 uint32_t /*retx count*/, int32_t /*hop count*/> m_firstInterestDataDelay;
+  std::vector<FileEntry> m_files; ///< \brief state of file m_start + i at index i
+  uint32_t m_firstPendingFile;    ///< \brief index of the first file that is not done yet
+  uint32_t m_maxFilesInFlight;    ///< \brief number of files fetched concurrently
 
-  /// @endcond
+  std::vector<SyncPeer> m_syncPeers; ///< \brief peers whose state vector is polled, nearest first
+  uint32_t m_gossipFanout;           ///< \brief sync peers polled per round, 0 polls all (no gossip)
+  bool m_pushToProxy;                ///< \brief push originals to /cnn, /bbc or /nytimes
+  uint32_t m_codeK;                  ///< \brief blocks needed to rebuild a pushed file, 0 pushes it whole
+  uint32_t m_codeN;                  ///< \brief blocks pushed per file
+
+  TracedCallback<Ptr<App> /* app */, uint32_t /* file */, bool /* fromPeer */> m_fileRecovered;
+  TracedCallback<Ptr<App> /* app */> m_rangeCompleted;
 };
 
+extern template class ConsumerEngine<PeerConsumer>;
+
 } // namespace ndn
 } // namespace ns3
 
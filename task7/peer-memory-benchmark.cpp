@@ -0,0 +1,91 @@
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/ndnSIM-module.h"
+#include "ns3/ndnSIM/apps/ndn-app-installer.hpp"
+#include "ns3/ndnSIM/apps/ndn-name-table.hpp"
+#include "ns3/ndnSIM/apps/peer-consumer-cbr.hpp"
+
+#include <fstream>
+#include <iostream>
+
+#include <unistd.h>
+
+namespace ns3 {
+
+static std::string
+PeerName(uint32_t node)
+{
+  return "P" + std::to_string(node);
+}
+
+// resident set size of the process now, unlike ru_maxrss not a peak
+static uint64_t
+ResidentBytes()
+{
+  std::ifstream statm("/proc/self/statm");
+  uint64_t size = 0;
+  uint64_t resident = 0;
+  statm >> size >> resident;
+  return resident * sysconf(_SC_PAGESIZE);
+}
+
+// Memory of idle peers: a PeerConsumerCbr and a PeerProducer per node, set up as in the epidemic
+// scenario (two tree neighbours as SyncPeers) but not started. The nodes exist before the first
+// measurement, so the growth of the resident set is the apps with their attributes and the
+// interned Names. Run it with nPeers=1000, 10000 and 100000 in separate processes; the fixed cost
+// of the first apps (TypeIds, the Name table) only shows at the small sizes.
+//
+// Prints "PeerMemory key=value ..." on stderr for scenario-benchmark.py.
+int
+main(int argc, char* argv[])
+{
+  uint32_t nPeers = 1000;
+
+  CommandLine cmd;
+  cmd.AddValue("nPeers", "Number of peers, each a PeerConsumerCbr and a PeerProducer on a node", nPeers);
+  cmd.Parse(argc, argv);
+
+  NodeContainer nodes;
+  nodes.Create(nPeers);
+
+  TypeId consumerType = TypeId::LookupByName("ns3::ndn::PeerConsumerCbr");
+  TypeId producerType = TypeId::LookupByName("ns3::ndn::PeerProducer");
+  ndn::BulkAppInstaller apps;
+  for (uint32_t i = 0; i < nPeers; i++) {
+    ndn::PeerConsumerAttributes consumer;
+    consumer.prefix = "/prefix/";
+    consumer.peerKey = 10001;
+    consumer.peerName = PeerName(i);
+    consumer.syncPeers = PeerName(i / 2) + "," + PeerName(i * 2 + 1);
+    consumer.pushToProxy = false;
+    apps.Add(nodes.Get(i), consumerType, consumer);
+
+    ndn::PeerProducerAttributes producer;
+    producer.prefix = "/prefix/peer";
+    producer.peerName = PeerName(i);
+    apps.Add(nodes.Get(i), producerType, producer);
+  }
+
+  uint64_t before = ResidentBytes();
+  apps.Install();
+  uint64_t after = ResidentBytes();
+
+  double bytesPerPeer = static_cast<double>(after - before) / nPeers;
+  std::cout << "peers: " << nPeers << ", resident growth: " << (after - before) / 1024 << " kB, "
+            << bytesPerPeer << " bytes per peer\n"
+            << "sizeof PeerConsumerCbr: " << sizeof(ndn::PeerConsumerCbr)
+            << ", PeerProducer: " << sizeof(ndn::PeerProducer)
+            << ", interned Names: " << ndn::NameTable::GetN() << "\n";
+  std::cerr << "PeerMemory peers=" << nPeers << " bytes_per_peer=" << bytesPerPeer << "\n";
+
+  Simulator::Destroy();
+  return 0;
+}
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+  return ns3::main(argc, argv);
+}
@@ -1,5 +1,6 @@
 #include "peer-producer.hpp"
-#include "ns3/log.h"
+#include "ndn-app-log.hpp"
+#include "ndn-app-profile.hpp"
 #include "ns3/string.h"
 #include "ns3/uinteger.h"
 #include "ns3/packet.h"
@@ -9,6 +10,7 @@
 #include "helper/ndn-fib-helper.hpp"
 
 #include <memory>
+#include <string>
 
 NS_LOG_COMPONENT_DEFINE("ndn.PeerProducer");
 
@@ -26,13 +28,13 @@ PeerProducer::GetTypeId(void)
       .SetParent<App>()
       .AddConstructor<PeerProducer>()
       .AddAttribute("Prefix", "Prefix, for which producer has the data", StringValue("/"),
-                    MakeNameAccessor(&PeerProducer::m_prefix), MakeNameChecker())
+                    MakeInternedNameAccessor(&PeerProducer::m_prefix), MakeNameChecker())
       .AddAttribute(
          "Postfix",
          "Postfix that is added to the output data (e.g., for adding producer-uniqueness)",
-         StringValue("/"), MakeNameAccessor(&PeerProducer::m_postfix), MakeNameChecker())
+         StringValue("/"), MakeInternedNameAccessor(&PeerProducer::m_postfix), MakeNameChecker())
 	  .AddAttribute("PeerName", "Name of the Peer", StringValue("/"),
-		              MakeNameAccessor(&PeerProducer::m_peerName), MakeNameChecker())
+		              MakeInternedNameAccessor(&PeerProducer::m_peerName), MakeNameChecker())
       .AddAttribute("PayloadSize", "Virtual payload size for Content packets", UintegerValue(1024),
                     MakeUintegerAccessor(&PeerProducer::m_virtualPayloadSize),
                     MakeUintegerChecker<uint32_t>())
@@ -46,30 +48,30 @@ PeerProducer::GetTypeId(void)
          MakeUintegerChecker<uint32_t>())
       .AddAttribute("KeyLocator",
                     "Name to be used for key locator.  If root, then key locator is not used",
-                    NameValue(), MakeNameAccessor(&PeerProducer::m_keyLocator), MakeNameChecker());
+                    NameValue(), MakeInternedNameAccessor(&PeerProducer::m_keyLocator), MakeNameChecker());
   return tid;
 }
 
 PeerProducer::PeerProducer()
-	: m_isDataReceived(false)
+  : m_summaryVersion(0)
 {
-  NS_LOG_FUNCTION_NOARGS();
+  NDN_APP_LOG_FUNCTION_NOARGS();
 }
 
 
 void
 PeerProducer::StartApplication()
 {
-  NS_LOG_FUNCTION_NOARGS();
+  NDN_APP_LOG_FUNCTION_NOARGS();
   App::StartApplication();
-  m_prefix.append(m_peerName);
-  FibHelper::AddRoute(GetNode(),m_prefix , m_face, 0);
+  m_prefix = InternedName(Name(m_prefix.Get()).append(m_peerName.Get()));
+  FibHelper::AddRoute(GetNode(), m_prefix.Get(), m_face, 0);
 }
 
 void
 PeerProducer::StopApplication()
 {
-  NS_LOG_FUNCTION_NOARGS();
+  NDN_APP_LOG_FUNCTION_NOARGS();
 
   App::StopApplication();
 }
@@ -79,64 +81,163 @@ PeerProducer::OnInterest(shared_ptr<const Interest> interest)
 {
   App::OnInterest(interest);
 
-  NS_LOG_FUNCTION(this << interest);
+  NDN_APP_LOG_FUNCTION(this << interest);
 
   if (!m_active)
     return;
 
-  Name dataName(interest->getName());
+  NDN_APP_PROFILE("OnInterest");
 
+  const Name& dataName = interest->getName();
 
-  Name localhost = "/prefix/peer";
-  localhost.append(m_peerName);
-  localhost.append("local_sync");
+  // m_prefix is /prefix/peer/<peer> once started, built and interned in StartApplication
+  const Name& localhost = m_prefix.Get();
 
+  // local_sync, sv and file Interests carry the file or round as their last component
+  if (dataName.size() == 5 && localhost.isPrefixOf(dataName))
+  {
+	  const name::Component& kind = dataName.get(3);
+
+	  if (kind == names::SummaryVector())
+	  {
+		  SendData(dataName, EncodeSummary(m_summaryVersion, m_summary));
+		  return;
+	  }
+
+	  uint32_t fileNumber = 0;
+	  if (!names::ParseFileId(dataName.at(4), fileNumber))
+		  return;
+
+	  auto recovered = m_recoveredFiles.find(fileNumber);
+	  if (recovered == m_recoveredFiles.end())
+		  return;
+
+	  // kept after serving: other peers may still fetch it through the state vector
+	  if (kind == names::LocalSync())
+	  {
+		  SendData(dataName, recovered->second);
+		  NDN_APP_LOG_INFO("Data is sent to Consumer "<< m_peerName<< ".");
+	  }
+	  else if (kind == names::File())
+	  {
+		  SendData(dataName, recovered->second);
+		  NDN_APP_LOG_INFO("File " << fileNumber << " is sent to another peer.");
+	  }
+  }
 
-  if(dataName.getSubName(0,4).equals(localhost) && m_isDataReceived) // Sending data to the node consumer app
+  else if(dataName.size() == 4 && localhost.isPrefixOf(dataName)) //Receiving data from Peer A
   {
+	   // /prefix/peer/<peer>/<file>, several files of a peer can be recovered concurrently
+	   // (also sent by the own PeerConsumer, see PeerConsumer::StoreFile)
+	   uint32_t fileNumber = 0;
+	   if (!names::ParseFileId(dataName.at(3), fileNumber))
+		   return;
 
-	   m_isDataReceived = false;
-	   auto data = make_shared<Data>();
-	   data->setName(dataName);
-	   data->setFreshnessPeriod(::ndn::time::milliseconds(m_freshness.GetMilliSeconds()));
+	   // the whole original: a fixed width would cut the number of files past 999
+	   Block parametersBlock = interest->getParameters();
+	   m_recoveredFiles[fileNumber].assign(reinterpret_cast<const char*>(parametersBlock.value()), parametersBlock.value_size());
+	   NDN_APP_LOG_INFO("Parameters from Producer A = "<< m_recoveredFiles[fileNumber]);
 
-	   const char* buff = m_Parameters.c_str();
-	   size_t buff_size = m_Parameters.length();
-	   data->setContent(make_shared< ::ndn::Buffer>(buff,buff_size));
+	   if (fileNumber < m_summary.size() && !m_summary.test(fileNumber))
+	   {
+		   m_summary.set(fileNumber);
+		   m_summaryVersion++;
+	   }
+  }
 
-	   m_Parameters = "";
-	   Signature signature;
-	   SignatureInfo signatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255));
+}
 
-	   if (m_keyLocator.size() > 0) {
-	     signatureInfo.setKeyLocator(m_keyLocator);
-	   }
+void
+PeerProducer::SendData(const Name& dataName, const std::string& content)
+{
+  auto data = make_shared<Data>();
+  data->setName(dataName);
+  data->setFreshnessPeriod(::ndn::time::milliseconds(m_freshness.GetMilliSeconds()));
+
+  const char* buff = content.c_str();
+  size_t buff_size = content.length();
+  data->setContent(make_shared< ::ndn::Buffer>(buff,buff_size));
 
-	   signature.setInfo(signatureInfo);
-	   signature.setValue(::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue, m_signature));
+  Signature signature;
+  SignatureInfo signatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255));
 
-	   data->setSignature(signature);
+  if (m_keyLocator.Get().size() > 0) {
+    signatureInfo.setKeyLocator(m_keyLocator.Get());
+  }
 
-	   NS_LOG_INFO("node(" << GetNode()->GetId() << ") responding with Data: " << data->getName());
+  signature.setInfo(signatureInfo);
+  signature.setValue(::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue, m_signature));
 
-	   // to create real wire encoding
-	   data->wireEncode();
+  data->setSignature(signature);
 
-	   m_transmittedDatas(data, this, m_face);
-	   m_appLink->onReceiveData(*data);
+  NDN_APP_LOG_INFO("node(" << GetNode()->GetId() << ") responding with Data: " << data->getName());
 
-	   NS_LOG_INFO("Data is sent to Consumer "<< m_peerName<< ".");
-  }
+  // to create real wire encoding
+  data->wireEncode();
 
-  else if(dataName.getSubName(0,3).equals(localhost.getSubName(0,3))) //Receiving data from Peer A
+  m_transmittedDatas(data, this, m_face);
+  m_appLink->onReceiveData(*data);
+}
+
+std::string
+PeerProducer::EncodeSummary(uint32_t version, const FileSet& files)
+{
+  static const char hex[] = "0123456789abcdef";
+
+  std::string content = std::to_string(version);
+  content.push_back(':');
+  for (size_t i = 0; i < files.size(); i += 4)
+	  content.push_back(hex[files[i] | files[i + 1] << 1 | files[i + 2] << 2 | files[i + 3] << 3]);
+  return content;
+}
+
+bool
+PeerProducer::DecodeSummary(const std::string& content, uint32_t& version, FileSet& files)
+{
+  size_t colon = content.find(':');
+  if (colon == std::string::npos || content.size() < colon + 1 + files.size() / 4)
+	  return false;
+
+  version = std::strtoul(content.c_str(), nullptr, 10);
+  files.reset();
+  for (size_t i = 0; i < files.size(); i += 4)
   {
-	   Block parametersBlock = interest->getParameters();
-	   m_Parameters = std::string((char*)parametersBlock.value()).substr(0,33);
-	   NS_LOG_INFO("Parameters from Producer A = "<< m_Parameters);
-	   m_isDataReceived = true;
+	  char c = content[colon + 1 + i / 4];
+	  uint32_t nibble = (c >= 'a') ? c - 'a' + 10 : c - '0';
+	  for (size_t bit = 0; bit < 4; bit++)
+		  files[i + bit] = (nibble >> bit) & 1;
+  }
+  return true;
+}
 
+void
+PeerProducer::SaveState(SnapshotWriter& writer) const
+{
+  writer.Put(m_summaryVersion);
+  writer.Put(static_cast<uint32_t>(m_recoveredFiles.size()));
+  for (const auto& file : m_recoveredFiles) {
+    writer.Put(file.first);
+    writer.Put(file.second);
   }
+}
 
+void
+PeerProducer::LoadState(SnapshotReader& reader)
+{
+  uint32_t fileCount = 0;
+  reader.Get(m_summaryVersion);
+  reader.Get(fileCount);
+
+  // the summary is the set of recovered files, so it is rebuilt rather than saved
+  m_recoveredFiles.clear();
+  m_summary.reset();
+  for (uint32_t i = 0; i < fileCount; i++) {
+    uint32_t fileNumber = 0;
+    reader.Get(fileNumber);
+    reader.Get(m_recoveredFiles[fileNumber]);
+    if (fileNumber < m_summary.size())
+      m_summary.set(fileNumber);
+  }
 }
 
 } // namespace ndn
@@ -4,17 +4,36 @@
 #include "ns3/ndnSIM/model/ndn-common.hpp"
 
 #include "ndn-app.hpp"
+#include "ndn-app-snapshot.hpp"
+#include "ndn-name-table.hpp"
 #include "ns3/ndnSIM/model/ndn-common.hpp"
 
 #include "ns3/nstime.h"
 #include "ns3/ptr.h"
 
+#include <bitset>
+#include <map>
+
 namespace ns3 {
 namespace ndn {
 
 
-class PeerProducer : public App {
+/**
+ * @ingroup ndn-apps
+ * @brief Keeps the originals that Peer A pushed for censored files of its peer
+ *
+ * Besides handing them to its own PeerConsumer (local_sync), it advertises them to the other
+ * peers: /prefix/peer/<peer>/sv/<seq> returns a state vector of the held files and
+ * /prefix/peer/<peer>/file/<file> returns one of them. In gossip mode the PeerConsumer also
+ * stores every original it validated here, so the PeerProducer re-serves all of them.
+ */
+class PeerProducer : public App, public SnapshotState {
 public:
+  /**
+   * \brief One bit per file number, the files a PeerProducer holds
+   */
+  typedef std::bitset<256> FileSet;
+
   static TypeId
   GetTypeId(void);
 
@@ -23,6 +42,25 @@ public:
   virtual void
   OnInterest(shared_ptr<const Interest> interest);
 
+  // From SnapshotState
+  virtual void
+  SaveState(SnapshotWriter& writer) const;
+
+  virtual void
+  LoadState(SnapshotReader& reader);
+
+  /**
+   * \brief Content of a state vector reply: "<version>:" and the set as 64 hex digits
+   */
+  static std::string
+  EncodeSummary(uint32_t version, const FileSet& files);
+
+  /**
+   * \brief Parses EncodeSummary() output, returns false if @p content is not a state vector
+   */
+  static bool
+  DecodeSummary(const std::string& content, uint32_t& version, FileSet& files);
+
 protected:
   virtual void
   StartApplication();
@@ -31,16 +69,20 @@ protected:
   StopApplication();
 
 private:
-  Name m_prefix;
-  Name m_postfix;
+  void
+  SendData(const Name& dataName, const std::string& content);
+
+  InternedName m_prefix;
+  InternedName m_postfix;
   uint32_t m_virtualPayloadSize;
   Time m_freshness;
 
   uint32_t m_signature;
-  Name m_keyLocator;
-  std::string m_Parameters;
-  bool m_isDataReceived;
-  Name m_peerName;
+  InternedName m_keyLocator;
+  std::map<uint32_t, std::string> m_recoveredFiles; ///< originals pushed by Peer A, by file number
+  FileSet m_summary;                                ///< files of m_recoveredFiles
+  uint32_t m_summaryVersion;                        ///< bumped on every new file
+  InternedName m_peerName;
 };
 
 } // namespace ndn
@@ -18,7 +18,8 @@
  **/
 
 #include "producer-censor.hpp"
-#include "ns3/log.h"
+#include "ndn-app-log.hpp"
+#include "ndn-app-profile.hpp"
 #include "ns3/string.h"
 #include "ns3/uinteger.h"
 #include "ns3/packet.h"
@@ -70,14 +71,14 @@ ProducerCensor::GetTypeId(void)
 
 ProducerCensor::ProducerCensor()
 {
-  NS_LOG_FUNCTION_NOARGS();
+  NDN_APP_LOG_FUNCTION_NOARGS();
 }
 
 // inherited from Application base class.
 void
 ProducerCensor::StartApplication()
 {
-  NS_LOG_FUNCTION_NOARGS();
+  NDN_APP_LOG_FUNCTION_NOARGS();
   App::StartApplication();
 
   FibHelper::AddRoute(GetNode(), m_prefix, m_face, 0);
@@ -87,7 +88,7 @@ ProducerCensor::StartApplication()
 void
 ProducerCensor::StopApplication()
 {
-  NS_LOG_FUNCTION_NOARGS();
+  NDN_APP_LOG_FUNCTION_NOARGS();
 
   App::StopApplication();
 }
@@ -97,11 +98,13 @@ ProducerCensor::OnInterest(shared_ptr<const Interest> interest)
 {
   App::OnInterest(interest); // tracing inside
 
-  NS_LOG_FUNCTION(this << interest);
+  NDN_APP_LOG_FUNCTION(this << interest);
 
   if (!m_active)
     return;
 
+  NDN_APP_PROFILE("OnInterest");
+
   Name dataName(interest->getName());
   // dataName.append(m_postfix);
   // dataName.appendVersion();
@@ -129,7 +132,7 @@ ProducerCensor::OnInterest(shared_ptr<const Interest> interest)
 
   data->setSignature(signature);
 
-  NS_LOG_INFO("node(" << GetNode()->GetId() << ") responding with Data: " << data->getName());
+  NDN_APP_LOG_INFO("node(" << GetNode()->GetId() << ") responding with Data: " << data->getName());
 
   // to create real wire encoding
   data->wireEncode();
@@ -1,14 +1,23 @@
 #include "producerA.hpp"
-#include "ns3/log.h"
+#include "peer-auth.hpp"
+#include "ndn-app-log.hpp"
+#include "ndn-app-profile.hpp"
+#include "ndn-name-table.hpp"
 #include "ns3/string.h"
 #include "ns3/uinteger.h"
+#include "ns3/double.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 
 #include "model/ndn-l3-protocol.hpp"
 #include "helper/ndn-fib-helper.hpp"
 
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
+
+#include <algorithm>
+#include <iomanip>
 #include <memory>
+#include <sstream>
 
 NS_LOG_COMPONENT_DEFINE("ndn.ProducerA");
 
@@ -44,23 +53,55 @@ ProducerA::GetTypeId(void)
          MakeUintegerChecker<uint32_t>())
       .AddAttribute("KeyLocator",
                     "Name to be used for key locator.  If root, then key locator is not used",
-                    NameValue(), MakeNameAccessor(&ProducerA::m_keyLocator), MakeNameChecker());
+                    NameValue(), MakeNameAccessor(&ProducerA::m_keyLocator), MakeNameChecker())
+      .AddAttribute("MetadataCacheSize", "Maximum number of peer keys with cached metadata responses",
+                    UintegerValue(1024), MakeUintegerAccessor(&ProducerA::m_metadataCacheSize),
+                    MakeUintegerChecker<uint32_t>())
+      .AddAttribute("InvalidPeerTtl", "How long an \"Invalid Peer\" response is reused for the same key",
+                    StringValue("5s"), MakeTimeAccessor(&ProducerA::m_invalidPeerTtl),
+                    MakeTimeChecker())
+      .AddAttribute("AuthSecret", "HMAC secret for peer tokens, empty keeps the legacy numeric key check",
+                    StringValue(""), MakeStringAccessor(&ProducerA::m_authSecret), MakeStringChecker())
+      .AddAttribute("AdmissionRate", "Interests per second admitted from each peer, 0 disables admission control",
+                    DoubleValue(0.0), MakeDoubleAccessor(&ProducerA::m_admissionRate),
+                    MakeDoubleChecker<double>(0.0))
+      .AddAttribute("AdmissionBurst", "Token bucket depth of every peer", UintegerValue(10),
+                    MakeUintegerAccessor(&ProducerA::m_admissionBurst),
+                    MakeUintegerChecker<uint32_t>(1))
+      .AddAttribute("AdmissionPeers", "Token buckets kept at most, the least recently seen peer makes room",
+                    UintegerValue(1024), MakeUintegerAccessor(&ProducerA::m_admissionPeers),
+                    MakeUintegerChecker<uint32_t>(1))
+      .AddAttribute("RangeStride", "Distance between the first files of two consecutive peer keys",
+                    UintegerValue(10), MakeUintegerAccessor(&ProducerA::m_rangeStride),
+                    MakeUintegerChecker<uint32_t>(1))
+      .AddAttribute("RangeSize", "Number of files in the range of every peer, more than RangeStride "
+                    "makes the ranges of neighbouring keys overlap",
+                    UintegerValue(10), MakeUintegerAccessor(&ProducerA::m_rangeSize),
+                    MakeUintegerChecker<uint32_t>(1))
+      .AddTraceSource("FileFlagged", "A file was requested three times and needs a sync",
+                      MakeTraceSourceAccessor(&ProducerA::m_fileFlagged),
+                      "ns3::ndn::ProducerA::FileFlaggedCallback");
   return tid;
 }
 
 ProducerA::ProducerA()
-	//: m_sameInterestCount(1)
-	//, m_previousInterestName("")
-	//, m_isSyncedNeeded(false)
+	: m_metadataCacheSize(1024)
+	, m_admissionRate(0.0)
+	, m_admissionBurst(10)
+	, m_admissionPeers(1024)
+	, m_evictedAccepted(0)
+	, m_evictedRejected(0)
+	, m_rangeStride(10)
+	, m_rangeSize(10)
 {
-  NS_LOG_FUNCTION_NOARGS();
+  NDN_APP_LOG_FUNCTION_NOARGS();
 }
 
 // inherited from Application base class.
 void
 ProducerA::StartApplication()
 {
-  NS_LOG_FUNCTION_NOARGS();
+  NDN_APP_LOG_FUNCTION_NOARGS();
   App::StartApplication();
 
   FibHelper::AddRoute(GetNode(), m_prefix, m_face, 0);
@@ -69,157 +110,372 @@ ProducerA::StartApplication()
 void
 ProducerA::StopApplication()
 {
-  NS_LOG_FUNCTION_NOARGS();
+  NDN_APP_LOG_FUNCTION_NOARGS();
+
+  if (NDN_APP_LOG_IS_ENABLED(INFO) && m_admissionRate > 0) {
+    std::ostringstream os;
+    PrintAdmissionStats(os);
+    NDN_APP_LOG_INFO("Admission stats of node(" << GetNode()->GetId() << "):\n" << os.str());
+  }
 
   App::StopApplication();
 }
 
+bool
+ProducerA::Admit(const Name& interestName)
+{
+  if (m_admissionRate <= 0 || interestName.size() < 3 || names::PrefixFileSync().isPrefixOf(interestName))
+    return true;
+
+  // /prefix/metadata/<peer>/... and /prefix/file/<peer>/<file>
+  const name::Component& peer = interestName.get(2);
+  std::string key(reinterpret_cast<const char*>(peer.value()), peer.value_size());
+
+  Time now = Simulator::Now();
+  EvictBuckets(now, 0);
+
+  auto found = m_buckets.find(key);
+  if (found == m_buckets.end()) {
+    EvictBuckets(now, 1);
+    m_bucketLru.push_front(key);
+    found = m_buckets.emplace(key, PeerBucket{static_cast<double>(m_admissionBurst), now, 0, 0,
+                                              m_bucketLru.begin()}).first;
+  }
+  else
+    m_bucketLru.splice(m_bucketLru.begin(), m_bucketLru, found->second.lru);
+  PeerBucket& bucket = found->second;
+
+  bucket.tokens = std::min<double>(m_admissionBurst,
+                                   bucket.tokens + (now - bucket.lastRefill).GetSeconds() * m_admissionRate);
+  bucket.lastRefill = now;
+
+  if (bucket.tokens < 1.0) {
+    bucket.rejected++;
+    return false;
+  }
+
+  bucket.tokens -= 1.0;
+  bucket.accepted++;
+  return true;
+}
+
 void
-ProducerA::OnInterest(shared_ptr<const Interest> interest)
+ProducerA::EvictBuckets(Time now, size_t room)
 {
-  App::OnInterest(interest); // tracing inside
+  while (!m_bucketLru.empty()) {
+    auto oldest = m_buckets.find(m_bucketLru.back());
+    const PeerBucket& bucket = oldest->second;
+
+    // a full bucket is the same as a new one, only its counters are lost
+    bool idle = bucket.tokens + (now - bucket.lastRefill).GetSeconds() * m_admissionRate >= m_admissionBurst;
+    if (!idle && m_buckets.size() + room <= m_admissionPeers)
+      break;
+
+    m_evictedAccepted += bucket.accepted;
+    m_evictedRejected += bucket.rejected;
+    m_buckets.erase(oldest);
+    m_bucketLru.pop_back();
+  }
+}
 
-  NS_LOG_FUNCTION(this << interest);
+void
+ProducerA::PrintAdmissionStats(std::ostream& os) const
+{
+  os << "Peer\tAccepted\tRejected\n";
+  for (const auto& bucket : m_buckets) {
+    os << bucket.first << "\t" << bucket.second.accepted << "\t" << bucket.second.rejected << "\n";
+  }
+  if (m_evictedAccepted + m_evictedRejected > 0)
+    os << "(evicted)\t" << m_evictedAccepted << "\t" << m_evictedRejected << "\n";
+}
 
-  if (!m_active)
-    return;
+bool
+ProducerA::IsValidPeer(const name::Component& peer, const std::string& parameters, uint32_t peerKey)
+{
+  if (m_authSecret.empty())
+    return (peerKey > 10000) && (peerKey < 20000);
 
+  std::string peerName(reinterpret_cast<const char*>(peer.value()), peer.value_size());
+  std::string cacheKey = peerName + "|" + parameters;
 
-  Name dataName(interest->getName());
-  //auto intendedProducer  = dataName.getSubName(2,1);
+  auto entry = m_verifiedPeers.find(cacheKey);
+  if (entry != m_verifiedPeers.end()) {
+    m_verifiedPeerLru.splice(m_verifiedPeerLru.begin(), m_verifiedPeerLru, entry->second.lru);
+    return entry->second.isValid;
+  }
+
+  bool isValid = false;
+  size_t tokenPos = parameters.find("&token=");
+  // the key still selects the file range, so it has to be in the range the metadata supports
+  if (tokenPos != std::string::npos && (peerKey > 10000) && (peerKey < 20000)) {
+    isValid = PeerAuth::VerifyToken(m_authSecret, peerName, peerKey, parameters.substr(tokenPos + 7));
+  }
+  NDN_APP_LOG_INFO("Verified token of " << peerName << ": " << (isValid ? "valid" : "invalid"));
+
+  // least recently used peer out
+  if (m_verifiedPeers.size() >= m_metadataCacheSize && !m_verifiedPeerLru.empty()) {
+    m_verifiedPeers.erase(m_verifiedPeerLru.back());
+    m_verifiedPeerLru.pop_back();
+  }
+  m_verifiedPeerLru.push_front(cacheKey);
+  m_verifiedPeers[cacheKey] = VerifiedPeer{isValid, m_verifiedPeerLru.begin()};
+  return isValid;
+}
 
+shared_ptr<const Data>
+ProducerA::GetMetadata(const Name& name, uint32_t peerKey, bool isValid)
+{
+  if (isValid) {
+    auto entry = m_metadataCache.find(peerKey);
+    if (entry != m_metadataCache.end()) {
+      m_metadataLru.splice(m_metadataLru.begin(), m_metadataLru, entry->second.lru);
+      return MakeNamedData(name, *entry->second.tail);
+    }
+
+    // least recently used key out
+    if (m_metadataCache.size() >= m_metadataCacheSize && !m_metadataLru.empty()) {
+      m_metadataCache.erase(m_metadataLru.back());
+      m_metadataLru.pop_back();
+    }
+    m_metadataLru.push_front(peerKey);
+    MetadataEntry& added = m_metadataCache[peerKey];
+    added.tail = MakeMetadata(peerKey, true);
+    added.lru = m_metadataLru.begin();
+    return MakeNamedData(name, *added.tail);
+  }
+
+  auto invalid = m_invalidPeerCache.find(peerKey);
+  if (invalid != m_invalidPeerCache.end()) {
+    if (invalid->second.expiry > Simulator::Now())
+      return MakeNamedData(name, *invalid->second.tail);
+    m_invalidPeerAges.erase(invalid->second.age);
+    m_invalidPeerCache.erase(invalid);
+  }
+
+  // all entries live m_invalidPeerTtl, so the oldest one expires first: drop the expired ones,
+  // then, when full, the one closest to expiry
+  while (!m_invalidPeerAges.empty()
+         && (m_invalidPeerCache.find(m_invalidPeerAges.back())->second.expiry <= Simulator::Now()
+             || m_invalidPeerCache.size() >= m_metadataCacheSize)) {
+    m_invalidPeerCache.erase(m_invalidPeerAges.back());
+    m_invalidPeerAges.pop_back();
+  }
+
+  ::ndn::ConstBufferPtr tail = MakeMetadata(peerKey, false);
+  m_invalidPeerAges.push_front(peerKey);
+  m_invalidPeerCache[peerKey] = {tail, Simulator::Now() + m_invalidPeerTtl, m_invalidPeerAges.begin()};
+  return MakeNamedData(name, *tail);
+}
+
+::ndn::ConstBufferPtr
+ProducerA::MakeMetadata(uint32_t peerKey, bool isValid) const
+{
   auto data = make_shared<Data>();
-  data->setName(dataName);
+  data->setName(m_prefix);
   data->setFreshnessPeriod(::ndn::time::milliseconds(m_freshness.GetMilliSeconds()));
 
-  if(dataName.getSubName(0,2).equals("/prefix/metadata"))
+  if(isValid)
   {
-	   Block parametersBlock = interest->getParameters();
-	   std::string temp = std::string((char*)parametersBlock.value());
-	   NS_LOG_INFO("temp = "<< temp );
-	   //std::string peerKey = temp.substr(4,5);
-	   uint32_t peerKey = std::strtoul(temp.substr(4,5).c_str(),nullptr,10);
-	   NS_LOG_INFO("peerKey = "<< peerKey);
-	   if((peerKey > 10000) && (peerKey < 20000))
-	   {
-		   NS_LOG_INFO("Valid peer.");
-		   uint32_t start = ((peerKey%1000)-1)*10;
-		   uint32_t end = start + 9;
-
-		   std::stringstream temp_content;
-		   if(end < 10)
-		   {
-			   temp_content << "start=00"<< start << "end=00"<< end;
-		   }
-		   else if(end > 9 && end < 100)
-		   {
-			   temp_content << "start=0"<< start << "end=0"<< end;
-		   }
-		   else
-			   temp_content << "start="<< start << "end="<< end;
-
-		   std::string content = temp_content.str();
-		   const char* buff = content.c_str();
-		   size_t buff_size = content.length();
-		   data->setContent(make_shared< ::ndn::Buffer>(buff,buff_size));
-
-
-	   }
-
-	   else
-	   {
-		   NS_LOG_INFO("invalid peer.");
-		   std::string content = "Invalid Peer!!!";
-		   const char* buff = content.c_str();
-		   size_t buff_size = content.length();
-		   data->setContent(make_shared< ::ndn::Buffer>(buff,buff_size));
-
-	   }
-	   Signature signature;
-	   SignatureInfo signatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255));
-
-	   if (m_keyLocator.size() > 0) {
-	     signatureInfo.setKeyLocator(m_keyLocator);
-	   }
-
-	   signature.setInfo(signatureInfo);
-	   signature.setValue(::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue, m_signature));
-
-	   data->setSignature(signature);
-
-	   NS_LOG_INFO("node(" << GetNode()->GetId() << ") responding with Data: " << data->getName());
-
-	   // to create real wire encoding
-	   data->wireEncode();
+	  NDN_APP_LOG_INFO("Valid peer.");
+	  uint32_t start = ((peerKey%1000)-1)*m_rangeStride;
+	  uint32_t end = start + m_rangeSize - 1;
 
-	   m_transmittedDatas(data, this, m_face);
-	   m_appLink->onReceiveData(*data);
+	  // both bounds have at least three digits, the PeerConsumer reads them up to the next marker
+	  std::stringstream temp_content;
+	  temp_content << std::setfill('0') << "start=" << std::setw(3) << start << "end=" << std::setw(3) << end;
 
+	  std::string content = temp_content.str();
+	  data->setContent(make_shared< ::ndn::Buffer>(content.c_str(),content.length()));
+  }
+  else
+  {
+	  NDN_APP_LOG_INFO("invalid peer.");
+	  std::string content = "Invalid Peer!!!";
+	  data->setContent(make_shared< ::ndn::Buffer>(content.c_str(),content.length()));
   }
 
-  else if(dataName.getSubName(0,3).equals("/prefix/file/sync"))
-   {
- 	  std::string content = "AllSynced";
+  Signature signature;
+  SignatureInfo signatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255));
 
- 	  for(int i=0;i<256;i++)
- 	  {
- 		  if(m_isSyncedNeeded[i])
- 		  {
- 			  m_isSyncedNeeded[i] = false;
- 			  content = m_previousInterestName[i].getSubName(2,2).toUri();
- 			  content.insert(0,"/prefix/peer");
- 			  break;
- 		  }
- 	  }
+  if (m_keyLocator.size() > 0) {
+    signatureInfo.setKeyLocator(m_keyLocator);
+  }
 
- 	  const char* buff = content.c_str();
-   	  size_t buff_size = content.length();
-   	  data->setContent(make_shared< ::ndn::Buffer>(buff,buff_size));
+  signature.setInfo(signatureInfo);
+  signature.setValue(::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue, m_signature));
 
+  data->setSignature(signature);
 
+  // the Name comes first, everything behind it is the same for every response
+  const Block& wire = data->wireEncode();
+  wire.parse();
+  return make_shared< ::ndn::Buffer>(wire.get(::ndn::tlv::Name).end(), wire.end());
+}
 
-   	  Signature signature;
-   	  SignatureInfo signatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255));
+shared_ptr<const Data>
+ProducerA::MakeNamedData(const Name& name, const ::ndn::Buffer& tail)
+{
+  // encoded back to front: the fields, the Name, then the Data type and length
+  ::ndn::EncodingBuffer encoder;
+  size_t length = encoder.prependByteArray(tail.data(), tail.size());
+  length += name.wireEncode(encoder);
+  encoder.prependVarNumber(length);
+  encoder.prependVarNumber(::ndn::tlv::Data);
+
+  // decoded from the wire, so the Data keeps it and wireEncode() does not encode again
+  return make_shared<const Data>(encoder.block());
+}
 
-   	  if (m_keyLocator.size() > 0) {
-   	    signatureInfo.setKeyLocator(m_keyLocator);
-   	  }
+std::string
+ProducerA::TakeSyncContent()
+{
+  if(m_syncNeeded.empty())
+	  return "AllSynced";
+
+  // the URI of a Name, ConsumerA parses it back
+  Name content(names::PrefixPeer());
+  content.append(m_syncNeeded.begin()->second.getSubName(2,2));
+  m_syncNeeded.erase(m_syncNeeded.begin());
+  return content.toUri();
+}
 
-   	  signature.setInfo(signatureInfo);
-   	  signature.setValue(::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue, m_signature));
+void
+ProducerA::SendSyncData(const Name& dataName, const std::string& content)
+{
+  auto data = make_shared<Data>();
+  data->setName(dataName);
+  data->setFreshnessPeriod(::ndn::time::milliseconds(m_freshness.GetMilliSeconds()));
 
-   	  data->setSignature(signature);
+  const char* buff = content.c_str();
+  size_t buff_size = content.length();
+  data->setContent(make_shared< ::ndn::Buffer>(buff,buff_size));
 
-   	  NS_LOG_INFO("node(" << GetNode()->GetId() << ") responding with Data: " << data->getName());
+  Signature signature;
+  SignatureInfo signatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255));
 
-   	  // to create real wire encoding
-   	  data->wireEncode();
+  if (m_keyLocator.size() > 0) {
+    signatureInfo.setKeyLocator(m_keyLocator);
+  }
+
+  signature.setInfo(signatureInfo);
+  signature.setValue(::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue, m_signature));
+
+  data->setSignature(signature);
+
+  NDN_APP_LOG_INFO("node(" << GetNode()->GetId() << ") responding with Data: " << data->getName());
+
+  // to create real wire encoding
+  data->wireEncode();
+
+  m_transmittedDatas(data, this, m_face);
+  m_appLink->onReceiveData(*data);
+}
+
+void
+ProducerA::NotifyPendingSync()
+{
+  while (!m_pendingSyncs.empty() && m_pendingSyncs.front().expiry <= Simulator::Now())
+    m_pendingSyncs.pop_front();
+
+  if (m_pendingSyncs.empty())
+    return;
+
+  Name dataName = m_pendingSyncs.front().name;
+  m_pendingSyncs.pop_front();
+  SendSyncData(dataName, TakeSyncContent());
+}
+
+void
+ProducerA::OnInterest(shared_ptr<const Interest> interest)
+{
+  App::OnInterest(interest); // tracing inside
+
+  NDN_APP_LOG_FUNCTION(this << interest);
+
+  if (!m_active)
+    return;
+
+  NDN_APP_PROFILE("OnInterest");
+
+  if (!Admit(interest->getName())) {
+    NDN_APP_LOG_INFO("Peer over admission budget, NACKing " << interest->getName());
+
+    // a NACK carries no content or signature, so it is the cheapest possible answer
+    lp::Nack nack(*interest);
+    nack.setReason(lp::NackReason::CONGESTION);
+    m_appLink->onReceiveNack(nack);
+    return;
+  }
+
+  const Name& dataName = interest->getName();
+  //auto intendedProducer  = dataName.getSubName(2,1);
+
+  if(names::PrefixMetadata().isPrefixOf(dataName))
+  {
+	   Block parametersBlock = interest->getParameters();
+	   std::string parameters(reinterpret_cast<const char*>(parametersBlock.value()), parametersBlock.value_size());
+	   uint32_t peerKey = parameters.size() > 4 ? std::strtoul(parameters.substr(4,5).c_str(),nullptr,10) : 0;
+	   NDN_APP_LOG_INFO("peerKey = "<< peerKey);
+
+	   // /prefix/metadata/<peer>/<first file>: a name without the peer cannot be valid
+	   bool isValid = dataName.size() > 2 && IsValidPeer(dataName.get(2), parameters, peerKey);
+
+	   // already encoded, only the name differs between requests
+	   shared_ptr<const Data> data = GetMetadata(dataName, peerKey, isValid);
+
+	   NDN_APP_LOG_INFO("node(" << GetNode()->GetId() << ") responding with Data: " << data->getName());
+
+	   m_transmittedDatas(data, this, m_face);
+	   m_appLink->onReceiveData(*data);
+
+  }
+
+  else if(names::PrefixFileSync().isPrefixOf(dataName))
+   {
+ 	  std::string content = TakeSyncContent();
+
+ 	  // /prefix/file/sync/notify/<seq>: nothing to report yet, keep the Interest until a file is flagged
+ 	  if(content == "AllSynced" && dataName.size() > 4 && dataName.get(3) == names::Notify())
+ 	  {
+ 		  while (!m_pendingSyncs.empty() && m_pendingSyncs.front().expiry <= Simulator::Now())
+ 			  m_pendingSyncs.pop_front();
+
+ 		  Time lifetime = MilliSeconds(interest->getInterestLifetime().count());
+ 		  m_pendingSyncs.push_back(PendingSync{dataName, Simulator::Now() + lifetime});
+ 		  NDN_APP_LOG_INFO("Holding " << dataName << " for " << lifetime.GetSeconds() << "s");
+ 		  return;
+ 	  }
 
-   	  m_transmittedDatas(data, this, m_face);
-   	  m_appLink->onReceiveData(*data);
+ 	  SendSyncData(dataName, content);
    }
 
-  else if(dataName.getSubName(0,2).equals("/prefix/file"))
+  else if(names::PrefixFile().isPrefixOf(dataName))
   {
-	  uint32_t file_number = std::strtoul(dataName.getSubName(3,2).toUri().substr(1,3).c_str(), nullptr,10);
-	  NS_LOG_INFO("File Number is = "<< file_number);
+	  // /prefix/file/<peer>/<file>
+	  uint32_t file_number = 0;
+	  if(dataName.size() < 4 || !names::ParseFileId(dataName.at(3), file_number))
+		  return;
 
-	  //Name firstRequestCheck ==;
-	  if(!m_isSyncedNeeded[file_number])
+	  auto data = make_shared<Data>();
+	  data->setName(dataName);
+	  data->setFreshnessPeriod(::ndn::time::milliseconds(m_freshness.GetMilliSeconds()));
+	  NDN_APP_LOG_INFO("File Number is = "<< file_number);
+
+	  if(m_syncNeeded.count(file_number) == 0)
 	  {
-		  	  if(m_previousInterestName[file_number].equals("/"))
+		  	  FileRequests& requests = m_fileRequests[file_number];
+		  	  if(requests.count == 0)
 		  	  {
-		  		  m_previousInterestName[file_number] = dataName;
-		  		  m_sameInterestCount[file_number]++;
+		  		  requests.firstInterest = dataName;
+		  		  requests.count++;
 		  	  }
-		  	  else if(m_previousInterestName[file_number].equals(dataName))
-		  	  	  m_sameInterestCount[file_number]++;
-		  	  if(m_sameInterestCount[file_number] == 3)
+		  	  else if(requests.firstInterest.equals(dataName))
+		  	  	  requests.count++;
+		  	  if(requests.count == 3)
 		  	  {
-		  	  	  m_isSyncedNeeded[file_number] = true;
-		  	  	  //m_sameInterestCount[file_number] = 1;
-		  	  	  //m_previousInterestName = "";  						// need to understand
-		  	  	  //return;
+		  	  	  m_syncNeeded[file_number] = requests.firstInterest;
+		  	  	  m_fileFlagged(this, file_number);
+		  	  	  NotifyPendingSync();
 		  	  }
 
 		  	  std::stringstream temp_content;
@@ -234,7 +490,7 @@ ProducerA::OnInterest(shared_ptr<const Interest> interest)
 		  	  size_t buff_size = content.length();
 		  	  data->setContent(make_shared< ::ndn::Buffer>(buff,buff_size));
 
-		  	  NS_LOG_INFO("m_previousInterestName  = "<< m_previousInterestName[10] << ";  m_sameInterestCount = " << m_sameInterestCount[10]<<";  m_isSyncedNeeded = "<< m_isSyncedNeeded[10]);
+		  	  NDN_APP_LOG_INFO("First Interest = "<< requests.firstInterest << ";  same Interests = " << requests.count);
 
 	  }
 
@@ -251,7 +507,7 @@ ProducerA::OnInterest(shared_ptr<const Interest> interest)
 
 	  data->setSignature(signature);
 
-	  NS_LOG_INFO("node(" << GetNode()->GetId() << ") responding with Data: " << data->getName());
+	  NDN_APP_LOG_INFO("node(" << GetNode()->GetId() << ") responding with Data: " << data->getName());
 
 	  // to create real wire encoding
 	  data->wireEncode();
@@ -312,6 +568,48 @@ ProducerA::OnInterest(shared_ptr<const Interest> interest)
 
 
 
+}
+
+void
+ProducerA::SaveState(SnapshotWriter& writer) const
+{
+  // not saved: held notifications (their Interests died with the PIT), the admission buckets
+  // (they refill within a second) and the metadata caches (rebuilt on the next request)
+  writer.Put(static_cast<uint32_t>(m_fileRequests.size()));
+  for (const auto& requests : m_fileRequests) {
+    writer.Put(requests.first);
+    writer.Put(requests.second.firstInterest);
+    writer.Put(requests.second.count);
+  }
+
+  writer.Put(static_cast<uint32_t>(m_syncNeeded.size()));
+  for (const auto& flagged : m_syncNeeded) {
+    writer.Put(flagged.first);
+    writer.Put(flagged.second);
+  }
+}
+
+void
+ProducerA::LoadState(SnapshotReader& reader)
+{
+  uint32_t count = 0;
+  reader.Get(count);
+  m_fileRequests.clear();
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t fileNumber = 0;
+    reader.Get(fileNumber);
+    FileRequests& requests = m_fileRequests[fileNumber];
+    reader.Get(requests.firstInterest);
+    reader.Get(requests.count);
+  }
+
+  reader.Get(count);
+  m_syncNeeded.clear();
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t fileNumber = 0;
+    reader.Get(fileNumber);
+    reader.Get(m_syncNeeded[fileNumber]);
+  }
 }
 
 } // namespace ndn
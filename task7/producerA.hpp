@@ -4,11 +4,19 @@
 #include "ns3/ndnSIM/model/ndn-common.hpp"
 
 #include "ndn-app.hpp"
+#include "ndn-app-snapshot.hpp"
 #include "ns3/ndnSIM/model/ndn-common.hpp"
 
 #include "ns3/nstime.h"
 #include "ns3/ptr.h"
 
+#include <deque>
+#include <list>
+#include <map>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
 namespace ns3 {
 namespace ndn {
 
@@ -21,7 +29,7 @@ namespace ndn {
  * size and name same as in Interest.cation, which replying every incoming Interest
  * with Data packet with a specified size and name same as in Interest.
  */
-class ProducerA : public App {
+class ProducerA : public App, public SnapshotState {
 public:
   static TypeId
   GetTypeId(void);
@@ -32,6 +40,22 @@ public:
   virtual void
   OnInterest(shared_ptr<const Interest> interest);
 
+  // From SnapshotState
+  virtual void
+  SaveState(SnapshotWriter& writer) const;
+
+  virtual void
+  LoadState(SnapshotReader& reader);
+
+  /**
+   * \brief Prints accepted/rejected Interest counters for every peer seen by admission control
+   */
+  void
+  PrintAdmissionStats(std::ostream& os) const;
+
+public:
+  typedef void (*FileFlaggedCallback)(Ptr<App> app, uint32_t file);
+
 protected:
   // inherited from Application base class.
   virtual void
@@ -40,20 +64,149 @@ protected:
   virtual void
   StopApplication();
 
+private:
+  /**
+   * \brief Checks the PeerAuth token in the metadata parameters
+   *
+   * Results are cached per peer name and parameters, so only the first request of a peer pays
+   * for the HMAC. Without AuthSecret the old numeric key range is used.
+   */
+  bool
+  IsValidPeer(const name::Component& peer, const std::string& parameters, uint32_t peerKey);
+
+  /**
+   * \brief Returns the signed metadata Data for the peer key, named @p name
+   *
+   * Valid peers are served from m_metadataCache, invalid ones from m_invalidPeerCache until
+   * their entry expires. The caches hold the encoded fields that follow the Name (MetaInfo,
+   * Content and signature), so a response only encodes @p name in front of them.
+   */
+  shared_ptr<const Data>
+  GetMetadata(const Name& name, uint32_t peerKey, bool isValid);
+
+  /**
+   * \brief Builds and signs the metadata, and returns its encoding after the Name
+   */
+  ::ndn::ConstBufferPtr
+  MakeMetadata(uint32_t peerKey, bool isValid) const;
+
+  /**
+   * \brief Encodes a Data of @p name with the encoded fields @p tail, which follow the Name
+   */
+  static shared_ptr<const Data>
+  MakeNamedData(const Name& name, const ::ndn::Buffer& tail);
+
+  /**
+   * \brief Token-bucket admission check for the peer that sent the Interest
+   *
+   * The bucket is the one of the peer component: /prefix/metadata/<peer>/... and
+   * /prefix/file/<peer>/<file>. Sync Interests (/prefix/file/sync/...) name no peer; they come
+   * from the ConsumerA next to ProducerA and are always admitted.
+   *
+   * \return false if the peer ran out of tokens and the Interest should be NACKed
+   */
+  bool
+  Admit(const Name& interestName);
+
+  /**
+   * \brief Drops the buckets of peers idle long enough to be full again, least recently seen
+   * first, and with @p room > 0 also active ones until @p room more buckets fit
+   *
+   * The counters of dropped buckets are summed up for PrintAdmissionStats().
+   */
+  void
+  EvictBuckets(Time now, size_t room);
+
+  /**
+   * \brief Returns the sync reply content: /prefix/peer/<peer>/<file> of the first flagged file,
+   * whose flag is cleared, or "AllSynced"
+   */
+  std::string
+  TakeSyncContent();
+
+  void
+  SendSyncData(const Name& dataName, const std::string& content);
+
+  /**
+   * \brief Answers the oldest held notification Interest that has not expired yet, if any
+   */
+  void
+  NotifyPendingSync();
+
 private:
   Name m_prefix;
   Name m_postfix;
   uint32_t m_virtualPayloadSize;
   Time m_freshness;
-  //int m_sameInterestCount;
-  Name m_previousInterestName[255];
-  uint32_t m_sameInterestCount[255];
-  bool m_isSyncedNeeded[255];
+
+  /**
+   * \brief The /prefix/file Interests of one file, the same name three times flags it
+   */
+  struct FileRequests {
+    Name firstInterest; ///< only repeats of the first name count
+    uint32_t count = 0;
+  };
+
+  std::unordered_map<uint32_t, FileRequests> m_fileRequests; ///< \brief by file number
+  std::map<uint32_t, Name> m_syncNeeded; ///< \brief flagged, not yet reported files -> first Interest
 
   uint32_t m_signature;
   Name m_keyLocator;
 
-  //std::string m_previousInterestName[255];
+  struct InvalidPeerEntry {
+    ::ndn::ConstBufferPtr tail;
+    Time expiry;
+    std::list<uint32_t>::iterator age; ///< position of the key in m_invalidPeerAges
+  };
+
+  struct MetadataEntry {
+    ::ndn::ConstBufferPtr tail; ///< encoded fields after the Name
+    std::list<uint32_t>::iterator lru; ///< position of the key in m_metadataLru
+  };
+
+  std::unordered_map<uint32_t, MetadataEntry> m_metadataCache;       ///< \brief peer key -> signed metadata
+  std::list<uint32_t> m_metadataLru;                                 ///< \brief cached keys, most recently used first
+  std::unordered_map<uint32_t, InvalidPeerEntry> m_invalidPeerCache; ///< \brief negative cache
+  std::list<uint32_t> m_invalidPeerAges;                             ///< \brief cached invalid keys, newest first, so oldest expiry last
+  uint32_t m_metadataCacheSize;
+  Time m_invalidPeerTtl;
+
+  std::string m_authSecret;
+  struct VerifiedPeer {
+    bool isValid;
+    std::list<std::string>::iterator lru; ///< position of the key in m_verifiedPeerLru
+  };
+
+  std::unordered_map<std::string, VerifiedPeer> m_verifiedPeers; ///< \brief "<peer>|<parameters>" -> verdict
+  std::list<std::string> m_verifiedPeerLru;                      ///< \brief verified keys, most recently used first
+
+  struct PeerBucket {
+    double tokens;
+    Time lastRefill;
+    uint64_t accepted;
+    uint64_t rejected;
+    std::list<std::string>::iterator lru; ///< position of the peer in m_bucketLru
+  };
+
+  std::unordered_map<std::string, PeerBucket> m_buckets; ///< \brief peer name -> token bucket
+  std::list<std::string> m_bucketLru;                    ///< \brief peers, most recently seen first
+  double m_admissionRate;                                ///< \brief tokens per second, 0 disables
+  uint32_t m_admissionBurst;
+  uint32_t m_admissionPeers;                             ///< \brief buckets kept at most
+  uint64_t m_evictedAccepted;                            ///< \brief counters of dropped buckets
+  uint64_t m_evictedRejected;
+
+  uint32_t m_rangeStride; ///< \brief first file of key k is (k%1000-1)*m_rangeStride
+  uint32_t m_rangeSize;   ///< \brief files per peer range
+
+  struct PendingSync {
+    Name name;
+    Time expiry;
+  };
+
+  std::deque<PendingSync> m_pendingSyncs; ///< \brief notification Interests held until a file is flagged
+
+  TracedCallback<Ptr<App> /* app */, uint32_t /* file */> m_fileFlagged;
 
 };
 
@@ -18,7 +18,8 @@
  **/
 
 #include "proxy-producer.hpp"
-#include "ns3/log.h"
+#include "ndn-app-log.hpp"
+#include "ndn-app-profile.hpp"
 #include "ns3/string.h"
 #include "ns3/uinteger.h"
 #include "ns3/packet.h"
@@ -69,14 +70,14 @@ ProxyProducer::GetTypeId(void)
 
 ProxyProducer::ProxyProducer()
 {
-  NS_LOG_FUNCTION_NOARGS();
+  NDN_APP_LOG_FUNCTION_NOARGS();
 }
 
 // inherited from Application base class.
 void
 ProxyProducer::StartApplication()
 {
-  NS_LOG_FUNCTION_NOARGS();
+  NDN_APP_LOG_FUNCTION_NOARGS();
   App::StartApplication();
 
   FibHelper::AddRoute(GetNode(), m_prefix, m_face, 0);
@@ -85,7 +86,7 @@ ProxyProducer::StartApplication()
 void
 ProxyProducer::StopApplication()
 {
-  NS_LOG_FUNCTION_NOARGS();
+  NDN_APP_LOG_FUNCTION_NOARGS();
 
   App::StopApplication();
 }
@@ -95,14 +96,75 @@ ProxyProducer::OnInterest(shared_ptr<const Interest> interest)
 {
   App::OnInterest(interest); // tracing inside
 
-  NS_LOG_FUNCTION(this << interest);
+  NDN_APP_LOG_FUNCTION(this << interest);
 
   if (!m_active)
     return;
 
-  Block parametersBlock = interest->getParameters();
-  std::string Parameters = std::string((char*)parametersBlock.value()).substr(0,33);
-  NS_LOG_INFO("Pushed Data into Proxy "<< interest->getName()<<"  = "<< Parameters);
+  NDN_APP_PROFILE("OnInterest");
+
+  Name dataName(interest->getName());
+
+  if (interest->hasParameters()) {
+    Block parametersBlock = interest->getParameters();
+    std::string parameters(reinterpret_cast<const char*>(parametersBlock.value()),
+                           parametersBlock.value_size());
+    NDN_APP_LOG_INFO("Pushed Data into Proxy " << dataName << "  = " << parameters.substr(0, 33));
+    m_pushed[dataName] = parameters;
+    return;
+  }
+
+  auto pushed = m_pushed.find(dataName);
+  if (pushed == m_pushed.end())
+    return;
+
+  auto data = make_shared<Data>();
+  data->setName(dataName);
+  data->setFreshnessPeriod(::ndn::time::milliseconds(m_freshness.GetMilliSeconds()));
+  data->setContent(make_shared< ::ndn::Buffer>(pushed->second.c_str(), pushed->second.length()));
+
+  Signature signature;
+  SignatureInfo signatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255));
+
+  if (m_keyLocator.size() > 0) {
+    signatureInfo.setKeyLocator(m_keyLocator);
+  }
+
+  signature.setInfo(signatureInfo);
+  signature.setValue(::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue, m_signature));
+
+  data->setSignature(signature);
+
+  NDN_APP_LOG_INFO("node(" << GetNode()->GetId() << ") responding with Data: " << data->getName());
+
+  // to create real wire encoding
+  data->wireEncode();
+
+  m_transmittedDatas(data, this, m_face);
+  m_appLink->onReceiveData(*data);
+}
+
+void
+ProxyProducer::SaveState(SnapshotWriter& writer) const
+{
+  writer.Put(static_cast<uint32_t>(m_pushed.size()));
+  for (const auto& pushed : m_pushed) {
+    writer.Put(pushed.first);
+    writer.Put(pushed.second);
+  }
+}
+
+void
+ProxyProducer::LoadState(SnapshotReader& reader)
+{
+  uint32_t count = 0;
+  reader.Get(count);
+  m_pushed.clear();
+  for (uint32_t i = 0; i < count; i++) {
+    Name name;
+    reader.Get(name);
+    reader.Get(m_pushed[name]);
+  }
 }
 
 } // namespace ndn
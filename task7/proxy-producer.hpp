@@ -23,11 +23,14 @@
 #include "ns3/ndnSIM/model/ndn-common.hpp"
 
 #include "ndn-app.hpp"
+#include "ndn-app-snapshot.hpp"
 #include "ns3/ndnSIM/model/ndn-common.hpp"
 
 #include "ns3/nstime.h"
 #include "ns3/ptr.h"
 
+#include <map>
+
 namespace ns3 {
 namespace ndn {
 
@@ -39,8 +42,12 @@ namespace ndn {
  * which replying every incoming Interest with Data packet with a specified
  * size and name same as in Interest.cation, which replying every incoming Interest
  * with Data packet with a specified size and name same as in Interest.
+ *
+ * Pushes (Interests with parameters) are kept by name, and a later Interest for the same name
+ * without parameters gets the pushed bytes back, which is how the ProxyReader collects whole
+ * files and coded blocks.
  */
-class ProxyProducer : public App {
+class ProxyProducer : public App, public SnapshotState {
 public:
   static TypeId
   GetTypeId(void);
@@ -51,6 +58,13 @@ public:
   virtual void
   OnInterest(shared_ptr<const Interest> interest);
 
+  // From SnapshotState
+  virtual void
+  SaveState(SnapshotWriter& writer) const;
+
+  virtual void
+  LoadState(SnapshotReader& reader);
+
 protected:
   // inherited from Application base class.
   virtual void
@@ -67,6 +81,8 @@ private:
 
   uint32_t m_signature;
   Name m_keyLocator;
+
+  std::map<Name, std::string> m_pushed; ///< \brief parameters of every push, by name
 };
 
 } // namespace ndn
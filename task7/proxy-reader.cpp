@@ -0,0 +1,263 @@
+#include "proxy-reader.hpp"
+#include "peer-consumer.hpp"
+#include "erasure-code.hpp"
+#include "ns3/ptr.h"
+#include "ndn-app-log.hpp"
+#include "ndn-app-profile.hpp"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/callback.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/integer.h"
+#include "ns3/double.h"
+
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE("ndn.ProxyReader");
+
+// after the log component: the engine logs through this unit's g_log
+#include "consumer-engine-impl.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+template class ConsumerEngine<ProxyReader>;
+
+NS_OBJECT_ENSURE_REGISTERED(ProxyReader);
+
+TypeId
+ProxyReader::GetTypeId(void)
+{
+  static TypeId tid =
+    AddEngineAttributes(TypeId("ns3::ndn::ProxyReader")
+                          .SetGroupName("Ndn")
+                          .SetParent<App>()
+                          .AddConstructor<ProxyReader>())
+	  .AddAttribute("FirstFile", "First file to read", UintegerValue(0),
+			            MakeUintegerAccessor(&ProxyReader::m_firstFile), MakeUintegerChecker<uint32_t>())
+	  .AddAttribute("LastFile", "Last file to read", UintegerValue(0),
+			            MakeUintegerAccessor(&ProxyReader::m_lastFile), MakeUintegerChecker<uint32_t>())
+	  .AddAttribute("CodeK", "Blocks needed to rebuild a file, 0 if the peers push files whole",
+			            UintegerValue(0), MakeUintegerAccessor(&ProxyReader::m_codeK),
+			            MakeUintegerChecker<uint32_t>(0, 256))
+	  .AddAttribute("CodeN", "Erasure coded blocks pushed per file",
+			            UintegerValue(3), MakeUintegerAccessor(&ProxyReader::m_codeN),
+			            MakeUintegerChecker<uint32_t>(1, 256))
+	  .AddTraceSource("FileRead", "A file was read (decoded) from the proxies",
+			          MakeTraceSourceAccessor(&ProxyReader::m_fileRead),
+			          "ns3::ndn::ProxyReader::FileReadCallback");
+
+  return tid;
+}
+
+ProxyReader::ProxyReader()
+  : m_firstFile(0)
+  , m_lastFile(0)
+  , m_codeK(0)
+  , m_codeN(3)
+  , m_filesRead(0)
+{
+  NDN_APP_LOG_FUNCTION_NOARGS();
+}
+
+void
+ProxyReader::StartApplication()
+{
+  // otherwise restored from a snapshot, see LoadState
+  if (m_files.empty()) {
+    if (m_lastFile >= m_firstFile && m_lastFile - m_firstFile >= (1u << 24))
+      NS_FATAL_ERROR("ProxyReader reads at most 2^24 files, not " << m_firstFile << "-" << m_lastFile);
+    if (m_lastFile >= m_firstFile)
+      m_files.assign(m_lastFile - m_firstFile + 1, FileBlocks{false, {}});
+    m_filesRead = 0;
+    m_startTime = Simulator::Now();
+  }
+
+  ConsumerEngine<ProxyReader>::StartApplication();
+}
+
+uint32_t
+ProxyReader::GetBlockCount() const
+{
+  // a whole file is at one of the three proxy prefixes
+  return m_codeK == 0 ? 3 : std::max(m_codeK, m_codeN);
+}
+
+void
+ProxyReader::SendPacket()
+{
+  if (!m_active)
+    return;
+
+  NDN_APP_PROFILE("SendPacket");
+
+  NDN_APP_LOG_FUNCTION_NOARGS();
+
+  // timed out blocks first, after the RTO of their proxy; those no longer missing are dropped
+  uint32_t seq = 0;
+  uint32_t requestClass = 0;
+  while (PopRetxSeq(seq, requestClass)) {
+    if (IsMissing(m_firstFile + seq / 256, seq % 256))
+      SendBlockInterest(m_firstFile + seq / 256, seq % 256);
+    else
+      StopTracking(seq, requestClass);
+  }
+
+  // then every missing block that has no Interest out yet
+  for (uint32_t i = 0; i < m_files.size(); i++) {
+    if (m_files[i].read)
+      continue;
+
+    for (uint32_t block = 0; block < GetBlockCount(); block++) {
+      if (m_files[i].blocks.count(block) == 0 && !IsTracked(GetBlockSeq(m_firstFile + i, block), block % 3))
+        SendBlockInterest(m_firstFile + i, block);
+    }
+  }
+
+  // sending schedules the next round, but with every block in flight nothing was sent
+  ScheduleNextPacket();
+}
+
+bool
+ProxyReader::IsMissing(uint32_t fileNumber, uint32_t block) const
+{
+  if (fileNumber < m_firstFile || fileNumber - m_firstFile >= m_files.size())
+    return false;
+
+  const FileBlocks& file = m_files[fileNumber - m_firstFile];
+  return !file.read && file.blocks.count(block) == 0;
+}
+
+void
+ProxyReader::SendBlockInterest(uint32_t fileNumber, uint32_t block)
+{
+  // /<proxy>/<file> for whole files, /<proxy>/<file>/<block> for coded ones
+  Name nameBlock(PeerConsumer::GetProxyPrefix(block));
+  nameBlock.append(names::FileId(fileNumber));
+  if (m_codeK > 0)
+    nameBlock.appendSequenceNumber(block);
+
+  shared_ptr<Interest> interest = make_shared<Interest>();
+  interest->setName(nameBlock);
+
+  // one request class, and so one RTT estimator, per proxy
+  SendInterest(interest, GetBlockSeq(fileNumber, block), block % 3);
+}
+
+///////////////////////////////////////////////////
+//          Process incoming packets             //
+///////////////////////////////////////////////////
+
+void
+ProxyReader::OnData(shared_ptr<const Data> data)
+{
+  if (!m_active)
+    return;
+
+  NDN_APP_PROFILE("OnData");
+
+  App::OnData(data); // tracing inside
+
+  NDN_APP_LOG_FUNCTION(this << data);
+
+  const Name& dataName = data->getName();
+  NDN_APP_LOG_INFO("< DATA for " << dataName);
+
+  uint32_t fileNumber = 0;
+  if (dataName.size() < 2 || !names::ParseFileId(dataName.at(1), fileNumber))
+    return;
+
+  uint32_t block = 0;
+  if (m_codeK > 0) {
+    if (dataName.size() < 3 || !dataName.at(2).isSequenceNumber())
+      return;
+    if (dataName.at(2).toSequenceNumber() >= GetBlockCount())
+      return;
+    block = dataName.at(2).toSequenceNumber();
+  }
+  else {
+    while (block < 2 && !PeerConsumer::GetProxyPrefix(block).isPrefixOf(dataName))
+      block++;
+  }
+
+  // nothing outside the range was requested, and its key would be some other block's
+  if (fileNumber < m_firstFile || fileNumber - m_firstFile >= m_files.size())
+    return;
+
+  AcknowledgeData(*data, GetBlockSeq(fileNumber, block), block % 3);
+
+  FileBlocks& file = m_files[fileNumber - m_firstFile];
+  if (file.read)
+    return;
+
+  Block contentBlock = data->getContent();
+  std::string content(reinterpret_cast<const char*>(contentBlock.value()), contentBlock.value_size());
+
+  std::string original;
+  if (m_codeK == 0) {
+    original = content;
+  }
+  else {
+    file.blocks[block] = content;
+    if (file.blocks.size() < m_codeK ||
+        !ErasureCode(m_codeK, GetBlockCount()).Decode(file.blocks, original))
+      return;
+  }
+
+  if (original.substr(0, 8) != "Original")
+    return;
+
+  NDN_APP_LOG_INFO("File " << fileNumber << " read from the proxies: " << original);
+  file.read = true;
+  file.blocks.clear();
+  m_filesRead++;
+  m_fileRead(this, fileNumber, Simulator::Now() - m_startTime);
+}
+
+///////////////////////////////////////////////////
+//          Snapshot                             //
+///////////////////////////////////////////////////
+
+void
+ProxyReader::SaveState(SnapshotWriter& writer) const
+{
+  SaveEngineState(writer);
+
+  writer.Put(static_cast<uint32_t>(m_files.size()));
+  for (const FileBlocks& file : m_files) {
+    writer.Put(file.read);
+    writer.Put(static_cast<uint32_t>(file.blocks.size()));
+    for (const auto& block : file.blocks) {
+      writer.Put(block.first);
+      writer.Put(block.second);
+    }
+  }
+  writer.Put(m_filesRead);
+  writer.Put(m_startTime);
+}
+
+void
+ProxyReader::LoadState(SnapshotReader& reader)
+{
+  LoadEngineState(reader);
+
+  uint32_t fileCount = 0;
+  reader.Get(fileCount);
+  m_files.assign(fileCount, FileBlocks{false, {}});
+  for (FileBlocks& file : m_files) {
+    uint32_t blockCount = 0;
+    reader.Get(file.read);
+    reader.Get(blockCount);
+    for (uint32_t i = 0; i < blockCount; i++) {
+      uint32_t block = 0;
+      reader.Get(block);
+      reader.Get(file.blocks[block]);
+    }
+  }
+  reader.Get(m_filesRead);
+  reader.Get(m_startTime);
+}
+
+} // namespace ndn
+} // namespace ns3
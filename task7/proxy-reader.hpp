@@ -0,0 +1,126 @@
+#ifndef NDN_PROXYREADER_H
+#define NDN_PROXYREADER_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "consumer-engine.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-apps
+ * \brief Reads the recovered files back from the proxies
+ *
+ * Requests every file of [FirstFile, LastFile] from the ProxyProducers until it has it. With
+ * CodeK = 0 a file was pushed whole to one random proxy, so /<proxy>/<file> is asked at all three
+ * proxy prefixes; otherwise the CodeN blocks /<proxy>/<file>/<block> are requested and the file
+ * is decoded as soon as CodeK of them arrived, whichever proxies the missing ones were lost with.
+ */
+class ProxyReader : public ConsumerEngine<ProxyReader>, public SnapshotState {
+public:
+  typedef void (*FileReadCallback)(Ptr<App> app, uint32_t file, Time delay);
+
+  static TypeId
+  GetTypeId();
+
+  ProxyReader();
+  virtual ~ProxyReader(){};
+
+  // From App
+  virtual void
+  OnData(shared_ptr<const Data> contentObject);
+
+  // From SnapshotState
+  virtual void
+  SaveState(SnapshotWriter& writer) const;
+
+  virtual void
+  LoadState(SnapshotReader& reader);
+
+  /**
+   * @brief Actually send packet
+   */
+  void
+  SendPacket();
+
+protected:
+  friend class ConsumerEngine<ProxyReader>;
+
+  virtual void
+  StartApplication();
+
+  /**
+   * \brief Scheduling policy: gap between two SendPacket calls
+   */
+  Time
+  GetSendInterval() const
+  {
+    return Seconds(0.5);
+  }
+
+  /**
+   * \brief Scheduling policy: stop once every file is read
+   */
+  bool
+  CanSend() const
+  {
+    return m_filesRead < m_files.size();
+  }
+
+  /// @cond include_hidden
+  struct FileBlocks {
+    bool read;
+    std::map<uint32_t, std::string> blocks; ///< block number -> block, kept until decoded
+  };
+  /// @endcond
+
+  uint32_t
+  GetBlockCount() const;
+
+  /**
+   * \brief Engine sequence number of a block of a file in the range: the file's index in the
+   * range times 256 plus the block
+   *
+   * Relative to FirstFile, so any file number fits; StartApplication() limits the range to 2^24
+   * files and CodeK/CodeN to 256 blocks.
+   */
+  uint32_t
+  GetBlockSeq(uint32_t fileNumber, uint32_t block) const
+  {
+    return (fileNumber - m_firstFile) * 256 + block;
+  }
+
+  void
+  SendBlockInterest(uint32_t fileNumber, uint32_t block);
+
+  /**
+   * \brief Whether @p block of @p fileNumber is still needed, i.e. the file is unread and the
+   * block missing
+   */
+  bool
+  IsMissing(uint32_t fileNumber, uint32_t block) const;
+
+protected:
+  uint32_t m_firstFile;
+  uint32_t m_lastFile;
+  uint32_t m_codeK; ///< \brief blocks needed to rebuild a file, 0 if files were pushed whole
+  uint32_t m_codeN; ///< \brief blocks pushed per file
+
+  std::vector<FileBlocks> m_files; ///< \brief file m_firstFile + i at index i
+  uint32_t m_filesRead;
+  Time m_startTime;
+
+  TracedCallback<Ptr<App> /* app */, uint32_t /* file */, Time /* delay */> m_fileRead;
+};
+
+extern template class ConsumerEngine<ProxyReader>;
+
+} // namespace ndn
+} // namespace ns3
+
+#endif
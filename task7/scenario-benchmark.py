@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+"""Wall-clock and event-throughput benchmark of the scenarios.
+
+  scenario-benchmark.py run --bin-dir ns-3/build/scratch --label new -o new.json
+  scenario-benchmark.py compare base.json new.json --threshold 5
+
+"run" executes every benchmark of the suite (or those given with --only) --repeat times and
+writes the median of each metric to a JSON file. The scenarios report their own cost through
+ndn::RunStats (ndn-run-stats.hpp): a "RunStats key=value ..." line on stderr (peer-memory-benchmark
+prints a "PeerMemory" line instead). The wall-clock time and peak RSS of the whole process are
+measured here as well.
+
+"compare" flags every metric of the second file that is worse than in the first by more than
+--threshold percent, and exits with status 1 if there is one.
+"""
+
+import argparse
+import json
+import os
+import platform
+import re
+import statistics
+import subprocess
+import sys
+import time
+
+# name -> (target, arguments); the generated variants scale the topologies up
+SUITE = {
+    "file-distribution": ("ndn-file-distribution", []),
+    "scenario": ("ndn-scenario", []),
+    "scenario-proxy": ("ndn-scenario-proxy", []),
+    "scenario-proxy-scaled": ("ndn-scenario-proxy-scaled", []),
+    "scenario-proxy-scaled-sync": ("ndn-scenario-proxy-scaled",
+                                   ["--svSync=true", "--rangeStride=5", "--readerStart=30",
+                                    "--codeK=2", "--codeN=3"]),
+    "epidemic-1k": ("ndn-scenario-epidemic", ["--nPeers=1000", "--fanout=2"]),
+    "epidemic-10k": ("ndn-scenario-epidemic", ["--nPeers=10000", "--fanout=2"]),
+    "engine-1k": ("consumer-engine-benchmark", ["--nConsumers=1000"]),
+    "app-install-100k-helper": ("app-install-benchmark", ["--nApps=100000", "--path=helper"]),
+    "app-install-100k-bulk": ("app-install-benchmark", ["--nApps=100000", "--path=bulk"]),
+    "peer-memory-1k": ("peer-memory-benchmark", ["--nPeers=1000"]),
+    "peer-memory-10k": ("peer-memory-benchmark", ["--nPeers=10000"]),
+    "peer-memory-100k": ("peer-memory-benchmark", ["--nPeers=100000"]),
+}
+
+# metric -> True if larger is better
+METRICS = {
+    "wall_s": False,
+    "events_per_s": True,
+    "packets_per_s": True,
+    "max_rss_kb": False,
+    "process_wall_s": False,
+    "process_max_rss_kb": False,
+    "bytes_per_peer": False,
+}
+
+# stderr lines of key=value fields: RunStats of the scenarios, PeerMemory of peer-memory-benchmark
+STATS_LINES = ("RunStats ", "PeerMemory ")
+
+
+def find_binary(bin_dir, target):
+    """Returns the executable of target: <target> itself or ns-3's ns3[.<ver>]-<target>-<profile>."""
+    pattern = re.compile(r"^(ns3[^-]*-(dev-)?)?" + re.escape(target) + r"(-(optimized|debug|default|release))?$")
+    for root, _, files in os.walk(bin_dir):
+        for name in sorted(files):
+            path = os.path.join(root, name)
+            if pattern.match(name) and os.access(path, os.X_OK):
+                return path
+    return None
+
+
+def run_once(binary, args, env):
+    start = time.monotonic()
+    process = subprocess.Popen([binary] + args, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE,
+                               env=env, universal_newlines=True)
+    stderr = process.stderr.read()
+    # wait4 instead of wait: the rusage of this child alone, not of all children so far
+    _, status, usage = os.wait4(process.pid, 0)
+    wall = time.monotonic() - start
+    if not os.WIFEXITED(status) or os.WEXITSTATUS(status) != 0:
+        sys.exit("%s %s failed (status %d):\n%s" % (binary, " ".join(args), status, stderr[-2000:]))
+
+    result = {"process_wall_s": wall, "process_max_rss_kb": usage.ru_maxrss}
+    for line in stderr.splitlines():
+        if line.startswith(STATS_LINES):
+            for field in line.split()[1:]:
+                key, _, value = field.partition("=")
+                result[key] = float(value)
+    return result
+
+
+def command_run(options):
+    names = options.only.split(",") if options.only else list(SUITE)
+    env = dict(os.environ)
+    if options.lib_dir:
+        env["LD_LIBRARY_PATH"] = os.pathsep.join(filter(None, [options.lib_dir, env.get("LD_LIBRARY_PATH")]))
+
+    results = {}
+    for name in names:
+        if name not in SUITE:
+            sys.exit("unknown benchmark %s, known: %s" % (name, ", ".join(SUITE)))
+        target, args = SUITE[name]
+        binary = find_binary(options.bin_dir, target)
+        if binary is None:
+            print("%-28s skipped, %s not built" % (name, target), file=sys.stderr)
+            continue
+
+        runs = [run_once(binary, args, env) for _ in range(options.repeat)]
+        median = {key: statistics.median(run[key] for run in runs if key in run)
+                  for key in sorted(set().union(*runs))}
+        results[name] = {"target": target, "args": args, "runs": runs, "median": median}
+        print("%-28s %8.2f s %12.0f events/s %10.0f packets/s %8d kB" %
+              (name, median.get("wall_s", median["process_wall_s"]), median.get("events_per_s", 0),
+               median.get("packets_per_s", 0), median.get("max_rss_kb", median["process_max_rss_kb"])))
+
+    report = {
+        "label": options.label,
+        "date": time.strftime("%Y-%m-%dT%H:%M:%S"),
+        "host": platform.node(),
+        "repeat": options.repeat,
+        "results": results,
+    }
+    with open(options.output, "w") as output:
+        json.dump(report, output, indent=2, sort_keys=True)
+
+
+def command_compare(options):
+    with open(options.base) as base_file, open(options.new) as new_file:
+        base = json.load(base_file)
+        new = json.load(new_file)
+
+    regressions = 0
+    print("%-28s %-20s %14s %14s %8s" % ("benchmark", "metric", base.get("label", "base"),
+                                        new.get("label", "new"), "change"))
+    for name in sorted(set(base["results"]) & set(new["results"])):
+        old_median = base["results"][name]["median"]
+        new_median = new["results"][name]["median"]
+        for metric, higher_is_better in METRICS.items():
+            if metric not in old_median or metric not in new_median or old_median[metric] == 0:
+                continue
+            change = (new_median[metric] - old_median[metric]) / old_median[metric] * 100
+            worse = -change if higher_is_better else change
+            flag = ""
+            if worse > options.threshold:
+                flag = "  REGRESSION"
+                regressions += 1
+            print("%-28s %-20s %14.6g %14.6g %+7.1f%%%s" %
+                  (name, metric, old_median[metric], new_median[metric], change, flag))
+
+    for name in sorted(set(base["results"]) ^ set(new["results"])):
+        print("%-28s only in %s" % (name, options.base if name in base["results"] else options.new))
+
+    if regressions:
+        print("%d regression(s) above %g%%" % (regressions, options.threshold))
+        sys.exit(1)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    commands = parser.add_subparsers(dest="command")
+    commands.required = True
+
+    run = commands.add_parser("run", help="run the suite and write a result file")
+    run.add_argument("--bin-dir", required=True, help="directory searched for the scenario executables")
+    run.add_argument("--lib-dir", help="ns-3 library directory, added to LD_LIBRARY_PATH")
+    run.add_argument("--label", default="", help="name of this build in the result file")
+    run.add_argument("--repeat", type=int, default=3, help="runs per benchmark, the median is kept")
+    run.add_argument("--only", help="comma separated benchmarks, all by default: " + ", ".join(SUITE))
+    run.add_argument("-o", "--output", default="benchmark.json", help="result file")
+    run.set_defaults(func=command_run)
+
+    compare = commands.add_parser("compare", help="flag regressions between two result files")
+    compare.add_argument("base")
+    compare.add_argument("new")
+    compare.add_argument("--threshold", type=float, default=5.0, help="percent a metric may get worse")
+    compare.set_defaults(func=command_compare)
+
+    options = parser.parse_args()
+    options.func(options)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,224 @@
+#!/usr/bin/env python3
+"""Parameter sweep of a scenario over a grid, with a content-addressed result cache.
+
+  scenario-sweep.py --bin-dir ns-3/build/scratch --target ndn-scenario-proxy-scaled \\
+      --param dataRate=1Mbps,10Mbps --param delay=10ms,50ms --param proxyCount=3,10 -o sweep.json
+  scenario-sweep.py --bin-dir ns-3/build/scratch --grid grid.json -j 8 -o sweep.json
+
+The grid is the cross product of the values of every --param (or of the "params" object of a
+--grid file, which may also give "target" and fixed "args"). Every point runs the scenario once
+with --<name>=<value> for each parameter, as many points at a time as --jobs (the local cores by
+default).
+
+A finished point is stored in --cache under the SHA-256 of the target, the fixed arguments, the
+sorted parameters and the build id. The build id is the hash of the scenario executable and of
+the libraries in --lib-dir (the apps live in the ndnSIM library), or --build-id if given. Points
+already in the cache are not run again, so re-running a sweep that was interrupted or extended
+only runs the new points, and a rebuild invalidates all of them. Failed points are not cached.
+
+Each result keeps the RunStats fields of stderr (see scenario-benchmark.py), the stdout of the
+scenario and, for the scaled scenario, its metrics summary (the metricsFile option). The output
+file lists every point of the grid with its result, cached or new.
+"""
+
+import argparse
+import concurrent.futures
+import hashlib
+import itertools
+import json
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import time
+
+# stderr lines of key=value fields: RunStats of the scenarios
+STATS_LINES = ("RunStats ",)
+
+# scenarios that write their metrics summary to the file of their metricsFile option
+METRICS_FILE_TARGETS = ("ndn-scenario-proxy-scaled",)
+
+
+def find_binary(bin_dir, target):
+    """Returns the absolute path of target: <target> itself or ns-3's ns3[.<ver>]-<target>-<profile>.
+
+    Absolute, because every point runs in a working directory of its own.
+    """
+    pattern = re.compile(r"^(ns3[^-]*-(dev-)?)?" + re.escape(target) + r"(-(optimized|debug|default|release))?$")
+    for root, _, files in os.walk(bin_dir):
+        for name in sorted(files):
+            path = os.path.join(root, name)
+            if pattern.match(name) and os.access(path, os.X_OK):
+                return os.path.abspath(path)
+    return None
+
+
+def hash_file(digest, path):
+    with open(path, "rb") as data:
+        for block in iter(lambda: data.read(1 << 20), b""):
+            digest.update(block)
+
+
+def build_id(binary, lib_dir):
+    """SHA-256 of the executable and of the shared libraries of lib_dir, in name order."""
+    digest = hashlib.sha256()
+    hash_file(digest, binary)
+    if lib_dir:
+        for name in sorted(os.listdir(lib_dir)):
+            path = os.path.join(lib_dir, name)
+            if ".so" in name and os.path.isfile(path):
+                digest.update(name.encode())
+                hash_file(digest, path)
+    return digest.hexdigest()
+
+
+def point_key(target, args, params, build):
+    description = {"target": target, "args": args, "params": params, "build": build}
+    return hashlib.sha256(json.dumps(description, sort_keys=True).encode()).hexdigest()
+
+
+def cache_path(cache_dir, key):
+    return os.path.join(cache_dir, key[:2], key + ".json")
+
+
+def load_cached(cache_dir, key):
+    try:
+        with open(cache_path(cache_dir, key)) as entry:
+            return json.load(entry)
+    except (OSError, ValueError):
+        return None
+
+
+def store_cached(cache_dir, key, entry):
+    path = cache_path(cache_dir, key)
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    # written aside and renamed, so an interrupted sweep leaves no partial entry
+    fd, temporary = tempfile.mkstemp(dir=os.path.dirname(path), suffix=".tmp")
+    with os.fdopen(fd, "w") as output:
+        json.dump(entry, output, indent=2, sort_keys=True)
+    os.replace(temporary, path)
+
+
+def run_point(binary, target, args, params, env):
+    """Runs one point, returns (result, None) or (None, error)."""
+    command = [binary] + args + ["--%s=%s" % (name, value) for name, value in sorted(params.items())]
+    with tempfile.TemporaryDirectory(prefix="sweep-") as work_dir:
+        metrics_file = os.path.join(work_dir, "metrics.txt")
+        if target in METRICS_FILE_TARGETS:
+            command.append("--metricsFile=" + metrics_file)
+
+        start = time.monotonic()
+        process = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.PIPE, env=env,
+                                 cwd=work_dir, universal_newlines=True)
+        wall = time.monotonic() - start
+        if process.returncode != 0:
+            return None, "status %d:\n%s" % (process.returncode, process.stderr[-2000:])
+
+        result = {"process_wall_s": wall, "stdout": process.stdout}
+        for line in process.stderr.splitlines():
+            if line.startswith(STATS_LINES):
+                for field in line.split()[1:]:
+                    key, _, value = field.partition("=")
+                    result[key] = float(value)
+        if os.path.exists(metrics_file):
+            with open(metrics_file) as metrics:
+                result["metrics"] = metrics.read()
+    return result, None
+
+
+def parse_grid(options):
+    target = options.target
+    args = list(options.arg)
+    grid = {}
+    if options.grid:
+        with open(options.grid) as grid_file:
+            spec = json.load(grid_file)
+        target = target or spec.get("target")
+        args = spec.get("args", []) + args
+        grid.update((name, [str(value) for value in values]) for name, values in spec["params"].items())
+    for param in options.param:
+        name, _, values = param.partition("=")
+        if not name or not values:
+            sys.exit("--param %s is not <name>=<value>[,<value>...]" % param)
+        grid[name] = values.split(",")
+    if not target:
+        sys.exit("no --target and no \"target\" in the grid file")
+    return target, args, grid
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--bin-dir", required=True, help="directory searched for the scenario executable")
+    parser.add_argument("--lib-dir", help="ns-3 library directory, added to LD_LIBRARY_PATH and to the build id")
+    parser.add_argument("--target", help="scenario to sweep, e.g. ndn-scenario-proxy-scaled")
+    parser.add_argument("--grid", help="JSON file {\"target\": ..., \"args\": [...], \"params\": {name: [values]}}")
+    parser.add_argument("--param", action="append", default=[], help="<name>=<value>,<value>...: one grid axis")
+    parser.add_argument("--arg", action="append", default=[], help="fixed argument of every run, e.g. --arg=--svSync=true")
+    parser.add_argument("--cache", default="sweep-cache", help="directory of the result cache")
+    parser.add_argument("--build-id", help="build id of the cache keys instead of the hash of the executable")
+    parser.add_argument("-j", "--jobs", type=int, default=os.cpu_count(), help="points run at a time")
+    parser.add_argument("-o", "--output", default="sweep.json", help="result file")
+    options = parser.parse_args()
+
+    target, args, grid = parse_grid(options)
+    binary = find_binary(options.bin_dir, target)
+    if binary is None:
+        sys.exit("%s is not built in %s" % (target, options.bin_dir))
+    env = dict(os.environ)
+    if options.lib_dir:
+        env["LD_LIBRARY_PATH"] = os.pathsep.join(filter(None, [os.path.abspath(options.lib_dir),
+                                                               env.get("LD_LIBRARY_PATH")]))
+    build = options.build_id or build_id(binary, options.lib_dir)
+
+    names = sorted(grid)
+    points = [dict(zip(names, values)) for values in itertools.product(*(grid[name] for name in names))]
+    keys = [point_key(target, args, params, build) for params in points]
+
+    results = {}
+    pending = []
+    for params, key in zip(points, keys):
+        cached = load_cached(options.cache, key)
+        if cached is not None:
+            results[key] = cached
+        else:
+            pending.append((params, key))
+    print("%d points, %d cached, %d to run on %d jobs" % (len(points), len(results), len(pending), options.jobs),
+          file=sys.stderr)
+
+    failures = 0
+    # the points are processes of their own, threads only wait for them
+    with concurrent.futures.ThreadPoolExecutor(max_workers=max(1, options.jobs)) as executor:
+        running = {executor.submit(run_point, binary, target, args, params, env): (params, key)
+                   for params, key in pending}
+        for future in concurrent.futures.as_completed(running):
+            params, key = running[future]
+            label = " ".join("%s=%s" % item for item in sorted(params.items()))
+            result, error = future.result()
+            if error is not None:
+                print("%s failed, %s" % (label, error), file=sys.stderr)
+                failures += 1
+                continue
+            entry = {"target": target, "args": args, "params": params, "build": build, "result": result}
+            store_cached(options.cache, key, entry)
+            results[key] = entry
+            print("%s done in %.1f s" % (label, result["process_wall_s"]), file=sys.stderr)
+
+    report = {
+        "target": target,
+        "args": args,
+        "build": build,
+        "date": time.strftime("%Y-%m-%dT%H:%M:%S"),
+        "points": [{"params": params, "key": key, "result": results[key]["result"] if key in results else None}
+                   for params, key in zip(points, keys)],
+    }
+    with open(options.output, "w") as output:
+        json.dump(report, output, indent=2, sort_keys=True)
+
+    if failures:
+        print("%d point(s) failed" % failures, file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()